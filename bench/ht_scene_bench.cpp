@@ -0,0 +1,79 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* Command line driver for SceneBenchmark.
+*
+* Usage: ht_scene_bench [--objects N] [--depth N] [--components N] [--prefabs N] [--names N] [--seed N] [--runs N]
+*
+* Build together with ht_scene_benchmark.cpp, with this directory on the include path, and link
+* against HatchitGame and HatchitCore. No window, renderer or audio device is needed.
+*/
+
+#include <ht_scene_benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using Hatchit::Game::SceneBenchmark;
+using Hatchit::Game::SceneBenchmarkConfig;
+using Hatchit::Game::SceneBenchmarkResult;
+
+int main(int argc, char* argv[])
+{
+    SceneBenchmarkConfig config;
+    unsigned long runs = 3;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        unsigned long value = std::strtoul(argv[i + 1], nullptr, 10);
+
+        if (std::strcmp(argv[i], "--objects") == 0)
+            config.objectCount = static_cast<uint32_t>(value);
+        else if (std::strcmp(argv[i], "--depth") == 0)
+            config.maxDepth = static_cast<uint32_t>(value);
+        else if (std::strcmp(argv[i], "--components") == 0)
+            config.componentsPerObject = static_cast<uint32_t>(value);
+        else if (std::strcmp(argv[i], "--prefabs") == 0)
+            config.prefabCount = static_cast<uint32_t>(value);
+        else if (std::strcmp(argv[i], "--names") == 0)
+            config.uniqueNames = static_cast<uint32_t>(value);
+        else if (std::strcmp(argv[i], "--seed") == 0)
+            config.seed = static_cast<uint32_t>(value);
+        else if (std::strcmp(argv[i], "--runs") == 0)
+            runs = value;
+        else
+        {
+            std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    for (unsigned long run = 0; run < runs; run++)
+    {
+        std::printf("\nRun %lu of %lu\n", run + 1, runs);
+
+        SceneBenchmarkResult result;
+        if (!SceneBenchmark::Run(config, result))
+        {
+            std::fprintf(stderr, "The generated scene failed to load.\n");
+            return 1;
+        }
+
+        SceneBenchmark::Print(result);
+    }
+
+    return 0;
+}
@@ -0,0 +1,393 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_scene_benchmark.h>
+#include <ht_scene.h>
+#include <ht_gameobject.h>
+#include <ht_component_registry.h>
+#include <ht_jsonhelper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#if defined(HT_SYS_WINDOWS)
+    #include <windows.h>
+    #include <psapi.h>
+    #ifdef _MSC_VER
+        #pragma comment(lib, "psapi.lib")
+    #endif
+#elif defined(HT_SYS_LINUX)
+    #include <sys/resource.h>
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+
+            /**
+            * \brief Stands in for MeshRenderer without touching the renderer.
+            *
+            * Reads the same properties and copies its owner's world matrix each update,
+            * in place of filling a per-instance constant buffer.
+            */
+            class HeadlessMeshRenderer : public Component
+            {
+            public:
+                Core::JSON VSerialize(void) override
+                {
+                    Core::JSON json = Core::JSON::object();
+                    json["Mesh"] = m_mesh;
+                    json["Material"] = m_material;
+                    return json;
+                }
+
+                bool VDeserialize(const Core::JSON& jsonObject) override
+                {
+                    return Core::JsonExtract<std::string>(jsonObject, "Material", m_material)
+                        && Core::JsonExtract<std::string>(jsonObject, "Mesh", m_mesh);
+                }
+
+                void VOnInit(void) override {}
+                void VOnUpdate(void) override { m_world = *m_owner->GetTransform().GetWorldMatrix(); }
+                void VOnDestroy(void) override {}
+                Component* VClone(void) const override { return new HeadlessMeshRenderer(*this); }
+                Core::Guid VGetComponentId(void) const override { return Component::GetComponentId<HeadlessMeshRenderer>(); }
+                ComponentTypeId VGetComponentTypeId(void) const override { return Component::GetComponentTypeId<HeadlessMeshRenderer>(); }
+
+            protected:
+                void VOnEnabled(void) override {}
+                void VOnDisabled(void) override {}
+
+            private:
+                std::string m_mesh;
+                std::string m_material;
+                Math::Matrix4 m_world;
+            };
+
+            /**
+            * \brief Stands in for AudioSource without opening an audio device.
+            */
+            class HeadlessAudioSource : public Component
+            {
+            public:
+                Core::JSON VSerialize(void) override
+                {
+                    Core::JSON json = Core::JSON::object();
+                    json["Audio"] = m_audio;
+                    return json;
+                }
+
+                bool VDeserialize(const Core::JSON& jsonObject) override
+                {
+                    return Core::JsonExtract<std::string>(jsonObject, "Audio", m_audio);
+                }
+
+                void VOnInit(void) override {}
+                void VOnUpdate(void) override { m_position = m_owner->GetTransform().GetWorldPosition(); }
+                void VOnDestroy(void) override {}
+                Component* VClone(void) const override { return new HeadlessAudioSource(*this); }
+                Core::Guid VGetComponentId(void) const override { return Component::GetComponentId<HeadlessAudioSource>(); }
+                ComponentTypeId VGetComponentTypeId(void) const override { return Component::GetComponentTypeId<HeadlessAudioSource>(); }
+
+            protected:
+                void VOnEnabled(void) override {}
+                void VOnDisabled(void) override {}
+
+            private:
+                std::string m_audio;
+                Math::Vector3 m_position;
+            };
+
+            /**
+            * \brief A minimal gameplay Component that only counts its updates.
+            */
+            class HeadlessBehaviour : public Component
+            {
+            public:
+                Core::JSON VSerialize(void) override { return Core::JSON::object(); }
+                bool VDeserialize(const Core::JSON& jsonObject) override { return true; }
+
+                void VOnInit(void) override { m_updates = 0; }
+                void VOnUpdate(void) override { m_updates++; }
+                void VOnDestroy(void) override {}
+                Component* VClone(void) const override { return new HeadlessBehaviour(*this); }
+                Core::Guid VGetComponentId(void) const override { return Component::GetComponentId<HeadlessBehaviour>(); }
+                ComponentTypeId VGetComponentTypeId(void) const override { return Component::GetComponentTypeId<HeadlessBehaviour>(); }
+
+            protected:
+                void VOnEnabled(void) override {}
+                void VOnDisabled(void) override {}
+
+            private:
+                uint32_t m_updates{ 0 };
+            };
+
+            HT_REGISTER_COMPONENT(HeadlessMeshRenderer);
+            HT_REGISTER_COMPONENT(HeadlessAudioSource);
+            HT_REGISTER_COMPONENT_WITH_FLAGS(HeadlessBehaviour, ComponentRegistry::TRIVIAL_TEARDOWN);
+
+            typedef std::chrono::high_resolution_clock Clock;
+
+            /**
+            * \brief Records the time since start for a phase and restarts the clock.
+            */
+            void EndPhase(SceneBenchmarkResult& result, SceneBenchmarkResult::Phase phase, Clock::time_point& start)
+            {
+                Clock::time_point end = Clock::now();
+                result.milliseconds[phase] = std::chrono::duration<double, std::milli>(end - start).count();
+                result.peakMemory[phase] = SceneBenchmark::PeakMemory();
+                start = Clock::now();
+            }
+
+            Core::JSON MakeTransform(std::mt19937& rng)
+            {
+                std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+                std::uniform_real_distribution<float> rotation(0.0f, 360.0f);
+
+                Core::JSON transform = Core::JSON::object();
+                transform["Position"] = { position(rng), position(rng), position(rng) };
+                transform["Rotation"] = { rotation(rng), rotation(rng), rotation(rng) };
+                transform["Scale"] = { 1.0f, 1.0f, 1.0f };
+                return transform;
+            }
+
+            Core::JSON MakeComponent(const std::string& type, std::mt19937& rng)
+            {
+                // Draw asset names from a small pool so they repeat the way they do in real scenes.
+                std::uniform_int_distribution<uint32_t> asset(0, 31);
+
+                Core::JSON component = Core::JSON::object();
+                component["Type"] = type;
+                if (type == "HeadlessMeshRenderer" || type == "MeshRenderer")
+                {
+                    uint32_t index = asset(rng);
+                    component["Mesh"] = "Mesh" + std::to_string(index) + ".dae";
+                    component["Material"] = "Material" + std::to_string(index) + ".json";
+                }
+                else if (type == "HeadlessAudioSource" || type == "AudioSource")
+                {
+                    component["Audio"] = "Clip" + std::to_string(asset(rng)) + ".ogg";
+                }
+                return component;
+            }
+
+            /**
+            * \brief Builds the Components of one GameObject, picking distinct types by weight.
+            */
+            Core::JSON MakeComponents(const SceneBenchmarkConfig& config, const std::vector<std::pair<std::string, uint32_t>>& mix, std::mt19937& rng)
+            {
+                std::vector<uint32_t> weights;
+                weights.reserve(mix.size());
+                for (const std::pair<std::string, uint32_t>& type : mix)
+                    weights.push_back(type.second);
+
+                Core::JSON components = Core::JSON::array();
+                for (uint32_t i = 0; i < config.componentsPerObject; i++)
+                {
+                    uint32_t total = 0;
+                    for (uint32_t weight : weights)
+                        total += weight;
+                    if (total == 0)
+                        break;
+
+                    // A GameObject holds at most one Component of each type, so a picked type is not picked again.
+                    uint32_t pick = std::uniform_int_distribution<uint32_t>(0, total - 1)(rng);
+                    std::size_t type = 0;
+                    while (pick >= weights[type])
+                        pick -= weights[type++];
+
+                    components.push_back(MakeComponent(mix[type].first, rng));
+                    weights[type] = 0;
+                }
+                return components;
+            }
+        }
+
+        std::string SceneBenchmark::GenerateScene(const SceneBenchmarkConfig& config)
+        {
+            std::mt19937 rng(config.seed);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+            std::vector<std::pair<std::string, uint32_t>> mix = config.componentMix;
+            if (mix.empty())
+            {
+                mix.push_back(std::make_pair(std::string("HeadlessMeshRenderer"), 6u));
+                mix.push_back(std::make_pair(std::string("HeadlessBehaviour"), 3u));
+                mix.push_back(std::make_pair(std::string("HeadlessAudioSource"), 1u));
+            }
+
+            const uint32_t uniqueNames = std::max<uint32_t>(config.uniqueNames, 1);
+            const uint32_t maxDepth = std::max<uint32_t>(config.maxDepth, 1);
+
+            std::vector<std::string> guids;
+            guids.reserve(config.objectCount + config.prefabCount);
+            for (uint32_t i = 0; i < config.objectCount + config.prefabCount; i++)
+                guids.push_back(Core::Guid().ToString());
+
+            Core::JSON scene = Core::JSON::object();
+            scene["Name"] = "Benchmark";
+            scene["GUID"] = Core::Guid().ToString();
+            scene["GUIDs"] = guids;
+
+            // Each GameObject is either placed at the top level or parented to a random earlier
+            // GameObject that is not yet at the maximum depth.
+            std::vector<uint32_t> depth(config.objectCount, 0);
+            Core::JSON gameObjects = Core::JSON::array();
+            for (uint32_t i = 0; i < config.objectCount; i++)
+            {
+                Core::JSON gameObject = Core::JSON::object();
+                gameObject["GUID"] = guids[i];
+                gameObject["Name"] = "Object" + std::to_string(i % uniqueNames);
+                gameObject["Enabled"] = true;
+
+                if (i > 0 && unit(rng) >= config.rootFraction)
+                {
+                    uint32_t parent = std::uniform_int_distribution<uint32_t>(0, i - 1)(rng);
+                    if (depth[parent] + 1 < maxDepth)
+                    {
+                        gameObject["Parent"] = guids[parent];
+                        depth[i] = depth[parent] + 1;
+                    }
+                }
+
+                gameObject["Transform"] = MakeTransform(rng);
+                gameObject["Components"] = MakeComponents(config, mix, rng);
+                gameObjects.push_back(std::move(gameObject));
+            }
+            scene["GameObjects"] = std::move(gameObjects);
+
+            Core::JSON prefabs = Core::JSON::array();
+            for (uint32_t i = 0; i < config.prefabCount; i++)
+            {
+                Core::JSON prefab = Core::JSON::object();
+                prefab["GUID"] = guids[config.objectCount + i];
+                prefab["Name"] = "Prefab" + std::to_string(i);
+                prefab["Transform"] = MakeTransform(rng);
+                prefab["Components"] = MakeComponents(config, mix, rng);
+                prefabs.push_back(std::move(prefab));
+            }
+            scene["Prefabs"] = std::move(prefabs);
+
+            return scene.dump();
+        }
+
+        bool SceneBenchmark::Run(const SceneBenchmarkConfig& config, SceneBenchmarkResult& result)
+        {
+            result = SceneBenchmarkResult{};
+
+            const std::string text = GenerateScene(config);
+            result.sceneBytes = text.size();
+
+            // Components reach their Scene through Scene::instance, so the benchmark scene stands in for the current one.
+            Scene* previous = Scene::instance;
+            Scene* scene = new Scene();
+            Scene::instance = scene;
+
+            Clock::time_point start = Clock::now();
+
+            Core::JSON description = Core::JSON::parse(text);
+            EndPhase(result, SceneBenchmarkResult::PARSE, start);
+
+            std::vector<const Core::JSON*> id_to_json;
+            bool loaded = scene->InstantiateGameObjects(description, id_to_json)
+                && scene->ParsePrefabs(description, id_to_json);
+            EndPhase(result, SceneBenchmarkResult::INSTANTIATE, start);
+
+            if (loaded)
+            {
+                scene->LinkGameObjects(id_to_json);
+                EndPhase(result, SceneBenchmarkResult::LINK, start);
+
+                for (GameObject* gameObject : scene->m_objectsById)
+                {
+                    if (gameObject == nullptr)
+                        continue;
+
+                    result.objectCount++;
+                    result.componentCount += gameObject->m_components.size();
+                }
+                start = Clock::now();
+
+                scene->Init();
+                EndPhase(result, SceneBenchmarkResult::INIT, start);
+
+                scene->Update();
+                EndPhase(result, SceneBenchmarkResult::FIRST_UPDATE, start);
+            }
+
+            scene->Unload();
+            EndPhase(result, SceneBenchmarkResult::UNLOAD, start);
+
+            delete scene;
+            Scene::instance = previous;
+
+            return loaded;
+        }
+
+        void SceneBenchmark::Print(const SceneBenchmarkResult& result)
+        {
+            std::printf("Scene: %zu GameObjects, %zu Components, %.1f KiB of JSON\n",
+                result.objectCount, result.componentCount, result.sceneBytes / 1024.0);
+            std::printf("%-14s %12s %16s %14s\n", "Phase", "Time (ms)", "Objects/s", "Peak (MiB)");
+
+            double total = 0.0;
+            for (int i = 0; i < SceneBenchmarkResult::PHASE_COUNT; i++)
+            {
+                SceneBenchmarkResult::Phase phase = static_cast<SceneBenchmarkResult::Phase>(i);
+                double milliseconds = result.milliseconds[phase];
+                double throughput = (milliseconds > 0.0) ? result.objectCount / (milliseconds / 1000.0) : 0.0;
+                total += milliseconds;
+
+                std::printf("%-14s %12.3f %16.0f %14.1f\n", PhaseName(phase), milliseconds, throughput,
+                    result.peakMemory[phase] / (1024.0 * 1024.0));
+            }
+            std::printf("%-14s %12.3f\n", "Total", total);
+        }
+
+        std::size_t SceneBenchmark::PeakMemory(void)
+        {
+#if defined(HT_SYS_WINDOWS)
+            PROCESS_MEMORY_COUNTERS counters;
+            if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+                return counters.PeakWorkingSetSize;
+            return 0;
+#elif defined(HT_SYS_LINUX)
+            struct rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) == 0)
+                return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // ru_maxrss is in KiB on Linux.
+            return 0;
+#else
+            return 0;
+#endif
+        }
+
+        const char* SceneBenchmark::PhaseName(SceneBenchmarkResult::Phase phase)
+        {
+            switch (phase)
+            {
+                case SceneBenchmarkResult::PARSE:           return "Parse";
+                case SceneBenchmarkResult::INSTANTIATE:     return "Instantiate";
+                case SceneBenchmarkResult::LINK:            return "Link";
+                case SceneBenchmarkResult::INIT:            return "Init";
+                case SceneBenchmarkResult::FIRST_UPDATE:    return "First update";
+                case SceneBenchmarkResult::UNLOAD:          return "Unload";
+                default:                                    return "";
+            }
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class SceneBenchmark
+* \ingroup HatchitGame
+*
+* \brief Generates large synthetic scenes and times each phase of loading them.
+*
+* The generated scenes use headless stand-ins for render and audio Components, so a run needs
+* neither a window, a renderer nor an audio device. The stand-ins are registered by the benchmark
+* itself, which is built into the benchmark executable only and never into the engine, so they
+* do not exist in the ComponentRegistry of a game. Results are reported per phase together with
+* the process' peak memory.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        /**
+        * \brief Describes the shape of a generated scene.
+        */
+        struct SceneBenchmarkConfig
+        {
+            uint32_t objectCount{ 10000 };          /**< Number of GameObjects in the scene. */
+            uint32_t maxDepth{ 4 };                 /**< Maximum depth of the GameObject hierarchy, 1 for a flat scene. */
+            float    rootFraction{ 0.1f };          /**< Chance a GameObject is placed at the top level. */
+            uint32_t componentsPerObject{ 2 };      /**< Number of Components on each GameObject. */
+            uint32_t prefabCount{ 16 };             /**< Number of Prefabs in the scene. */
+            uint32_t uniqueNames{ 256 };            /**< Number of distinct GameObject names. */
+            uint32_t seed{ 1 };                     /**< Seed for the generator, equal seeds give scenes of equal shape. */
+
+            /**
+            * Component type names and their relative weights. Left empty, a mix of the headless
+            * stand-ins for MeshRenderer, AudioSource and a plain behaviour is used.
+            */
+            std::vector<std::pair<std::string, uint32_t>> componentMix;
+        };
+
+        /**
+        * \brief Timings of a single benchmark run.
+        */
+        struct SceneBenchmarkResult
+        {
+            enum Phase
+            {
+                PARSE,          /**< Parsing the scene text into JSON. */
+                INSTANTIATE,    /**< Constructing GameObjects, Prefabs and Components. */
+                LINK,           /**< Establishing the GameObject hierarchy. */
+                INIT,           /**< Scene::Init. */
+                FIRST_UPDATE,   /**< The first Scene::Update. */
+                UNLOAD,         /**< Scene::Unload. */
+                PHASE_COUNT
+            };
+
+            double      milliseconds[PHASE_COUNT];  /**< Wall-clock time of each phase. */
+            std::size_t peakMemory[PHASE_COUNT];    /**< Peak resident memory of the process after each phase, in bytes. */
+            std::size_t sceneBytes;                 /**< Size of the generated scene text. */
+            std::size_t objectCount;                /**< GameObjects constructed. */
+            std::size_t componentCount;             /**< Components constructed. */
+        };
+
+        class SceneBenchmark
+        {
+        public:
+            /**
+            * \brief Generates the text of a scene description.
+            * \param config The shape of the scene.
+            * \return The scene, in the same JSON format scene files use.
+            */
+            static std::string GenerateScene(const SceneBenchmarkConfig& config);
+
+            /**
+            * \brief Generates a scene, loads it into a fresh Scene and times each phase.
+            * \param config The shape of the scene.
+            * \param result Receives the timings.
+            * \return false if the generated scene failed to load.
+            */
+            static bool Run(const SceneBenchmarkConfig& config, SceneBenchmarkResult& result);
+
+            /**
+            * \brief Prints a result as a table to stdout.
+            */
+            static void Print(const SceneBenchmarkResult& result);
+
+            /**
+            * \brief Returns the peak resident memory of the process, in bytes, or 0 if unknown.
+            */
+            static std::size_t PeakMemory(void);
+
+            /**
+            * \brief Returns the display name of a phase.
+            */
+            static const char* PhaseName(SceneBenchmarkResult::Phase phase);
+        };
+    }
+}
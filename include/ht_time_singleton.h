@@ -43,10 +43,31 @@ namespace Hatchit {
 
             static float PausedTime();
 
+            /**
+            * \brief Replaces the clock seen by DeltaTime() and TotalTime() until ClearSimulationTime() is called.
+            *
+            * Used to re-simulate past frames at the times they originally ran at, so the results are identical.
+            * \sa SceneRollback
+            */
+            static void SetSimulationTime(float totalTime, float deltaTime);
+
+            /**
+            * \brief Returns DeltaTime() and TotalTime() to the real clock.
+            */
+            static void ClearSimulationTime();
+
+            /**
+            * \brief Returns true while SetSimulationTime() is in effect.
+            */
+            static bool HasSimulationTime();
+
         private:
             Core::Timer* m_timer;
             float        m_fps;
             float        m_mspf;
+            bool         m_simulated;
+            float        m_simulatedTotalTime;
+            float        m_simulatedDeltaTime;
         };
 
     }
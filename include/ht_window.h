@@ -18,6 +18,8 @@
 #include <ht_noncopy.h>
 #include <ht_string.h>
 
+#include <cstdint>
+
 namespace Hatchit {
 
     namespace Game {
@@ -35,6 +37,8 @@ namespace Hatchit {
             bool displayFPS;
             bool displayMouse;
             bool debugWindowEvents;
+            bool headless;          /**< Open a NullWindow instead of a window on screen. */
+            uint32_t frameLimit;    /**< Frames a headless window runs for, 0 to run until closed. */
         };
 
         class HT_API IWindow : Core::INonCopy
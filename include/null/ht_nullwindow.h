@@ -0,0 +1,68 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class NullWindow
+* \ingroup HatchitGame
+*
+* \brief A window that opens nothing on screen, for servers and benchmark runs.
+*
+* It has no native handles and receives no input. It keeps running until closed,
+* or until it has presented WindowParams::frameLimit frames.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_window.h>
+
+#include <cstdint>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class HT_API NullWindow : public IWindow
+        {
+        public:
+            NullWindow(const WindowParams& params);
+
+            ~NullWindow();
+
+            bool    VInitialize()             override;
+
+            void*   VNativeWindowHandle()     override;
+
+            void*   VNativeDisplayHandle()    override;
+
+            bool    VIsRunning()              override;
+
+            void    VPollEvents()             override;
+
+            void    VClose()                  override;
+
+            void    VSwapBuffers()            override;
+
+            /**
+            * \brief Gets the number of frames presented so far.
+            */
+            uint64_t GetFrameCount() const;
+
+        private:
+            uint64_t            m_frames;
+        };
+
+    }
+
+}
@@ -0,0 +1,100 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class AssetPrefetcher
+* \ingroup HatchitGame
+*
+* \brief Loads every asset referenced by a scene description before its Components are built.
+*
+* The prefetcher walks the Components of a scene description and asks each registered
+* Component type which meshes, materials and audio files it references. The resulting
+* set is deduplicated and its files are read concurrently, while the calling thread creates
+* the handles one by one as the files arrive. The Components that later request the same
+* files find them already resident in the resource caches.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_jsonhelper.h>
+#include <ht_meshrenderer.h>
+#include <ht_audio_resource.h>
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class HT_API AssetPrefetcher
+        {
+        public:
+            AssetPrefetcher(void) = default;
+            ~AssetPrefetcher(void) = default;
+
+            /**
+            * \brief Queues a mesh file to be loaded.
+            */
+            void AddMesh(const std::string& fileName);
+
+            /**
+            * \brief Queues a material file to be loaded.
+            */
+            void AddMaterial(const std::string& fileName);
+
+            /**
+            * \brief Queues an audio file to be loaded.
+            */
+            void AddAudio(const std::string& fileName);
+
+            /**
+            * \brief Queues every asset referenced by the GameObjects and Prefabs of a scene description.
+            * \param sceneDescription   The JSON representation of a Scene.
+            */
+            void Gather(const Core::JSON& sceneDescription);
+
+            /**
+            * \brief Loads every queued asset and blocks until all of them are resident.
+            * \param workerCount    The number of threads to read files on, 0 to use one per hardware thread.
+            *
+            * Only file reads happen on the worker threads; every handle is created on the calling
+            * thread, which also reads when it is waiting. Handles to the loaded assets are held
+            * until Release() is called.
+            */
+            void Load(std::size_t workerCount = 0);
+
+            /**
+            * \brief Drops the handles held to every prefetched asset.
+            */
+            void Release(void);
+
+        private:
+            /**
+            * \brief Queues every asset referenced by a list of JSON GameObjects.
+            */
+            void GatherGameObjects(const Core::JSON& gameObjects);
+
+            std::unordered_set<std::string> m_meshFiles;     /**< Unique mesh files to load. */
+            std::unordered_set<std::string> m_materialFiles; /**< Unique material files to load. */
+            std::unordered_set<std::string> m_audioFiles;    /**< Unique audio files to load. */
+
+            std::vector<Graphics::MeshHandle>            m_meshes;    /**< Handles kept alive until Release(). */
+            std::vector<Graphics::MaterialHandle>        m_materials; /**< Handles kept alive until Release(). */
+            std::vector<Resource::AudioResourceHandle>   m_audio;     /**< Handles kept alive until Release(). */
+        };
+    }
+}
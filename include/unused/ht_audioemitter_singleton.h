@@ -19,19 +19,59 @@
 #include <ht_renderer.h>
 #include <ht_audiodevice.h>
 
+#include <cstdint>
+
 namespace Hatchit
 {
     namespace Game
     {
+        /**
+        * \brief Counts of what was submitted for playback, kept whether or not audio is headless.
+        */
+        struct AudioStats
+        {
+            uint64_t plays;         /**< Sources started. */
+            uint64_t buffersQueued; /**< Buffers queued on sources. */
+        };
+
         class HT_API AudioEmitter : public Core::Singleton<AudioEmitter>
         {
         public:
-            static bool Initialize();
+            /**
+            * \brief Opens the audio device.
+            * \param headless   Open no device, for servers and benchmark runs. AudioSources only count what they would play.
+            */
+            static bool Initialize(bool headless = false);
             static void DeInitialize();
 
             static void Update();
+
+            /**
+            * \brief Returns true if no audio device was opened.
+            */
+            static bool IsHeadless();
+
+            /**
+            * \brief Counts a source starting to play bufferCount queued buffers.
+            */
+            static void CountPlay(uint32_t bufferCount);
+
+            /**
+            * \brief Counts bufferCount buffers queued on a playing source.
+            */
+            static void CountBuffersQueued(uint32_t bufferCount);
+
+            /**
+            * \brief Gets the submissions counted since initialization or the last ResetStats().
+            */
+            static const AudioStats& GetStats();
+
+            static void ResetStats();
         private:
             Audio::Device m_device;
+            bool m_headless;
+            bool m_deviceOpen;
+            AudioStats m_stats;
         };
     }
 }
\ No newline at end of file
@@ -36,6 +36,7 @@ namespace Hatchit
             virtual Component* VClone() const override;
 
             virtual Core::Guid VGetComponentId() const override;
+            virtual ComponentTypeId VGetComponentTypeId() const override;
         protected:
             virtual void VOnEnabled() override;
 
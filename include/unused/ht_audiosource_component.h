@@ -15,11 +15,13 @@
 #pragma once
 
 #include <ht_component.h> //Component
+#include <ht_reflection.h> //HT_REFLECTED
 #include <ht_jsonhelper.h> //Core::JSON
 #include <ht_audio_resource.h> //AudioHandle
 #include <ht_audiosource.h> //Audio::Source
 #include <ht_audiobuffer.h> //Audio::Buffer
 #include <array> //std::array
+#include <string> //std::string
 
 struct stb_vorbis;
 
@@ -35,10 +37,19 @@ namespace Hatchit
 {
     namespace Game
     {
+        class AssetPrefetcher;
+
         class AudioSource : public Component
         {
         public:
+            HT_REFLECTED();
+
             AudioSource();
+
+            /**
+            * \brief Copies the audio file of an AudioSource, but none of its playback.
+            * The copy opens its own stream when it is initialized.
+            */
             AudioSource(const AudioSource& source);
             AudioSource(AudioSource&& source);
 
@@ -54,8 +65,34 @@ namespace Hatchit
             virtual Component* VClone() const override;
 
             virtual Core::Guid VGetComponentId(void) const override;
+            virtual ComponentTypeId VGetComponentTypeId(void) const override;
+            virtual const TypeDescriptor* VGetTypeDescriptor(void) const override;
+
+            /**
+            * \brief Writes the audio file along with whether it is playing and how far into it.
+            */
+            virtual void VWriteBinary(std::vector<uint8_t>& out) const override;
 
-            void PlayAudio(Resource::AudioResourceHandle handle);
+            /**
+            * \brief Restores the audio file and resumes playback where it was when written.
+            *
+            * Buffers already queued with the audio device finish playing first, so the restored
+            * position is reached within one queue's worth of audio.
+            */
+            virtual bool VReadBinary(const uint8_t*& cursor, const uint8_t* end) override;
+
+            /**
+            * \brief Starts streaming an audio resource.
+            * \param handle        The audio to play.
+            * \param startSample   The sample, per channel, to start playing from.
+            */
+            void PlayAudio(Resource::AudioResourceHandle handle, uint32_t startSample = 0);
+
+            /**
+            * \brief Reports the audio file referenced by an AudioSource description.
+            * \sa AssetPrefetcher
+            */
+            static void GatherAssets(const Core::JSON& jsonObject, AssetPrefetcher& prefetcher);
         protected:
 
             virtual void VOnEnabled() override;
@@ -64,6 +101,9 @@ namespace Hatchit
 
         private:
             static constexpr size_t numBuffers = 16;
+            static const char* DefaultAudioFile;
+
+            std::string m_audioFile;
 
             Resource::AudioResourceHandle m_currentAudioHandle;
             bool m_playing;
@@ -71,6 +111,7 @@ namespace Hatchit
             Audio::Source m_source;
             std::array<Audio::Buffer, numBuffers> m_bufferList;
             size_t m_nextBufferIndex;
+            uint32_t m_samplesPlayed; /**< Samples per channel handed back by the audio device since the start of the stream. */
 
             void SetupBuffer(Audio::Buffer& audioBuffer);
             bool SetupAudioStream();
@@ -50,7 +50,13 @@ namespace Hatchit {
             */
             Component* VClone(void) const override;
 
+            /**
+            * \brief Gets the distance to the far clipping plane.
+            */
+            float GetFarPlane(void) const;
+
             virtual Core::Guid VGetComponentId(void) const override;
+            virtual ComponentTypeId VGetComponentTypeId(void) const override;
         protected:
 
             /**
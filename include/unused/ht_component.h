@@ -26,6 +26,7 @@
 
 #include <cstdint>
 #include <type_traits>
+#include <vector>
 #include <ht_transform.h>
 #include <ht_guid.h>
 #include <ht_jsonhelper.h>
@@ -36,9 +37,12 @@ namespace Hatchit {
     namespace Game {
 
         class GameObject;
+        class TypeDescriptor;
 
         using JSON = Core::JSON;
 
+        typedef uint32_t ComponentTypeId; /**< Dense runtime id of a Component type. */
+
         class HT_API Component
         {
         public:
@@ -50,6 +54,16 @@ namespace Hatchit {
             template <typename T>
             static Core::Guid GetComponentId(void);
 
+            /**
+            * \brief Returns the dense runtime id associated with a Component of type T.
+            * \tparam T A sub-class of Component.
+            * \return A small integer which is unique among Component types for this run of the program.
+            *
+            * Unlike GetComponentId(), this id is not stable between runs and must never be persisted.
+            */
+            template <typename T>
+            static ComponentTypeId GetComponentTypeId(void);
+
             Component(void) = default;
             virtual ~Component(void) = default;
             Component(const Component& rhs) = default;
@@ -105,8 +119,47 @@ namespace Hatchit {
             */
             virtual Component* VClone(void) const = 0;
 
+            /**
+            * \brief Called on the copy of an initialized Component when its Scene is forked, in place of VOnInit.
+            * Forks only simulate, so the default does nothing: presentation such as playback or renderers is
+            * left to the source. Override it to rebuild per-instance simulation state the copy constructor
+            * does not share.
+            * \sa Scene::Fork()
+            */
+            virtual void VOnForked(void);
+
             virtual Core::Guid VGetComponentId(void) const = 0;
 
+            /**
+            * \brief Returns the dense runtime id of this Component's type.
+            * \sa GetComponentTypeId()
+            */
+            virtual ComponentTypeId VGetComponentTypeId(void) const = 0;
+
+            /**
+            * \brief Returns the reflection description of this Component's type.
+            * \return The description, or nullptr if the type does not reflect its fields.
+            *
+            * Field offsets are relative to the Component, so reflected types must derive from Component
+            * through single, non-virtual inheritance.
+            * \sa TypeDescriptor, HT_REFLECTED
+            */
+            virtual const TypeDescriptor* VGetTypeDescriptor(void) const;
+
+            /**
+            * \brief Appends a binary representation of this Component's state to out.
+            * The default implementation writes the reflected fields, and nothing for types that are not reflected.
+            */
+            virtual void VWriteBinary(std::vector<uint8_t>& out) const;
+
+            /**
+            * \brief Restores this Component's state from the representation written by VWriteBinary.
+            * \param cursor    Position to read from; advanced past the bytes consumed.
+            * \param end       One past the last readable byte.
+            * \return false if the data is truncated or the type cannot be restored from binary.
+            */
+            virtual bool VReadBinary(const uint8_t*& cursor, const uint8_t* end);
+
             /**
             * \brief Setter that sets which GameObject this Component is attached to.
             * \param owner  The GameObject to which this Component is attached.
@@ -127,8 +180,20 @@ namespace Hatchit {
             */
             virtual void VOnDisabled(void) = 0;
 
+            /**
+            * \brief Called after reflected fields were overwritten by VReadBinary.
+            * Components rebuild any state derived from their fields here.
+            */
+            virtual void VOnFieldsLoaded(void);
+
             bool m_enabled{true}; /**< bool indicating if this Component is enabled. */
             GameObject *m_owner; /**< The GameObject to which this Component is attached. */
+
+        private:
+            /**
+            * \brief Hands out the next unused ComponentTypeId.
+            */
+            static ComponentTypeId NextComponentTypeId(void);
         };
 
         template <typename T>
@@ -138,5 +203,13 @@ namespace Hatchit {
             static Core::Guid id = Core::Guid(); /**< This value is set once when the template is instantiated. */
             return id;
         }
+
+        template <typename T>
+        ComponentTypeId Component::GetComponentTypeId(void)
+        {
+            static_assert(std::is_base_of<Component, T>::value && !std::is_same<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
+            static const ComponentTypeId id = NextComponentTypeId(); /**< This value is set once when the template is instantiated. */
+            return id;
+        }
     }
 }
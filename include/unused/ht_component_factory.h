@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace Hatchit {
@@ -22,7 +23,21 @@ namespace Hatchit {
         class ComponentFactory
         {
         public:
-            static Component* MakeComponent(std::string type);
+            /**
+            * \brief Constructs a Component from its registered type name.
+            * \param type  The type name, as registered with HT_REGISTER_COMPONENT.
+            * \return A new default constructed Component, or nullptr if the type is unknown.
+            * \sa ComponentRegistry
+            */
+            static Component* MakeComponent(const std::string& type);
+
+            /**
+            * \brief Constructs a Component from its registered type name without allocating for the lookup.
+            * \param type      Pointer to the type name. Need not be null-terminated.
+            * \param length    Number of characters in type.
+            * \return A new default constructed Component, or nullptr if the type is unknown.
+            */
+            static Component* MakeComponent(const char* type, std::size_t length);
         };
     }
 }
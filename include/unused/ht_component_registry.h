@@ -0,0 +1,260 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class ComponentRegistry
+* \ingroup HatchitGame
+*
+* \brief Hashed table of every Component type known to the engine.
+*
+* Component types register themselves from their own translation unit with
+* HT_REGISTER_COMPONENT. The registry maps a type name to its constructor and
+* its dense ComponentTypeId using an open-addressed hash table, so a lookup by
+* name is a single hash and (usually) a single compare, and never allocates.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_singleton.h>
+#include <ht_component.h>
+#include <ht_reflection.h>
+
+#include <cstdint>
+#include <string>
+#include <new>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class AssetPrefetcher;
+
+        class HT_API ComponentRegistry : public Core::Singleton<ComponentRegistry>
+        {
+        public:
+            /**
+            * \brief Function used to construct a default instance of a registered Component type.
+            */
+            typedef Component*(*Constructor)(void);
+
+            /**
+            * \brief Function used to report the assets a Component description references.
+            * \param jsonObject    The JSON description of a Component of the registered type.
+            * \param prefetcher    The prefetcher to add referenced assets to.
+            */
+            typedef void(*AssetGatherer)(const Core::JSON& jsonObject, AssetPrefetcher& prefetcher);
+
+            /**
+            * \brief Function used to construct a default instance of a registered Component type in place.
+            * \param memory   Uninitialized memory of at least Entry::size bytes, aligned to Entry::align.
+            */
+            typedef Component*(*PlacementConstructor)(void* memory);
+
+            /**
+            * \brief Function used to copy construct an instance of a registered Component type in place.
+            * \param memory   Uninitialized memory of at least Entry::size bytes, aligned to Entry::align.
+            * \param source   The Component to copy. Must be of the registered type.
+            */
+            typedef Component*(*PlacementCopyConstructor)(void* memory, const Component& source);
+
+            /**
+            * \brief Function used to copy construct count instances of a registered Component type side by side.
+            * \param memory   Uninitialized memory of at least count * Entry::size bytes, aligned to Entry::align.
+            * \param source   The Component to copy. Must be of the registered type.
+            * \param count    Number of copies.
+            * \param out      Receives a pointer to each copy.
+            */
+            typedef void(*PlacementCopyConstructArray)(void* memory, const Component& source, std::size_t count, Component** out);
+
+            /**
+            * \brief Flags describing how a Component type may be handled.
+            */
+            enum Flags : uint32_t
+            {
+                NONE                = 0,
+
+                /**
+                * The type's destructor releases nothing, so a Component of the type living in a
+                * SceneArena may be discarded without its destructor running. VOnDestroy is still called.
+                */
+                TRIVIAL_TEARDOWN    = 1 << 0,
+
+                /**
+                * The type's VOnDestroy or destructor touches the renderer, the audio device or resource
+                * caches, so it must run on the main thread even when its Scene is reclaimed in the background.
+                * \sa SceneReclaimer
+                */
+                MAIN_THREAD_TEARDOWN = 1 << 1,
+
+                /**
+                * The type's state is presentation only, such as audio playback, and is left alone when a
+                * SceneRollback saves and restores simulation frames.
+                */
+                NO_ROLLBACK         = 1 << 2
+            };
+
+            /**
+            * \brief Everything the registry knows about a single Component type.
+            */
+            struct Entry
+            {
+                const char*     name;       /**< Type name as it appears in scene files. */
+                std::size_t     nameLength; /**< Length of name, excluding the terminator. */
+                uint64_t        hash;       /**< Hash of name. */
+                ComponentTypeId typeId;     /**< Dense runtime id of the type. */
+                Constructor     construct;  /**< Creates a default instance of the type. */
+                AssetGatherer   gatherAssets; /**< Reports referenced assets, or nullptr if the type has none. */
+                std::size_t     size;       /**< sizeof the type. */
+                std::size_t     align;      /**< alignof the type. */
+                PlacementConstructor        constructAt;        /**< Creates a default instance of the type in place. */
+                PlacementCopyConstructor    copyConstructAt;    /**< Copies an instance of the type in place. */
+                PlacementCopyConstructArray copyConstructArray; /**< Copies an instance of the type into an array in place. */
+                uint32_t        flags;      /**< Combination of Flags. */
+                const TypeDescriptor*       reflection;         /**< Reflected fields of the type, or nullptr if it is not reflected. */
+            };
+
+            /**
+            * \brief Adds a Component type to the registry.
+            * \param entry  Description of the type. name must outlive the registry; nameLength and hash are filled in.
+            * \return false if a type with the same name was already registered.
+            * \sa ComponentRegistrar
+            */
+            static bool Register(Entry entry);
+
+            /**
+            * \brief Looks up a Component type by name.
+            * \param name   Pointer to the first character of the name. Need not be null-terminated.
+            * \param length Number of characters in name.
+            * \return The registry entry, or nullptr if no such type is registered.
+            */
+            static const Entry* Find(const char* name, std::size_t length);
+
+            /**
+            * \brief Looks up a Component type by name.
+            */
+            static const Entry* Find(const std::string& name);
+
+            /**
+            * \brief Looks up a Component type by its dense id.
+            * \return The registry entry, or nullptr if the type was never registered.
+            */
+            static const Entry* Find(ComponentTypeId typeId);
+
+            /**
+            * \brief Returns the number of registered Component types.
+            */
+            static std::size_t Count(void);
+
+            /**
+            * \brief Hashes a type name (64-bit FNV-1a).
+            */
+            static uint64_t Hash(const char* name, std::size_t length);
+
+        private:
+            /**
+            * \brief Rebuilds the open-addressed slot table after a registration.
+            */
+            void RebuildSlots(void);
+
+            std::vector<Entry>    m_entries; /**< Registered types, in registration order. */
+            std::vector<uint32_t> m_slots;   /**< Hash slots holding index + 1 into m_entries, 0 if empty. */
+            std::vector<uint32_t> m_byTypeId; /**< ComponentTypeId to index + 1 into m_entries, 0 if unregistered. */
+        };
+
+        /**
+        * \brief Registers Component type T with the ComponentRegistry on construction.
+        * \tparam T A sub-class of Component with a default constructor.
+        * \sa HT_REGISTER_COMPONENT
+        */
+        template <typename T>
+        class ComponentRegistrar
+        {
+        public:
+            explicit ComponentRegistrar(const char* name, ComponentRegistry::AssetGatherer gather = nullptr, uint32_t flags = ComponentRegistry::NONE)
+            {
+                static_assert(std::is_base_of<Component, T>::value && !std::is_same<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
+
+                ComponentRegistry::Entry entry{};
+                entry.name = name;
+                entry.typeId = Component::GetComponentTypeId<T>();
+                entry.construct = &ComponentRegistrar<T>::Construct;
+                entry.gatherAssets = gather;
+                entry.size = sizeof(T);
+                entry.align = alignof(T);
+                entry.constructAt = &ComponentRegistrar<T>::ConstructAt;
+                entry.copyConstructAt = &ComponentRegistrar<T>::CopyConstructAt;
+                entry.copyConstructArray = &ComponentRegistrar<T>::CopyConstructArray;
+                entry.flags = flags;
+                entry.reflection = Reflection::DescriptorOf<T>();
+                ComponentRegistry::Register(entry);
+            }
+
+        private:
+            static Component* Construct(void)
+            {
+                return new T();
+            }
+
+            static Component* ConstructAt(void* memory)
+            {
+                return new (memory) T();
+            }
+
+            static Component* CopyConstructAt(void* memory, const Component& source)
+            {
+                return new (memory) T(static_cast<const T&>(source));
+            }
+
+            static void CopyConstructArray(void* memory, const Component& source, std::size_t count, Component** out)
+            {
+                const T& prototype = static_cast<const T&>(source);
+                T* objects = static_cast<T*>(memory);
+                for (std::size_t i = 0; i < count; i++)
+                    out[i] = new (objects + i) T(prototype);
+            }
+        };
+    }
+}
+
+/**
+* \brief Registers a Component type under its class name.
+*
+* Place this once in the source file implementing the Component, inside namespace Hatchit::Game.
+* Registration happens during static initialization, so the object file must be linked into the
+* final binary (HatchitGame is built as a shared library, or linked whole-archive).
+*/
+#define HT_REGISTER_COMPONENT(Type) \
+    static ::Hatchit::Game::ComponentRegistrar<Type> s_##Type##Registrar(#Type)
+
+/**
+* \brief Registers a Component type under its class name, along with a function reporting the
+* assets its scene description references so they can be prefetched.
+* \sa AssetPrefetcher
+*/
+#define HT_REGISTER_COMPONENT_WITH_ASSETS(Type, Gatherer) \
+    static ::Hatchit::Game::ComponentRegistrar<Type> s_##Type##Registrar(#Type, Gatherer)
+
+/**
+* \brief Registers a Component type under its class name, along with a combination of ComponentRegistry::Flags.
+*/
+#define HT_REGISTER_COMPONENT_WITH_FLAGS(Type, Flags) \
+    static ::Hatchit::Game::ComponentRegistrar<Type> s_##Type##Registrar(#Type, nullptr, Flags)
+
+/**
+* \brief Registers a Component type under its class name, with both an asset gatherer and ComponentRegistry::Flags.
+*/
+#define HT_REGISTER_COMPONENT_WITH_ASSETS_AND_FLAGS(Type, Gatherer, Flags) \
+    static ::Hatchit::Game::ComponentRegistrar<Type> s_##Type##Registrar(#Type, Gatherer, Flags)
@@ -0,0 +1,124 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class CowPtr
+* \ingroup HatchitGame
+*
+* \brief Shared, copy-on-write pointer to data owned by a Component.
+*
+* Copying a CowPtr shares the pointee, so Components cloned from a prefab all reference
+* the prefab's data. Reads go through the const accessors; Write() gives mutable access,
+* first copying the pointee if anything else still references it. Only the instances that
+* actually modify their data pay for a copy of it.
+*
+* The reference count is not synchronized with writes, so a CowPtr and its copies must
+* only be written from one thread at a time, like the Scene that owns them.
+*/
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        template <typename T>
+        class CowPtr
+        {
+        public:
+            CowPtr(void) = default;
+
+            /**
+            * \brief Takes ownership of value.
+            */
+            explicit CowPtr(T* value)
+                : m_value(value)
+            {
+            }
+
+            /**
+            * \brief Creates a CowPtr to a new T constructed from args.
+            */
+            template <typename... Args>
+            static CowPtr Make(Args&&... args)
+            {
+                return CowPtr(std::make_shared<T>(std::forward<Args>(args)...));
+            }
+
+            /**
+            * \brief Returns the pointee for reading, or nullptr if there is none.
+            */
+            const T* Get(void) const
+            {
+                return m_value.get();
+            }
+
+            const T& operator*(void) const
+            {
+                return *m_value;
+            }
+
+            const T* operator->(void) const
+            {
+                return m_value.get();
+            }
+
+            explicit operator bool(void) const
+            {
+                return m_value != nullptr;
+            }
+
+            /**
+            * \brief Returns the pointee for writing, copying it first if it is shared.
+            *
+            * A CowPtr with no pointee gets a default constructed one.
+            */
+            T& Write(void)
+            {
+                if (!m_value)
+                    m_value = std::make_shared<T>();
+                else if (m_value.use_count() > 1)
+                    m_value = std::make_shared<T>(*m_value);
+                return *m_value;
+            }
+
+            /**
+            * \brief Returns true if other CowPtrs reference the same pointee.
+            */
+            bool IsShared(void) const
+            {
+                return m_value.use_count() > 1;
+            }
+
+            /**
+            * \brief Drops the reference to the pointee, destroying it if this was the last one.
+            */
+            void Reset(void)
+            {
+                m_value.reset();
+            }
+
+        private:
+            explicit CowPtr(std::shared_ptr<T>&& value)
+                : m_value(std::move(value))
+            {
+            }
+
+            std::shared_ptr<T> m_value;
+        };
+    }
+}
@@ -39,6 +39,9 @@
 #endif
 
 #include <ht_component.h>
+#include <ht_guid_table.h>
+#include <ht_name_table.h>
+#include <ht_scene_arena.h>
 
 namespace Hatchit {
 
@@ -48,6 +51,10 @@ namespace Hatchit {
         class HT_API GameObject
         {
         friend class Scene;
+        friend class SceneBenchmark;
+        friend class SceneSnapshot;
+        friend class SceneRollback;
+        friend class SceneHasher;
         public:
             GameObject(const GameObject& rhs) = default;
             GameObject(GameObject&& rhs) = default;
@@ -59,11 +66,32 @@ namespace Hatchit {
             */
             const Core::Guid& GetGuid(void) const;
 
+            /**
+            * \brief Retrieve this GameObject's dense runtime id within its Scene.
+            * \return The ObjectId, or InvalidObjectId if this GameObject does not belong to a Scene.
+            * \sa GuidTable
+            */
+            ObjectId GetId(void) const;
+
             /**
             * \brief Retrieve this GameObject's name.
+            * \return The name, or an empty string if this GameObject is unnamed.
             */
             const std::string& GetName(void) const;
 
+            /**
+            * \brief Retrieve the id of this GameObject's name within its Scene's name table.
+            * \return The NameId, or InvalidNameId if this GameObject is unnamed.
+            * \sa Scene::FindByName()
+            */
+            NameId GetNameId(void) const;
+
+            /**
+            * \brief Retrieve the Scene this GameObject belongs to.
+            * \return The Scene, or nullptr if this GameObject does not belong to one.
+            */
+            Scene* GetScene(void) const;
+
             /**
             * \brief Retrieve this GameObject's Transform.
             */
@@ -268,14 +296,19 @@ namespace Hatchit {
             }
 
         private:
-
+            typedef std::vector<Game::Component*, ArenaAllocator<Game::Component*>> ComponentList;
+            typedef std::vector<GameObject*, ArenaAllocator<GameObject*>> ChildList;
+            typedef std::unordered_map<ComponentTypeId, ComponentList::size_type, std::hash<ComponentTypeId>, std::equal_to<ComponentTypeId>,
+                ArenaAllocator<std::pair<const ComponentTypeId, ComponentList::size_type>>> ComponentMap;
 
             /**
             * \brief The constructor for GameObject.
             *
             * Responsible for initializing the Component vector, Component bitmask, and child vector.
+            *
+            * \param scene  The Scene creating this GameObject, whose arena the vectors allocate from. nullptr to use the heap.
             */
-            GameObject(void);
+            explicit GameObject(Scene* scene = nullptr);
 
             /**
             * \brief The constructor for GameObject read from scene file.
@@ -283,13 +316,14 @@ namespace Hatchit {
             * Responsible for initializing the Component vector, Component bitmask, and child vector.
             * Sets the GameObject's guid to an existing value.
             *
+            * \param scene      The Scene creating this GameObject, whose arena the vectors allocate from.
             * \param guid       The Guid for this GameObject.
-            * \param name       The name of this GameObject.
+            * \param name       The id of this GameObject's name in its Scene's name table.
             * \param t          The Transform for this GameObject.
             * \param enabled    Whether or not this GameObject is enabled
             * \sa Guid(), Transform()
             */
-            GameObject(const Core::Guid guid, const std::string name, Transform t, bool enabled);
+            GameObject(Scene* scene, const Core::Guid& guid, NameId name, const Transform& t, bool enabled);
 
 
             /**
@@ -298,6 +332,23 @@ namespace Hatchit {
             */
             ~GameObject(void);
 
+            /**
+            * \brief Destroys a Component that was attached to this GameObject, returning its memory to wherever it came from.
+            */
+            void DestroyComponent(Component* component);
+
+            /**
+            * \brief Destroys a child GameObject, returning its memory to wherever it came from.
+            */
+            void DestroyChild(GameObject* child);
+
+            /**
+            * \brief Disables, destroys and detaches the Component of the provided type.
+            * \return false if no Component of the type is attached.
+            * \sa RemoveComponent()
+            */
+            bool RemoveComponent(ComponentTypeId component_id);
+
 
             /**
             * \brief Called when the gameobject is enabled.
@@ -337,13 +388,18 @@ namespace Hatchit {
 
             bool m_enabled; /**< bool indicating if this GameObject is enabled. */
             bool m_destroyed;//* < bool indicating that this object is to be destroyed on the next update call*/
-            std::string m_name; /**< The name associated with this GameObject. */
-            Core::Guid m_guid; /**< The Guid associated with this GameObject. */
+            bool m_initialized; /**< bool indicating that OnInit has been called. */
+            NameId m_name; /**< The name associated with this GameObject, interned in m_scene. */
+            Core::Guid m_guid; /**< The Guid associated with this GameObject, kept for persistence. */
+            ObjectId m_id; /**< The dense runtime id of this GameObject within m_scene. */
+            ObjectId m_prefab; /**< ObjectId of the Prefab this GameObject was created from, InvalidObjectId if none. */
+            Scene* m_scene; /**< The Scene this GameObject belongs to. */
+            int32_t m_initPriority; /**< Order in which the Scene initializes this GameObject, higher first. */
             Transform m_transform; /**< The Transform representing the position/orientation of this GameObject. */
             GameObject *m_parent; /**< The parent of this GameObject. */
-            std::vector<GameObject*> m_children; /**< All the GameObjects which are children of this GameObject. */
-            std::vector<Game::Component*> m_components; /**< std::vector of all attached Components. */
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type> m_componentMap; /**< Unique mapping of Component to Guid. */
+            ChildList m_children; /**< All the GameObjects which are children of this GameObject. */
+            ComponentList m_components; /**< std::vector of all attached Components, nullptr where one was removed. */
+            ComponentMap m_componentMap; /**< Unique mapping of Component type to index in m_components. */
         };
 
 
@@ -352,8 +408,8 @@ namespace Hatchit {
         {
             static_assert(std::is_base_of<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
 
-            Core::Guid component_id = Game::Component::template GetComponentId<T>();
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type>::const_iterator iter = m_componentMap.find(component_id);
+            ComponentTypeId component_id = Game::Component::template GetComponentTypeId<T>();
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
             if (iter != m_componentMap.cend())
                 return false;
 
@@ -373,8 +429,8 @@ namespace Hatchit {
         template <>
         inline bool GameObject::AddComponent<Component>(Component *component)
         {
-            Core::Guid component_id = component->VGetComponentId();
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type>::const_iterator iter = m_componentMap.find(component_id);
+            ComponentTypeId component_id = component->VGetComponentTypeId();
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
             if (iter != m_componentMap.cend())
                 return false;
 
@@ -396,8 +452,8 @@ namespace Hatchit {
         {
             static_assert(std::is_base_of<Component, T>::value && !std::is_same<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
 
-            Core::Guid component_id = Game::Component:: template GetComponentId<T>();
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type>::const_iterator iter = m_componentMap.find(component_id);
+            ComponentTypeId component_id = Game::Component:: template GetComponentTypeId<T>();
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
             if (iter != m_componentMap.cend())
                 return false;
 
@@ -420,12 +476,12 @@ namespace Hatchit {
         {
             static_assert(std::is_base_of<Component, T>::value && !std::is_same<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
 
-            Core::Guid component_id = Game::Component:: template GetComponentId<T>();
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type>::const_iterator iter = m_componentMap.find(component_id);
+            ComponentTypeId component_id = Game::Component:: template GetComponentTypeId<T>();
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
             if (iter == m_componentMap.cend())
                 return false;
 
-            std::vector<Component*>::size_type index = m_componentMap[component_id];
+            ComponentList::size_type index = m_componentMap[component_id];
             Component *component = m_components[index];
             if(component->GetEnabled())
                 component->SetEnabled(false);
@@ -433,7 +489,7 @@ namespace Hatchit {
 
             m_components[index] = nullptr;
             m_componentMap.erase(component_id);
-            delete component;
+            DestroyComponent(component);
 
             return true;
         }
@@ -442,7 +498,7 @@ namespace Hatchit {
         bool GameObject::HasComponent(void) const
         {
             static_assert(std::is_base_of<Component, T>::value && !std::is_same<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
-            Core::Guid component_id = Component:: template GetComponentId<T>();
+            ComponentTypeId component_id = Component:: template GetComponentTypeId<T>();
             return (m_componentMap.find(component_id) != m_componentMap.cend());
         }
 
@@ -458,12 +514,12 @@ namespace Hatchit {
         {
             static_assert(std::is_base_of<Component, T>::value && !std::is_same<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
 
-            Core::Guid component_id = Component::GetComponentId<T>();
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type>::const_iterator iter = m_componentMap.find(component_id);
+            ComponentTypeId component_id = Component::GetComponentTypeId<T>();
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
             if (iter == m_componentMap.cend())
                 return nullptr;
 
-            std::vector<Component*>::size_type index = m_componentMap[component_id];
+            ComponentList::size_type index = m_componentMap[component_id];
             return dynamic_cast<T*>(m_components[index]);
         }
 
@@ -481,8 +537,8 @@ namespace Hatchit {
             if (!HasComponent<T>())
                 return false;
 
-            Core::Guid component_id = Component::GetComponentId<T>();
-            std::vector<Component*>::size_type index = m_componentMap[component_id];
+            ComponentTypeId component_id = Component::GetComponentTypeId<T>();
+            ComponentList::size_type index = m_componentMap[component_id];
             Component *component = m_components[index];
             if (component->GetEnabled())
                 return false;
@@ -500,8 +556,8 @@ namespace Hatchit {
             if (!HasComponent<T>())
                 return false;
 
-            Core::Guid component_id = Component::GetComponentId<T>();
-            std::vector<Component*>::size_type index = m_componentMap[component_id];
+            ComponentTypeId component_id = Component::GetComponentTypeId<T>();
+            ComponentList::size_type index = m_componentMap[component_id];
             Component *component = m_components[index];
             if (!component->GetEnabled())
                 return false;
@@ -516,8 +572,8 @@ namespace Hatchit {
         {
             static_assert(std::is_base_of<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
 
-            Core::Guid component_id = Component::GetComponentId<T>();
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type>::const_iterator iter = m_componentMap.find(component_id);
+            ComponentTypeId component_id = Component::GetComponentTypeId<T>();
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
             if (iter != m_componentMap.cend())
                 return false;
 
@@ -532,8 +588,8 @@ namespace Hatchit {
         template<>
         inline bool GameObject::AddUninitializedComponent<Component>(Component* component)
         {
-            Core::Guid component_id = component->VGetComponentId();
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type>::const_iterator iter = m_componentMap.find(component_id);
+            ComponentTypeId component_id = component->VGetComponentTypeId();
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
             if (iter != m_componentMap.cend())
                 return false;
 
@@ -550,8 +606,8 @@ namespace Hatchit {
         {
             static_assert(std::is_base_of<Component, T>::value && !std::is_same<Component, T>::value, "Must be a sub-class of Hatchit::Game::Component!");
 
-            Core::Guid component_id = Game::Component:: template GetComponentId<T>();
-            std::unordered_map<Core::Guid, std::vector<Component*>::size_type>::const_iterator iter = m_componentMap.find(component_id);
+            ComponentTypeId component_id = Game::Component:: template GetComponentTypeId<T>();
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
             if (iter != m_componentMap.cend())
                 return false;
 
@@ -0,0 +1,93 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class GuidTable
+* \ingroup HatchitGame
+*
+* \brief Interns Guids into dense 32-bit ObjectIds.
+*
+* Guids identify GameObjects on disk. At runtime a Scene interns every Guid it
+* loads into a GuidTable and works with the resulting ObjectIds, which are
+* contiguous from zero and can index plain arrays. The Guid is only looked up
+* again when an object has to be written back out. Ids of erased Guids are
+* handed out again, so the id space stays as large as the most GameObjects
+* alive at once.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_guid.h>
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        typedef uint32_t ObjectId; /**< Dense runtime id of a GameObject within a Scene. */
+
+        static const ObjectId InvalidObjectId = UINT32_MAX; /**< ObjectId that never refers to a GameObject. */
+
+        class HT_API GuidTable
+        {
+        public:
+            /**
+            * \brief Returns the ObjectId of a Guid, assigning a free id if it has not been seen before.
+            */
+            ObjectId Intern(const Core::Guid& guid);
+
+            /**
+            * \brief Returns the ObjectId of a Guid.
+            * \return The ObjectId, or InvalidObjectId if the Guid was never interned.
+            */
+            ObjectId Find(const Core::Guid& guid) const;
+
+            /**
+            * \brief Returns the Guid an ObjectId was interned from.
+            *
+            * The result is unspecified for an erased id that has not been reused yet.
+            */
+            const Core::Guid& GetGuid(ObjectId id) const;
+
+            /**
+            * \brief Forgets a Guid and makes its ObjectId available to the next Intern().
+            */
+            void Erase(ObjectId id);
+
+            /**
+            * \brief Returns the number of ObjectIds handed out, erased ones included. ObjectIds are always less than this value.
+            */
+            std::size_t Size(void) const;
+
+            /**
+            * \brief Reserves room for count Guids.
+            */
+            void Reserve(std::size_t count);
+
+            /**
+            * \brief Forgets every interned Guid.
+            */
+            void Clear(void);
+
+        private:
+            std::vector<Core::Guid> m_guids; /**< Guids indexed by ObjectId. */
+            std::unordered_map<Core::Guid, ObjectId> m_ids; /**< Reverse lookup, only used at the persistence boundary. */
+            std::vector<ObjectId> m_freeIds; /**< Erased ids, reused last in first out. */
+        };
+    }
+}
@@ -0,0 +1,192 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class InterestManager
+* \ingroup HatchitGame
+*
+* \brief Works out which GameObjects of a Scene each observer needs.
+*
+* An observer is a position and a radius, either set directly or following a GameObject,
+* typically the one carrying a Camera. Every Update() the live GameObjects are bucketed
+* into a hashed uniform grid by world position, and each observer only tests the
+* GameObjects in the cells its sphere overlaps, so the cost follows what an observer can
+* see rather than the size of the Scene.
+*
+* A GameObject is relevant while it lies within the radius of the observer, and stays
+* relevant until it moves beyond the radius widened by the hysteresis, so GameObjects on
+* the boundary do not flicker in and out. The ancestors of a relevant GameObject are
+* relevant too, since its Transform is relative to theirs. Each Update() reports the
+* GameObjects that entered and left the set of every observer.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_math.h>
+#include <ht_guid_table.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class Scene;
+        class GameObject;
+        struct SceneState;
+
+        typedef uint32_t ObserverId; /**< Handle to an observer of an InterestManager. */
+
+        static const ObserverId InvalidObserverId = UINT32_MAX; /**< ObserverId that never refers to an observer. */
+
+        class HT_API InterestManager
+        {
+        public:
+            /**
+            * \param cellSize   Edge length of a grid cell. Works best around the typical observer radius.
+            */
+            explicit InterestManager(float cellSize = 16.0f);
+
+            /**
+            * \brief Sets the edge length of a grid cell. Takes effect on the next Update().
+            */
+            void SetCellSize(float cellSize);
+
+            /**
+            * \brief Gets the edge length of a grid cell.
+            */
+            float GetCellSize(void) const;
+
+            /**
+            * \brief Sets how far beyond its radius, as a fraction of the radius, a relevant GameObject
+            * must move before it leaves the set of an observer. Defaults to 0.1.
+            */
+            void SetHysteresis(float fraction);
+
+            /**
+            * \brief Adds an observer at a fixed position.
+            * \param position   World position of the observer.
+            * \param radius     Distance within which GameObjects are relevant to the observer.
+            */
+            ObserverId AddObserver(const Math::Vector3& position, float radius);
+
+            /**
+            * \brief Adds an observer following a GameObject.
+            * \param follow     The GameObject whose world position the observer takes on each Update().
+            * \param radius     Distance within which GameObjects are relevant to the observer. If 0, the
+            *                   far plane of a Camera on the followed GameObject is used.
+            *
+            * If the GameObject is destroyed the observer stays where it was last seen.
+            */
+            ObserverId AddObserver(ObjectId follow, float radius = 0.0f);
+
+            /**
+            * \brief Moves an observer. An observer following a GameObject stops following it.
+            */
+            void SetObserverPosition(ObserverId observer, const Math::Vector3& position);
+
+            /**
+            * \brief Changes the radius of an observer.
+            */
+            void SetObserverRadius(ObserverId observer, float radius);
+
+            /**
+            * \brief Removes an observer. Its ObserverId may be handed out again.
+            */
+            void RemoveObserver(ObserverId observer);
+
+            /**
+            * \brief Recomputes the relevant GameObjects of every observer.
+            * \param scene  The Scene to observe. Prefabs are never relevant.
+            */
+            void Update(const Scene& scene);
+
+            /**
+            * \brief Gets the GameObjects relevant to an observer as of the last Update(), sorted by ObjectId.
+            */
+            const std::vector<ObjectId>& GetRelevant(ObserverId observer) const;
+
+            /**
+            * \brief Gets the GameObjects that became relevant to an observer in the last Update(), sorted by ObjectId.
+            */
+            const std::vector<ObjectId>& GetEntered(ObserverId observer) const;
+
+            /**
+            * \brief Gets the GameObjects that stopped being relevant to an observer in the last Update(), sorted by ObjectId.
+            */
+            const std::vector<ObjectId>& GetLeft(ObserverId observer) const;
+
+            /**
+            * \brief Returns true if a GameObject was relevant to an observer as of the last Update().
+            */
+            bool IsRelevant(ObserverId observer, ObjectId id) const;
+
+            /**
+            * \brief Copies the part of a SceneState relevant to an observer.
+            * \param observer   The observer.
+            * \param state      State of the observed Scene, normally captured in the same tick as the last Update().
+            * \param out        Cleared and filled with the relevant GameObjects and their Components. A GameObject
+            *                   whose parent is not in the relevant set becomes a root.
+            *
+            * Encoding the filtered state with a SceneDelta per observer keeps replication to what each observer can see.
+            */
+            void Filter(ObserverId observer, const SceneState& state, SceneState& out) const;
+
+        private:
+            struct Observer
+            {
+                bool            active;
+                ObjectId        follow;     /**< GameObject followed, or InvalidObjectId. */
+                Math::Vector3   position;
+                float           radius;
+                std::vector<ObjectId> relevant; /**< Sorted. */
+                std::vector<ObjectId> entered;  /**< Sorted. */
+                std::vector<ObjectId> left;     /**< Sorted. */
+            };
+
+            /**
+            * \brief Buckets the GameObjects collected for this Update() into the grid.
+            */
+            void BuildGrid(void);
+
+            /**
+            * \brief Recomputes the relevant set of an observer from the grid.
+            */
+            void Query(Observer& observer);
+
+            /**
+            * \brief Marks a GameObject relevant for the current query, along with its ancestors.
+            */
+            void Mark(uint32_t index);
+
+            float                   m_cellSize;
+            float                   m_hysteresis;
+            std::vector<Observer>   m_observers;
+            std::vector<ObserverId> m_freeObservers;
+
+            std::vector<GameObject*> m_objects;    /**< Live GameObjects as of the last Update(). */
+            std::vector<uint32_t>   m_parents;      /**< Index in m_objects of the parent of each GameObject. */
+            std::vector<bool>       m_visited;      /**< Scratch space for Scene::CollectLiveGameObjects. */
+            std::vector<float>      m_positions;    /**< World position of each GameObject, 3 floats apiece. */
+            std::vector<int32_t>    m_cells;        /**< Grid cell of each GameObject, 3 ints apiece. */
+            std::vector<uint32_t>   m_bucketStart;  /**< Start of each hash bucket in m_bucketObjects, followed by the end. */
+            std::vector<uint32_t>   m_bucketObjects; /**< Indices into m_objects, grouped by hash bucket. */
+            std::vector<uint32_t>   m_marks;        /**< Query during which each GameObject was last marked relevant. */
+            uint32_t                m_query;        /**< Number of the current query. */
+            std::vector<ObjectId>   m_scratch;      /**< Relevant set being built by the current query. */
+        };
+    }
+}
@@ -18,6 +18,7 @@
 #include <ht_meshrenderer.h>
 #include <ht_component.h>
 #include <ht_model.h>
+#include <ht_cow.h>
 
 
 namespace Hatchit {
@@ -31,16 +32,29 @@ namespace Hatchit {
             DIRECTIONAL_LIGHT
         };
 
+        class AssetPrefetcher;
+
         class LightComponent : public Component
         {
         public:
             LightComponent();
 
+            /**
+            * \brief Copies a LightComponent, sharing its light parameters until either changes them.
+            */
+            LightComponent(const LightComponent& other);
+
             virtual Core::JSON VSerialize(void) override;
             virtual bool VDeserialize(const Core::JSON& jsonObject) override;
 
             void SetType(LightType lightType);
 
+            /**
+            * \brief Reports the mesh and material used to draw the light described by jsonObject.
+            * \sa AssetPrefetcher
+            */
+            static void GatherAssets(const Core::JSON& jsonObject, AssetPrefetcher& prefetcher);
+
             void VOnInit() override;
 
             void VOnUpdate() override;
@@ -48,6 +62,7 @@ namespace Hatchit {
             Component* VClone() const override;
 
             virtual Core::Guid VGetComponentId(void) const override;
+            virtual ComponentTypeId VGetComponentTypeId(void) const override;
         protected:
 
             void VOnEnabled() override;
@@ -60,21 +75,37 @@ namespace Hatchit {
 
             bool SetMeshAndMaterial(std::string meshFile, std::string materialFile);
 
-            LightType m_lightType;
-            Graphics::MeshRenderer* m_meshRenderer;
-            Graphics::MeshHandle m_mesh;
-            Graphics::MaterialHandle m_material;
+            static bool GetLightAssets(LightType lightType, const char*& meshFile, const char*& materialFile);
+
+            /**
+            * \brief Description of a light, shared between the instances of a prefab.
+            */
+            struct Parameters
+            {
+                Parameters(void);
 
-            /* Point Light Data */
-            float m_radius;
-            Math::Vector3 m_attenuation;
+                LightType lightType;
+                Graphics::MeshHandle mesh;
+                Graphics::MaterialHandle material;
+                bool assetsLoaded; /**< Whether mesh and material match lightType. */
 
-            /* Directional & Spot Light Data*/
-            Math::Vector3 m_direction;            
+                /* Point Light Data */
+                float radius;
+                Math::Vector3 attenuation;
 
-            /* All Light Data */
+                /* Directional & Spot Light Data*/
+                Math::Vector3 direction;
+
+                /* All Light Data */
+                Math::Vector4 color;
+            };
+
+            CowPtr<Parameters> m_parameters;
+
+            /* Per instance, created in VOnInit */
+            Graphics::MeshRenderer* m_meshRenderer;
             Graphics::ShaderVariableChunk* m_data;
-            Math::Vector4 m_color;
+            uint32_t m_layer; /**< Layer flags matched against the Cameras' layers when culling. */
         };
     }
 }
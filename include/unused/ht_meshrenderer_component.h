@@ -16,22 +16,36 @@
 
 #include <ht_meshrenderer.h>
 #include <ht_component.h>
+#include <ht_cow.h>
 
 namespace Hatchit {
 
     namespace Game {
 
+        class AssetPrefetcher;
+
         class MeshRenderer : public Component
         {
         public:
             MeshRenderer(void);
 
+            /**
+            * \brief Copies a MeshRenderer, sharing its mesh and material until either is changed.
+            */
+            MeshRenderer(const MeshRenderer& other);
+
             virtual Core::JSON VSerialize(void) override;
             virtual bool VDeserialize(const Core::JSON& jsonObject) override;
 
             void SetRenderable(Graphics::MeshHandle mesh, 
                 Graphics::MaterialHandle material);
 
+            /**
+            * \brief Reports the mesh and material referenced by a MeshRenderer description.
+            * \sa AssetPrefetcher
+            */
+            static void GatherAssets(const Core::JSON& jsonObject, AssetPrefetcher& prefetcher);
+
             /**
             * \brief Called when the GameObject is created to initialize all values
             */
@@ -49,6 +63,7 @@ namespace Hatchit {
             Component* VClone() const override;
 
             virtual Core::Guid VGetComponentId(void) const override;
+            virtual ComponentTypeId VGetComponentTypeId(void) const override;
         protected:
 
             /**
@@ -73,8 +88,36 @@ namespace Hatchit {
             void VOnDestroy() override;
 
         private:
-            Graphics::MeshRenderer* m_meshRenderer;
-            Graphics::ShaderVariableChunk* m_instanceData;
+            /**
+            * \brief Assigns the mesh and material drawn, batched with the other renderers of \p batch.
+            */
+            void AssignRenderable(Graphics::MeshHandle mesh,
+                Graphics::MaterialHandle material, uint64_t batch);
+
+            /**
+            * \brief The mesh and material drawn, shared between the instances of a prefab.
+            *
+            * Every instance adds its world matrix to its Scene's RenderQueue, which draws the visible instances
+            * of each batch with a single Graphics::MeshRenderer.
+            */
+            struct Renderable
+            {
+                Renderable(void);
+                Renderable(const Renderable& other);
+                ~Renderable(void);
+
+                Renderable& operator=(const Renderable&) = delete;
+
+                Graphics::MeshRenderer*     meshRenderer;
+                Graphics::MeshHandle        mesh;
+                Graphics::MaterialHandle    material;
+                uint64_t                    batch; /**< RenderQueue batch of mesh and material. */
+            };
+
+            CowPtr<Renderable> m_renderable;
+            float m_boundsRadius; /**< Radius of the mesh's bounding sphere around the origin, 0 if it is never culled. */
+            uint32_t m_layer; /**< Layer flags matched against the Cameras' layers when culling. */
+            bool m_transparent; /**< Whether the mesh is drawn back to front after opaque meshes and lights. */
         };
 
     }
@@ -0,0 +1,86 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class NameTable
+* \ingroup HatchitGame
+*
+* \brief Interns strings into dense 32-bit NameIds.
+*
+* Each distinct string is stored once, no matter how many GameObjects share it.
+* References returned by GetString() stay valid until the table is cleared.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        typedef uint32_t NameId; /**< Dense runtime id of an interned string. */
+
+        static const NameId InvalidNameId = UINT32_MAX; /**< NameId that never refers to a string. */
+
+        class HT_API NameTable
+        {
+        public:
+            NameTable(void) = default;
+            NameTable(NameTable&& rhs) = default;
+            NameTable& operator=(NameTable&& rhs) = default;
+
+            /**
+            * \brief Copies every interned string, keeping their NameIds.
+            */
+            NameTable(const NameTable& rhs);
+            NameTable& operator=(const NameTable& rhs);
+
+            /**
+            * \brief Returns the NameId of a string, storing the string if it has not been seen before.
+            */
+            NameId Intern(const std::string& name);
+
+            /**
+            * \brief Returns the NameId of a string.
+            * \return The NameId, or InvalidNameId if the string was never interned.
+            */
+            NameId Find(const std::string& name) const;
+
+            /**
+            * \brief Returns the string a NameId was interned from.
+            */
+            const std::string& GetString(NameId id) const;
+
+            /**
+            * \brief Returns the number of distinct interned strings.
+            */
+            std::size_t Size(void) const;
+
+            /**
+            * \brief Forgets every interned string.
+            */
+            void Clear(void);
+
+        private:
+            std::unordered_map<std::string, NameId> m_ids; /**< Owns the strings; its nodes never move. */
+            std::vector<const std::string*> m_strings; /**< Strings indexed by NameId, pointing into m_ids. */
+        };
+    }
+}
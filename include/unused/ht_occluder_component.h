@@ -0,0 +1,76 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class Occluder
+* \ingroup HatchitGame
+*
+* \brief Marks a GameObject as hiding what is behind it from the Cameras, such as a wall or a floor.
+*
+* Each frame the Occluder adds a box, centered on its GameObject and aligned to its Transform, to its
+* Scene's RenderQueue. The box is rasterized into a small depth buffer on the CPU, and draws entirely
+* behind it are not submitted. The box should fit inside the geometry it stands for.
+*/
+
+#pragma once
+
+#include <ht_component.h>
+#include <ht_math.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class Occluder : public Component
+        {
+        public:
+            Occluder(void);
+
+            virtual Core::JSON VSerialize(void) override;
+            virtual bool VDeserialize(const Core::JSON& jsonObject) override;
+
+            void VOnInit() override;
+
+            /**
+            * \brief Called once per frame while the GameObject is enabled.
+            * Adds the occluder's box to the Scene's RenderQueue.
+            */
+            void VOnUpdate() override;
+
+            Component* VClone(void) const override;
+
+            virtual Core::Guid VGetComponentId(void) const override;
+            virtual ComponentTypeId VGetComponentTypeId(void) const override;
+
+            /**
+            * \brief Sets half the size of the box along the GameObject's right, up and forward axes, before scaling.
+            */
+            void SetExtents(const Math::Vector3& extents);
+
+            /**
+            * \brief Gets half the size of the box along the GameObject's right, up and forward axes, before scaling.
+            */
+            const Math::Vector3& GetExtents(void) const;
+
+        protected:
+            void VOnEnabled() override;
+            void VOnDisabled() override;
+            void VOnDestroy() override;
+
+        private:
+            Math::Vector3 m_extents; /**< Half size of the box before the world Transform scales it. */
+            uint32_t m_layer; /**< Layer flags matched against the Cameras' layers. */
+        };
+    }
+}
@@ -0,0 +1,331 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class TypeDescriptor
+* \ingroup HatchitGame
+*
+* \brief Description of the fields of a reflected type.
+*
+* A type opts in by declaring HT_REFLECTED() in the public section of its class and
+* listing its fields between HT_REFLECT_BEGIN and HT_REFLECT_END in its source file.
+* Each field records its name, offset and type, which is enough to round-trip the
+* type through JSON and through a compact binary form. Nested reflected types are
+* flattened when the description is built, and runs of adjacent trivially copyable
+* fields are merged so the binary form is written and read with one memcpy per run.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_jsonhelper.h>
+#include <ht_math.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class TypeDescriptor;
+        class StateHash;
+
+        /**
+        * \brief The kind of value stored in a reflected field.
+        */
+        enum class FieldType : uint8_t
+        {
+            Bool,
+            Int,    /**< Signed integer or enum with a signed underlying type; see FieldDescriptor::size. */
+            UInt,   /**< Unsigned integer or enum with an unsigned underlying type; see FieldDescriptor::size. */
+            Float,  /**< float, or a Math::Float2/3/4; see FieldDescriptor::count. */
+            Double,
+            String, /**< std::string. */
+            Struct  /**< Another reflected type; see FieldDescriptor::nested. */
+        };
+
+        /**
+        * \brief A single reflected field.
+        */
+        struct FieldDescriptor
+        {
+            const char*             name;   /**< Key of the field in JSON. */
+            uint32_t                offset; /**< Byte offset of the field within its owner. */
+            uint32_t                size;   /**< sizeof the field. */
+            uint32_t                count;  /**< Number of elements for Float and Double fields, 1 otherwise. */
+            FieldType               type;   /**< The kind of value stored. */
+            const TypeDescriptor*   nested; /**< Description of a Struct field, nullptr otherwise. */
+        };
+
+        class HT_API TypeDescriptor
+        {
+        public:
+            /**
+            * \brief Builds the description of a type from its fields.
+            * \param name   The name of the type. Must outlive the descriptor.
+            * \param fields The fields of the type, in any order.
+            */
+            TypeDescriptor(const char* name, std::initializer_list<FieldDescriptor> fields);
+
+            /**
+            * \brief Returns the name of the described type.
+            */
+            const char* GetName(void) const;
+
+            /**
+            * \brief Returns the fields of the described type, as they were declared.
+            */
+            const std::vector<FieldDescriptor>& GetFields(void) const;
+
+            /**
+            * \brief Returns a hash of the names, offsets and types of every field.
+            *
+            * Binary data written by one layout can only be read back by a descriptor with the same hash.
+            */
+            uint64_t GetLayoutHash(void) const;
+
+            /**
+            * \brief Returns true if every field, including nested ones, can be copied with memcpy.
+            */
+            bool IsTriviallyCopyable(void) const;
+
+            /**
+            * \brief Writes every field of object to a JSON object keyed by field name.
+            */
+            Core::JSON ToJson(const void* object) const;
+
+            /**
+            * \brief Reads the fields of object from a JSON object keyed by field name.
+            *
+            * Fields missing from jsonObject keep their current value.
+            * \return false if jsonObject is not an object or a present field has the wrong JSON type.
+            */
+            bool FromJson(const Core::JSON& jsonObject, void* object) const;
+
+            /**
+            * \brief Appends the binary form of object to out.
+            */
+            void WriteBinary(const void* object, std::vector<uint8_t>& out) const;
+
+            /**
+            * \brief Reads object from the binary form written by WriteBinary.
+            * \param cursor Position to read from; advanced past the bytes consumed.
+            * \param end    One past the last readable byte.
+            * \return false if the data is truncated, in which case object may be partially written.
+            */
+            bool ReadBinary(void* object, const uint8_t*& cursor, const uint8_t* end) const;
+
+            /**
+            * \brief Copies every reflected field of source to destination.
+            */
+            void Copy(void* destination, const void* source) const;
+
+            /**
+            * \brief Adds the value of every field of object to a hash.
+            *
+            * Hashes the same bytes WriteBinary writes, so two objects hash alike exactly when
+            * their binary forms match.
+            */
+            void HashState(const void* object, StateHash& hash) const;
+
+        private:
+            /**
+            * \brief A run of adjacent trivially copyable bytes.
+            */
+            struct Span
+            {
+                uint32_t offset;
+                uint32_t size;
+            };
+
+            const char*                     m_name;
+            std::vector<FieldDescriptor>    m_fields;
+            std::vector<Span>               m_spans;    /**< Merged trivially copyable runs, sorted by offset. */
+            std::vector<uint32_t>           m_strings;  /**< Offsets of every std::string field, flattened. */
+            uint64_t                        m_layoutHash;
+        };
+
+        namespace Reflection {
+
+            /**
+            * \brief Detects a type declaring HT_REFLECTED().
+            */
+            template <typename T>
+            class IsReflected
+            {
+                template <typename U>
+                static std::true_type Test(decltype(&U::Reflect));
+
+                template <typename U>
+                static std::false_type Test(...);
+
+            public:
+                static const bool value = decltype(Test<T>(nullptr))::value;
+            };
+
+            /**
+            * \brief Maps a C++ field type to its FieldType. Unsupported types fail to compile.
+            */
+            template <typename T, typename Enable = void>
+            struct FieldTraits;
+
+            template <>
+            struct FieldTraits<bool>
+            {
+                static const FieldType type = FieldType::Bool;
+                static const TypeDescriptor* Nested(void) { return nullptr; }
+            };
+
+            template <typename T>
+            struct FieldTraits<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+            {
+                static const FieldType type = std::is_signed<T>::value ? FieldType::Int : FieldType::UInt;
+                static const TypeDescriptor* Nested(void) { return nullptr; }
+            };
+
+            template <typename T>
+            struct FieldTraits<T, typename std::enable_if<std::is_enum<T>::value>::type>
+                : FieldTraits<typename std::underlying_type<T>::type>
+            {
+            };
+
+            template <>
+            struct FieldTraits<float>
+            {
+                static const FieldType type = FieldType::Float;
+                static const TypeDescriptor* Nested(void) { return nullptr; }
+            };
+
+            template <>
+            struct FieldTraits<double>
+            {
+                static const FieldType type = FieldType::Double;
+                static const TypeDescriptor* Nested(void) { return nullptr; }
+            };
+
+            template <> struct FieldTraits<Math::Float2> : FieldTraits<float> {};
+            template <> struct FieldTraits<Math::Float3> : FieldTraits<float> {};
+            template <> struct FieldTraits<Math::Float4> : FieldTraits<float> {};
+
+            template <>
+            struct FieldTraits<std::string>
+            {
+                static const FieldType type = FieldType::String;
+                static const TypeDescriptor* Nested(void) { return nullptr; }
+            };
+
+            template <typename T>
+            struct FieldTraits<T, typename std::enable_if<std::is_class<T>::value && IsReflected<T>::value>::type>
+            {
+                static const FieldType type = FieldType::Struct;
+                static const TypeDescriptor* Nested(void) { return &T::Reflect(); }
+            };
+
+            /**
+            * \brief Returns the byte offset of member within T.
+            *
+            * Measured on uninitialized storage, so T is never constructed. Unlike offsetof,
+            * this also works for the non-standard-layout types Components always are.
+            */
+            template <typename T, typename M>
+            uint32_t OffsetOf(M T::* member)
+            {
+                typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+                const T* object = reinterpret_cast<const T*>(&storage);
+                return static_cast<uint32_t>(reinterpret_cast<const char*>(&(object->*member)) - reinterpret_cast<const char*>(object));
+            }
+
+            /**
+            * \brief Describes a data member of T.
+            * \sa HT_REFLECT_FIELD
+            */
+            template <typename T, typename M>
+            FieldDescriptor MakeField(const char* name, M T::* member)
+            {
+                typedef FieldTraits<M> Traits;
+
+                FieldDescriptor field{};
+                field.name = name;
+                field.offset = OffsetOf(member);
+                field.size = static_cast<uint32_t>(sizeof(M));
+                field.type = Traits::type;
+                field.nested = Traits::Nested();
+
+                if (field.type == FieldType::Float)
+                    field.count = field.size / sizeof(float);
+                else if (field.type == FieldType::Double)
+                    field.count = field.size / sizeof(double);
+                else
+                    field.count = 1;
+
+                return field;
+            }
+
+            /**
+            * \brief Returns the description of T, or nullptr if T is not reflected.
+            */
+            template <typename T>
+            typename std::enable_if<IsReflected<T>::value, const TypeDescriptor*>::type DescriptorOf(void)
+            {
+                return &T::Reflect();
+            }
+
+            template <typename T>
+            typename std::enable_if<!IsReflected<T>::value, const TypeDescriptor*>::type DescriptorOf(void)
+            {
+                return nullptr;
+            }
+        }
+    }
+}
+
+/**
+* \brief Declares the reflection description of a class. Place in the public section of the class.
+*/
+#define HT_REFLECTED() \
+    static const ::Hatchit::Game::TypeDescriptor& Reflect(void)
+
+/**
+* \brief Begins the list of reflected fields of Type. Place in the source file implementing Type.
+*
+* \code
+* HT_REFLECT_BEGIN(TweenValue)
+*     HT_REFLECT_FIELD("Values", m_values)
+*     HT_REFLECT_FIELD("Type", m_valueType)
+* HT_REFLECT_END()
+* \endcode
+*/
+#define HT_REFLECT_BEGIN(Type) \
+    const ::Hatchit::Game::TypeDescriptor& Type::Reflect(void) \
+    { \
+        typedef Type Self; \
+        static const ::Hatchit::Game::TypeDescriptor descriptor(#Type, {
+
+/**
+* \brief Adds a data member of the type being reflected under the given JSON key.
+*/
+#define HT_REFLECT_FIELD(Name, Member) \
+            ::Hatchit::Game::Reflection::MakeField(Name, &Self::Member),
+
+/**
+* \brief Ends the list of reflected fields started by HT_REFLECT_BEGIN.
+*/
+#define HT_REFLECT_END() \
+        }); \
+        return descriptor; \
+    }
@@ -0,0 +1,336 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class RenderQueue
+* \ingroup HatchitGame
+*
+* \brief Collects a frame's draws and camera views, and submits only the draws a camera can see.
+*
+* While their Scene updates, Cameras add their views and MeshRenderers and LightComponents add their
+* draws, each with a world-space bounding sphere and layer flags. Scene::Render() then culls every
+* draw against the frustum of each view sharing one of its layers and submits the rest. Bounds are
+* kept in separate arrays and tested four at a time with SSE where it is available.
+*
+* Visible instances of the same batch, meaning the same mesh and material, have their world matrices
+* packed into one instance buffer and are submitted as a single instanced draw.
+*
+* Draws that survive frustum culling are then tested against a small software depth buffer, rasterized
+* on the CPU for each view from the boxes of the frame's Occluders, and dropped if something nearer covers
+* them entirely. Like frustum culling it needs no GPU, so it works headless.
+*
+* Submission order comes from a 64-bit key per visible draw packing its layer, pass, material, mesh and
+* quantized depth, radix sorted every frame. Opaque draws are grouped by material and mesh and then drawn
+* front to back; transparent draws are drawn back to front.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_noncopy.h>
+#include <ht_math.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Hatchit {
+
+    namespace Graphics {
+
+        class MeshRenderer;
+        class ShaderVariableChunk;
+    }
+
+    namespace Game {
+
+        class GameObject;
+
+        class HT_API RenderQueue : public Core::INonCopy
+        {
+        public:
+            /**
+            * \brief The pass a draw belongs to. Earlier passes are submitted first within a layer.
+            */
+            enum class Pass : uint8_t
+            {
+                OPAQUE_PASS         = 0,
+                LIGHT_PASS          = 1,
+                TRANSPARENT_PASS    = 2
+            };
+
+            static const uint32_t OcclusionWidth = 256;   /**< Width of the software depth buffer, a multiple of 4. */
+            static const uint32_t OcclusionHeight = 128;  /**< Height of the software depth buffer. */
+
+            RenderQueue(void) = default;
+            RenderQueue(RenderQueue&& rhs);
+            RenderQueue& operator=(RenderQueue&& rhs);
+            ~RenderQueue(void);
+
+            /**
+            * \brief Adds a camera's view for this frame.
+            * \param position     World-space position of the camera.
+            * \param forward      Direction the camera looks in.
+            * \param up           Up direction of the camera.
+            * \param fov          Vertical field of view, in radians.
+            * \param aspect       Width of the view divided by its height.
+            * \param nearPlane    Distance to the near clipping plane.
+            * \param farPlane     Distance to the far clipping plane.
+            * \param layers       Layer flags the camera renders.
+            */
+            void AddView(const Math::Vector3& position, const Math::Vector3& forward, const Math::Vector3& up,
+                float fov, float aspect, float nearPlane, float farPlane, uint32_t layers);
+
+            /**
+            * \brief Adds a draw for this frame.
+            * \param meshRenderer     The renderer to draw with, or nullptr when the Renderer is headless.
+            * \param instanceData     Instance data set on meshRenderer right before it renders.
+            * \param center           World-space center of the draw's bounding sphere.
+            * \param radius           Radius of the bounding sphere, 0 or less for draws that are never culled.
+            * \param layers           Layer flags of the draw.
+            * \param pass             The pass the draw belongs to.
+            */
+            void AddDraw(Graphics::MeshRenderer* meshRenderer, Graphics::ShaderVariableChunk* instanceData,
+                const Math::Vector3& center, float radius, uint32_t layers, Pass pass);
+
+            /**
+            * \brief Adds an instance of a batch for this frame, drawn along with the other visible instances of the batch.
+            * \param meshRenderer     A renderer set to the batch's mesh and material, or nullptr when the Renderer is headless.
+            * \param batch            The batch, from GetBatchId() or NewBatchId().
+            * \param instance         The instance's data, its transposed world matrix.
+            * \param center           World-space center of the instance's bounding sphere.
+            * \param radius           Radius of the bounding sphere, 0 or less for instances that are never culled.
+            * \param layers           Layer flags of the instance.
+            * \param pass             The pass the instance belongs to.
+            */
+            void AddInstance(Graphics::MeshRenderer* meshRenderer, uint64_t batch, const Math::Matrix4& instance,
+                const Math::Vector3& center, float radius, uint32_t layers, Pass pass);
+
+            /**
+            * \brief Adds a box hiding what is behind it from views sharing one of its layers, for this frame.
+            * \param corners  The eight world-space corners of the box. Corner i is on the positive side of the box's
+            *                  first, second and third axis when bit 0, 1 and 2 of i are set.
+            * \param layers   Layer flags of the occluder.
+            *
+            * The box should lie within what it stands for, such as a wall; an occluder larger than its geometry
+            * hides draws that are really visible.
+            */
+            void AddOccluder(const Math::Vector3* corners, uint32_t layers);
+
+            /**
+            * \brief Culls the draws added since the last Clear(), sorts the visible ones and submits them.
+            * \return The number of draw calls made, counting each batch once.
+            *
+            * A draw is visible if its bounds intersect the frustum of a view it shares a layer with and are not hidden
+            * behind that view's occluders. If no view was added, nothing is culled. A batch is drawn where its first instance sorts, with its instances in sorted order.
+            */
+            std::size_t Submit(void);
+
+            /**
+            * \brief Forgets every view and draw, keeping the storage for the next frame.
+            */
+            void Clear(void);
+
+            /**
+            * \brief Gets the number of draws added since the last Clear().
+            */
+            std::size_t GetDrawCount(void) const;
+
+            /**
+            * \brief Gets the number of views added since the last Clear().
+            */
+            std::size_t GetViewCount(void) const;
+
+            /**
+            * \brief Gets the number of occluders added since the last Clear().
+            */
+            std::size_t GetOccluderCount(void) const;
+
+            /**
+            * \brief Gets the factor a local bounding radius is scaled by in world space.
+            * \return The product of the largest absolute scale axis of gameObject and each of its parents.
+            */
+            static float GetBoundsScale(GameObject& gameObject);
+
+            /**
+            * \brief Gets the batch drawing a mesh with a material, the same for every call with the same files.
+            * \return The material's id in the upper 32 bits and the mesh's id in the lower 32 bits.
+            */
+            static uint64_t GetBatchId(const std::string& meshFile, const std::string& materialFile);
+
+            /**
+            * \brief Gets a batch no other call returns, for meshes and materials not loaded from known files.
+            */
+            static uint64_t NewBatchId(void);
+
+        private:
+            static const uint32_t BatchSubmission = 0x80000000u; /**< Marks an entry of m_submissions as a batch. */
+            static const uint32_t BatchBufferFrames = 120; /**< Frames an instance buffer is kept after its batch was last drawn. */
+
+            /**
+            * \brief The frustum of a camera, as six inward-facing planes (normal, distance).
+            */
+            struct View
+            {
+                float       planes[6][4];
+                float       position[3];    /**< Where depth is measured from. */
+                float       forward[3];     /**< Direction depth is measured along. */
+                float       right[3];       /**< Screen x axis. */
+                float       up[3];          /**< Screen y axis. */
+                float       tanHalfWidth;   /**< Tangent of half the horizontal field of view. */
+                float       tanHalfHeight;  /**< Tangent of half the vertical field of view. */
+                float       nearPlane;
+                float       farPlane;       /**< Depth mapped to the largest quantized depth. */
+                uint32_t    layers;
+            };
+
+            /**
+            * \brief A box hiding what is behind it.
+            */
+            struct Occluder
+            {
+                float       corners[8][3];
+                uint32_t    layers;
+            };
+
+            /**
+            * \brief What is needed to submit a draw.
+            */
+            struct Draw
+            {
+                Graphics::MeshRenderer*         meshRenderer;
+                Graphics::ShaderVariableChunk*  instanceData;   /**< Data of a single draw, nullptr for an instance of a batch. */
+                uint64_t                        batch;          /**< The batch of an instance, 0 for a single draw. */
+                uint32_t                        layers;
+                uint32_t                        instance;       /**< Index into m_instances, for an instance of a batch. */
+                Pass                            pass;
+            };
+
+            /**
+            * \brief The visible instances of a batch this frame.
+            */
+            struct Batch
+            {
+                uint64_t                id;             /**< The batch's id, combined with its pass. */
+                Graphics::MeshRenderer* meshRenderer;   /**< Renderer of the first instance added. */
+                uint32_t                count;          /**< Number of visible instances. */
+                uint32_t                first;          /**< Offset of the first instance in m_batchedInstances. */
+            };
+
+            /**
+            * \brief Instance buffer of a batch, kept between frames and only ever grown.
+            */
+            struct BatchBuffer
+            {
+                Graphics::ShaderVariableChunk*  data;
+                uint32_t                        capacity;   /**< Number of instances data holds. */
+                uint32_t                        used;       /**< Number of instances written the last time it was drawn. */
+                uint64_t                        lastFrame;  /**< Frame the batch was last drawn in. */
+            };
+
+            /**
+            * \brief Packs the sort key of a visible draw.
+            *
+            * From the most significant bit: 8 bits of layer, 2 of pass, then for opaque draws and lights 16 bits of
+            * material, 16 of mesh and 22 of depth, and for transparent draws 22 bits of inverted depth, 16 of material
+            * and 16 of mesh.
+            */
+            uint64_t MakeSortKey(std::size_t draw) const;
+
+            /**
+            * \brief Sorts m_order by m_keys with an LSD radix sort, one byte per pass.
+            *
+            * Passes over a byte every key shares are skipped, so only the bits that differ cost anything.
+            */
+            void SortByKey(void);
+
+            /**
+            * \brief Fills m_submissions in sorted order, and m_batches with the visible instances of every batch.
+            */
+            void GroupBatches(void);
+
+            /**
+            * \brief Gets an instance buffer able to hold count instances for a batch.
+            *
+            * The buffer is reallocated only when count exceeds its capacity, and then rounded up to a power of two.
+            */
+            BatchBuffer& GetBatchBuffer(uint64_t batch, uint32_t count);
+
+            /**
+            * \brief Deletes the instance buffers of batches not drawn in the last BatchBufferFrames frames.
+            */
+            void EvictBatchBuffers(void);
+
+            /**
+            * \brief Deletes every instance buffer.
+            */
+            void ReleaseBatchBuffers(void);
+
+            /**
+            * \brief Fills m_visible with whether each draw is visible to at least one view, and m_viewOf with the first such view.
+            * \return The number of draws inside a view's frustum but hidden in all of them.
+            */
+            uint32_t Cull(void);
+
+            /**
+            * \brief Rasterizes the occluders sharing a layer with a view into m_depth.
+            * \return false if the view has no occluders, leaving m_depth untouched.
+            */
+            bool RasterizeOccluders(const View& view);
+
+            /**
+            * \brief Rasterizes a screen-space triangle into m_depth, keeping the nearest depth of each pixel.
+            * \param a, b, c  Pixel x, pixel y and inverse view depth of each vertex.
+            */
+            void RasterizeTriangle(const float* a, const float* b, const float* c);
+
+            /**
+            * \brief Tests whether a draw's bounding sphere is entirely behind the depth in m_depth.
+            */
+            bool IsOccluded(const View& view, std::size_t draw) const;
+
+            /**
+            * \brief Flags the bounding spheres entirely outside a view's frustum.
+            * \param count    Number of spheres, a multiple of four.
+            * \param outside  Set to 1 for each sphere outside the frustum, 0 otherwise.
+            */
+            static void CullView(const View& view, const float* x, const float* y, const float* z, const float* radius,
+                std::size_t count, uint8_t* outside);
+
+            std::vector<View>       m_views;    /**< Views added this frame. */
+            std::vector<Draw>       m_draws;    /**< Draws added this frame. */
+            std::vector<float>      m_centerX;  /**< Bounding sphere of each draw, one array per component. */
+            std::vector<float>      m_centerY;
+            std::vector<float>      m_centerZ;
+            std::vector<float>      m_radius;
+            std::vector<uint8_t>    m_outside;  /**< Scratch space for CullView(). */
+            std::vector<uint8_t>    m_visible;  /**< Whether each draw is visible, filled by Cull(). */
+            std::vector<Occluder>   m_occluders; /**< Occluders added this frame. */
+            std::vector<float>      m_depth;    /**< Inverse view depth of the nearest occluder at each pixel, 0 where there is none. */
+            std::vector<uint32_t>   m_viewOf;   /**< Index of the first view each visible draw was found in, filled by Cull(). */
+            std::vector<uint64_t>   m_keys;     /**< Sort key of each visible draw. */
+            std::vector<uint32_t>   m_order;    /**< Index of each visible draw, sorted along with m_keys. */
+            std::vector<uint64_t>   m_keysScratch;  /**< Scratch space for SortByKey(). */
+            std::vector<uint32_t>   m_orderScratch; /**< Scratch space for SortByKey(). */
+            std::vector<uint32_t>   m_submissions;  /**< Draw indices, or batch indices with BatchSubmission set, in submission order. */
+            std::vector<Math::Matrix4>  m_instances;        /**< Data of the instances added this frame. */
+            std::vector<Batch>          m_batches;          /**< Batches with a visible instance this frame, in sorted order. */
+            std::unordered_map<uint64_t, uint32_t> m_batchIndex; /**< Index into m_batches of each batch, rebuilt every frame. */
+            std::vector<uint32_t>       m_batchedInstances; /**< Indices into m_instances, grouped by batch. */
+            std::unordered_map<uint64_t, BatchBuffer> m_batchBuffers; /**< Instance buffer of each batch drawn on a GPU. */
+            uint64_t                    m_frame = 0;        /**< Number of frames submitted. */
+        };
+    }
+}
@@ -18,16 +18,70 @@
 #include <ht_singleton.h>
 #include <ht_renderer.h>
 
+#include <cstdint>
+
 namespace Hatchit {
 
     namespace Game {
 
+        /**
+        * \brief Counts of what was submitted to the Renderer, kept whether or not it is headless.
+        */
+        struct RenderStats
+        {
+            uint64_t frames;        /**< Frames rendered. */
+            uint64_t drawCalls;     /**< Draw calls submitted. */
+            uint64_t instances;     /**< Instances drawn by those calls. */
+            uint64_t cameras;       /**< Camera registrations. */
+            uint64_t culled;        /**< Draws dropped by frustum or occlusion culling. */
+            uint64_t occluded;      /**< Of those, the draws that were in a frustum but hidden behind occluders. */
+        };
+
         class HT_API Renderer : public Core::Singleton<Renderer>
         {
         public:
 
             static bool Initialize(const Graphics::RendererParams& params);
 
+            /**
+            * \brief Initializes without a Graphics::Renderer, for servers and benchmark runs.
+            *
+            * Nothing touches a GPU: GetRenderer() returns nullptr, and Components only count what they would submit.
+            */
+            static bool InitializeHeadless();
+
+            /**
+            * \brief Returns true if the Renderer was initialized with InitializeHeadless().
+            */
+            static bool IsHeadless();
+
+            /**
+            * \brief Counts a draw call of instanceCount instances.
+            */
+            static void CountDrawCall(uint32_t instanceCount = 1);
+
+            /**
+            * \brief Counts draws that were culled instead of submitted.
+            */
+            static void CountCulled(uint32_t drawCount);
+
+            /**
+            * \brief Counts culled draws that were hidden behind occluders.
+            */
+            static void CountOccluded(uint32_t drawCount);
+
+            /**
+            * \brief Counts a camera registration.
+            */
+            static void CountCamera();
+
+            /**
+            * \brief Gets the submissions counted since initialization or the last ResetStats().
+            */
+            static const RenderStats& GetStats();
+
+            static void ResetStats();
+
             static void DeInitialize();
 
             static void Render();
@@ -44,6 +98,8 @@ namespace Hatchit {
             Graphics::Renderer*     m_renderer;
             Graphics::RendererType  m_rendererType;
             bool                    m_initialized;
+            bool                    m_headless;
+            RenderStats             m_stats;
         };
 
     }
@@ -18,9 +18,16 @@
 #include <ht_noncopy.h>
 #include <ht_guid.h>
 #include <ht_scene_resource.h>
+#include <ht_asset_prefetcher.h>
+#include <ht_guid_table.h>
+#include <ht_name_table.h>
+#include <ht_scene_arena.h>
+#include <ht_render_queue.h>
 
 #include <json.hpp>
 
+#include <cstdint>
+#include <queue>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
@@ -36,6 +43,7 @@ namespace Hatchit {
         using JSON = Core::JSON;
 
         class GameObject;
+        class Component;
         class Transform;
 
         /**
@@ -44,12 +52,20 @@ namespace Hatchit {
         class HT_API Scene : public Core::INonCopy
         {
         friend class SceneManager;
+        friend class GameObject;
+        friend class SceneBenchmark;
+        friend class SceneReclaimer;
+        friend class SceneSnapshot;
+        friend class SceneRollback;
+        friend class InterestManager;
+        friend class SceneHasher;
         public:
             
             Scene(const Scene& rhs) = default;
             Scene& operator=(const Scene& rhs) = default;
-            Scene(Scene&& rhs);
-            Scene& operator=(Scene&& rhs);
+            // GameObject containers hold allocators pointing at m_arena, so a Scene stays where it was created.
+            Scene(Scene&& rhs) = delete;
+            Scene& operator=(Scene&& rhs) = delete;
 
             /**
             * \brief Creates empty GameObject and adds it to the scene.
@@ -61,6 +77,69 @@ namespace Hatchit {
             */
             static GameObject* CreateGameObject(GameObject& prefab);
 
+            /**
+            * \brief Creates many instances of a prefab at once and adds them to the scene.
+            * \param prefab       The prefab to copy.
+            * \param count        Number of instances to create.
+            * \param transforms   Transform of each instance, count of them, or nullptr to use the prefab's.
+            * \param out          If not nullptr, the instances are appended to it.
+            * \return The number of instances created.
+            *
+            * Storage for the GameObjects and each type of Component is allocated once and Components are
+            * copied one type at a time. Like CreateGameObject(GameObject&), the instances are then queued,
+            * and are initialized, enabled and updated as the init budget allows.
+            */
+            static std::size_t Instantiate(GameObject& prefab, std::size_t count, const Transform* transforms, std::vector<GameObject*>* out = nullptr);
+
+            /**
+            * \brief Sets how many destroyed instances of a prefab this scene keeps for reuse.
+            * \param prefab     A prefab of this scene.
+            * \param capacity   The most instances to keep, 0 to stop pooling the prefab.
+            *
+            * Top-level instances of a pooled prefab are reset to the prefab's state once destroyed, rather than
+            * freed, and handed out again by CreateGameObject(GameObject&) and Instantiate(), under a new Guid
+            * and ObjectId. Instances that gained children, or whose Components no longer match the prefab's,
+            * are freed as usual. A prefab's capacity can also be set with "PoolSize" in the scene description,
+            * in which case the pool is filled when the scene loads.
+            */
+            void SetPoolSize(GameObject& prefab, std::size_t capacity);
+
+            /**
+            * \brief Fills a prefab's pool with fresh instances, up to its capacity.
+            * \param prefab     A prefab of this scene with a pool.
+            * \param count      Number of instances to add.
+            * \return The number of instances added.
+            * \sa SetPoolSize()
+            */
+            std::size_t PrewarmPool(GameObject& prefab, std::size_t count);
+
+            /**
+            * \brief Gets the number of instances of a prefab waiting in its pool.
+            */
+            std::size_t GetPooledCount(const GameObject& prefab) const;
+
+            /**
+            * \brief Creates an independent copy of this scene as it stands, without going back to its description.
+            * \return The copy. Release it with DestroyFork(), or hand it to a SceneReclaimer.
+            *
+            * Every live GameObject, prefab and queued GameObject is copied with all of its Components, keeping its
+            * Guid and ObjectId, so ids held by the caller or by Components refer to the same GameObject in the fork.
+            * Destroyed GameObjects and everything under them are left out. GameObjects are copied into one block of
+            * the fork's arena and each Component type into another, then hierarchy and owner pointers are pointed at
+            * the copies. Components of initialized GameObjects get Component::VOnForked rather than VOnInit and
+            * VOnEnabled, so a fork acquires no audio or GPU resources and plays nothing; Components that present
+            * (AudioSource, LightComponent) stay inert in it. Raw pointers a Component holds to other GameObjects
+            * are not fixed up. Pools keep their capacities but start empty.
+            *
+            * Must not be called while this scene is being updated.
+            */
+            Scene* Fork(void) const;
+
+            /**
+            * \brief Unloads and deletes a scene created by Fork().
+            */
+            static void DestroyFork(Scene* fork);
+
             /**
             * \brief Gets this scene's name.
             */
@@ -73,6 +152,49 @@ namespace Hatchit {
              */
             const Core::Guid& GUID() const;
 
+            /**
+            * \brief Finds a GameObject in this scene by its dense runtime id.
+            * \param id The ObjectId of the GameObject.
+            * \return The GameObject, or nullptr if no live GameObject has that id.
+            */
+            GameObject* FindGameObject(ObjectId id) const;
+
+            /**
+            * \brief Finds a GameObject in this scene by its Guid.
+            * \param guid The Guid of the GameObject.
+            * \return The GameObject, or nullptr if no live GameObject has that Guid.
+            *
+            * This has to go through the Guid table; prefer FindGameObject(ObjectId) at runtime.
+            */
+            GameObject* FindGameObject(const Core::Guid& guid) const;
+
+            /**
+            * \brief Gets the table mapping this scene's Guids to ObjectIds.
+            */
+            const GuidTable& Guids() const;
+
+            /**
+            * \brief Finds a live GameObject in this scene by name.
+            * \param name The name of the GameObject.
+            * \return A GameObject with that name, or nullptr if there is none.
+            *
+            * If several GameObjects share the name, which one is returned is unspecified.
+            */
+            GameObject* FindByName(const std::string& name) const;
+
+            /**
+            * \brief Finds every live GameObject in this scene with the provided name.
+            * \param name The name of the GameObjects.
+            * \param out  The GameObjects found are appended to this vector.
+            * \return The number of GameObjects found.
+            */
+            std::size_t FindAllByName(const std::string& name, std::vector<GameObject*>& out) const;
+
+            /**
+            * \brief Gets the table of names used by GameObjects in this scene.
+            */
+            const NameTable& Names() const;
+
             /**
             * \brief Attempts to load the Scene using the provided handle.
             * \param sceneHandle        A handle a resource containing the JSON representing this Scene.
@@ -81,6 +203,20 @@ namespace Hatchit {
             */
             bool LoadFromHandle(Resource::SceneHandle sceneHandle);
 
+            /**
+            * \brief Brings the live scene in line with an edited scene description, without reloading it.
+            * \param previous   The description the live scene was last loaded or patched from.
+            * \param next       The edited description.
+            * \return false if next is not a valid scene description; the scene is left untouched.
+            *
+            * GameObjects are matched by Guid. Matched GameObjects keep their runtime state; only their name,
+            * parent, Transform and Components whose JSON differs between the two descriptions are patched, the
+            * latter through VDeserialize in place. GameObjects new to next are created and initialized, those
+            * described by previous but missing from next are destroyed. GameObjects spawned at runtime are
+            * described by neither and are left alone. Prefabs whose JSON changed are replaced.
+            */
+            bool Patch(const JSON& previous, const JSON& next);
+
             /**
              * \brief Renders this scene.
              */
@@ -88,14 +224,47 @@ namespace Hatchit {
             
             /**
              * \brief Updates this scene.
+             *
+             * The scene is the target of CreateGameObject() and Instantiate() for the duration, so a fork
+             * spawns into itself.
              */
             void Update(void);
 
             /**
              * \brief Unloads this scene and its game objects.
+             *
+             * Every GameObject and most Components live in the scene's arena. Only Components whose
+             * teardown releases something have their destructors run; the arena is then freed in one step.
              */
             void Unload(void);
 
+            /**
+            * \brief Sets how long each Update() may spend initializing newly loaded or spawned GameObjects.
+            * \param microseconds   The per-frame budget, 0 to initialize everything as soon as it is queued.
+            *
+            * GameObjects wait in a queue, highest "InitPriority" first, until they are initialized and enabled,
+            * and only then join the scene's update list. At least one GameObject is initialized per frame,
+            * so a top-level GameObject with a large hierarchy may exceed the budget on its own.
+            */
+            void SetInitBudget(uint32_t microseconds);
+
+            /**
+            * \brief Gets the per-frame initialization budget in microseconds, 0 if unlimited.
+            */
+            uint32_t GetInitBudget(void) const;
+
+            /**
+            * \brief Gets the number of top-level GameObjects still waiting to be initialized.
+            */
+            std::size_t GetPendingInitCount(void) const;
+
+            /**
+            * \brief Gets the queue Components add this frame's views and draws to while the scene updates.
+            *
+            * The queue is cleared at the start of Update() and culled and submitted by Render().
+            */
+            RenderQueue& GetRenderQueue(void);
+
         private:
 
             static Scene* instance;
@@ -104,7 +273,8 @@ namespace Hatchit {
             virtual ~Scene(void) = default;
 
             /**
-            * \brief Initializes GameObjects in scene
+            * \brief Queues the GameObjects in scene for initialization, and initializes as many as the budget allows.
+            * \sa SetInitBudget()
             */
             void Init(void);
 
@@ -116,6 +286,37 @@ namespace Hatchit {
             */
             bool ParseScene(const JSON& obj);
 
+            /**
+            * \brief Reads the scene header and constructs every GameObject listed in the scene description.
+            * \param obj            The JSON representation of the Scene.
+            * \param id_to_json     Filled with the JSON object of each GameObject, indexed by ObjectId.
+            * \return true if every GameObject could be constructed, false otherwise.
+            * \sa ParseScene(), LinkGameObjects()
+            */
+            bool InstantiateGameObjects(const JSON& obj, std::vector<const JSON*>& id_to_json);
+
+            /**
+            * \brief Parents the GameObjects constructed by InstantiateGameObjects() and collects the top-level ones.
+            * \param id_to_json     The JSON object of each GameObject, indexed by ObjectId.
+            * \sa ParseScene(), ParseChildGameObjects()
+            */
+            void LinkGameObjects(const std::vector<const JSON*>& id_to_json);
+
+            /**
+            * \brief Constructs every Prefab listed in the scene description.
+            * \param obj            The JSON representation of the Scene.
+            * \param id_to_json     The JSON object of each GameObject, indexed by ObjectId.
+            * \return true if the Prefabs could be parsed, or there were none.
+            */
+            bool ParsePrefabs(const JSON& obj, const std::vector<const JSON*>& id_to_json);
+
+            /**
+            * \brief Sizes and fills a prefab's pool from its (optional) "PoolSize" property.
+            * \param obj            The JSON object the prefab was parsed from.
+            * \param prefab         The registered prefab.
+            */
+            void ConfigurePool(const JSON& obj, GameObject& prefab);
+
             /**
             * \brief Attempts to parse a GameObject from the provided JSON.
             * \param obj    The JSON object to parse.
@@ -126,13 +327,13 @@ namespace Hatchit {
             bool ParseGameObject(const JSON& obj, GameObject*& out);
 
             /**
-            * \brief Establishes the (optional) parent of the GameObject with the provided Guid.
-            * \param id                 Guid of the potential child GameObject.
-            * \param guid_to_obj        Mapping of Guids to GameObject pointers.
-            * \param guid_to_json       Mapping of Guids to JSON objects.
+            * \brief Establishes the (optional) parent of the GameObject with the provided ObjectId.
+            * \param id                 ObjectId of the potential child GameObject.
+            * \param id_to_json         Mapping of ObjectIds to JSON objects.
+            * \param is_child           Set to true for id if the GameObject was parented.
             * \sa ParseGameObject(), ParseTransform(), ParseComponent, LoadFromCache(), GameObject()
             */
-            void ParseChildGameObjects(const Core::Guid& id, std::unordered_map<Core::Guid, GameObject*>& guid_to_obj, std::unordered_map<Core::Guid, JSON>& guid_to_json);
+            void ParseChildGameObjects(ObjectId id, const std::vector<const JSON*>& id_to_json, std::vector<bool>& is_child);
 
             /**
             * \brief Attempts to parse a Transform from the provided JSON.
@@ -156,10 +357,192 @@ namespace Hatchit {
             */
             bool ParseComponent(const JSON& obj, GameObject& out);
 
+            /**
+            * \brief Assigns a GameObject its ObjectId and makes it findable in this scene.
+            * \param gameObject The GameObject to register. Its Guid is interned if it has not been seen before.
+            * \param findByName Whether the GameObject should be returned by FindByName(). false for Prefabs.
+            */
+            void RegisterGameObject(GameObject* gameObject, bool findByName = true);
+
+            /**
+            * \brief Removes a GameObject from the ObjectId and Guid lookups and frees its ObjectId for reuse. Called when the GameObject is deleted or pooled.
+            */
+            void UnregisterGameObject(GameObject* gameObject);
+
+            /**
+            * \brief Removes a GameObject from the name lookup. Does nothing if it is not present.
+            */
+            void RemoveFromNameIndex(GameObject* gameObject);
+
+            /**
+            * \brief Patches a live GameObject's name, Transform and Components. Used by Patch().
+            * \param gameObject     The GameObject to patch.
+            * \param previous       Its JSON in the previous description, or nullptr if it had none.
+            * \param next           Its JSON in the edited description.
+            */
+            void PatchGameObject(GameObject& gameObject, const JSON* previous, const JSON& next);
+
+            /**
+            * \brief Replaces, adds and removes Prefabs to match an edited description. Used by Patch().
+            */
+            void PatchPrefabs(const JSON& previous, const JSON& next);
+
+            /**
+            * \brief Lists every live GameObject, including ones waiting to be initialized, so that every parent precedes its children.
+            * \param objects   Cleared and filled with the GameObjects: the update list and its descendants first, then the init queue
+            *                  ordered by Guid, so the order does not depend on the ObjectIds they were given.
+            * \param parents   Cleared and filled with the index in objects of each GameObject's parent, UINT32_MAX for top-level ones.
+            * \param visited   Scratch space, kept by the caller so repeated calls do not allocate.
+            */
+            void CollectLiveGameObjects(std::vector<GameObject*>& objects, std::vector<uint32_t>& parents, std::vector<bool>& visited) const;
+
+            /**
+            * \brief Appends gameObject and its live descendants to objects. Used by CollectLiveGameObjects().
+            */
+            static void CollectHierarchy(GameObject& gameObject, uint32_t parent, std::vector<GameObject*>& objects,
+                std::vector<uint32_t>& parents, std::vector<bool>& visited);
+
+            /**
+            * \brief Destroys every Component flagged ComponentRegistry::MAIN_THREAD_TEARDOWN.
+            *
+            * Called on the main thread before the scene is handed to a SceneReclaimer; Components of live,
+            * initialized GameObjects get VOnDestroy first. Prefab Components and those of GameObjects still
+            * waiting to be initialized are destroyed without it. Prefetched asset handles are released here too.
+            */
+            void DestroyMainThreadComponents(void);
+
+            /**
+            * \brief Destroys a GameObject created by this scene.
+            *
+            * Its memory stays with the arena until the scene unloads.
+            */
+            void DestroyGameObject(GameObject* gameObject);
+
+            /**
+            * \brief Builds a Component that cannot be restored from binary again, from the prefab or the description its GameObject came from.
+            * \param prefab   The prefab the GameObject was instantiated from, or nullptr.
+            * \param guid     Guid of the GameObject, looked up in the scene description when there is no prefab.
+            * \param type     Name of the Component type.
+            * \return The Component, uninitialized, or nullptr if neither has a Component of that type.
+            */
+            Component* RebuildComponent(const GameObject* prefab, const Core::Guid& guid, const std::string& type);
+
+            /**
+            * \brief Checks that RebuildComponent() has a prefab or description to build a Component from.
+            */
+            bool CanRebuildComponent(const GameObject* prefab, const Core::Guid& guid, const std::string& type) const;
+
+            /**
+            * \brief Finds a prefab's Component of the named type. Used by RebuildComponent().
+            */
+            static const Component* FindPrefabComponent(const GameObject* prefab, const std::string& type);
+
+            /**
+            * \brief Finds the JSON of a Component in the scene description by the Guid of its GameObject. Used by RebuildComponent().
+            */
+            const JSON* FindDescribedComponent(const Core::Guid& guid, const std::string& type) const;
+
+            /**
+            * \brief Destroys a Component, freeing it only if it was not allocated from the arena.
+            */
+            void DestroyComponent(Component* component);
+
+            /**
+            * \brief Constructs a Component of the registered type in the arena.
+            * \return The Component, or nullptr if no such type is registered.
+            */
+            Component* NewComponent(const char* type, std::size_t length);
+
+            /**
+            * \brief Copies a Component into the arena. Falls back to VClone() for unregistered types.
+            */
+            Component* CloneComponent(const Component& component);
+
+            /**
+            * \brief Copies a prefab and its Components into the arena, count at a time, without registering the copies.
+            * \param out    Receives the count copies.
+            */
+            void CopyPrefab(GameObject& prefab, std::size_t count, GameObject** out);
+
+            /**
+            * \brief Takes an instance of a prefab from its pool and registers it under a new Guid.
+            * \return The instance, or nullptr if the pool is empty.
+            */
+            GameObject* TakeFromPool(GameObject& prefab);
+
+            /**
+            * \brief Resets a destroyed top-level GameObject to its prefab's state and keeps it in the prefab's pool.
+            * \return false if the GameObject cannot be pooled; the caller destroys it instead.
+            */
+            bool ReleaseToPool(GameObject* gameObject);
+
+            /**
+            * \brief Copies a prefab's name, Transform and Component state back into an instance of it, in place.
+            * \return false, leaving the instance untouched, if its Components no longer match the prefab's.
+            */
+            bool ResetToPrefab(GameObject& gameObject, const GameObject& prefab);
+
+            /**
+            * \brief Destroys every pooled instance and forgets every pool.
+            */
+            void ClearPools(void);
+
+            /**
+            * \brief Queues a top-level GameObject to be initialized and enabled by ProcessInitQueue().
+            */
+            void QueueInit(GameObject* gameObject);
+
+            /**
+            * \brief Initializes and enables queued GameObjects until the queue is empty or the budget is spent.
+            *
+            * Initialized GameObjects are added to the update list.
+            */
+            void ProcessInitQueue(void);
+
+            /**
+            * \brief A GameObject waiting to be initialized.
+            */
+            struct PendingInit
+            {
+                int32_t     priority;   /**< Higher priorities are initialized first. */
+                uint64_t    sequence;   /**< Queue order, breaking ties between equal priorities. */
+                GameObject* gameObject;
+
+                bool operator<(const PendingInit& rhs) const
+                {
+                    // std::priority_queue pops the largest element; among equal priorities that is the earliest queued.
+                    if (priority != rhs.priority)
+                        return priority < rhs.priority;
+                    return sequence > rhs.sequence;
+                }
+            };
+
+            /**
+            * \brief Destroyed instances of a prefab kept for reuse.
+            */
+            struct PrefabPool
+            {
+                GameObject*                 prefab;     /**< The prefab the instances are reset to. */
+                std::size_t                 capacity;   /**< The most instances kept. */
+                std::vector<GameObject*>    free;       /**< Instances ready to be handed out, unregistered. */
+            };
+
             std::string m_name; /**< The name associated with this scene. */
+            Resource::SceneHandle m_description; /**< The description the scene was loaded from, kept to rebuild Components that have no binary state. */
             Core::Guid m_guid; /**< The Guid associated with this scene. */
             std::vector<GameObject*> m_gameObjects; /**< std::vector of GameObjects present in the scene. */
             std::vector<GameObject*> m_prefabs;
+            GuidTable m_guidTable; /**< Interned Guids of every GameObject loaded into or created in this scene. */
+            std::vector<GameObject*> m_objectsById; /**< Live GameObjects indexed by ObjectId, nullptr once deleted. */
+            NameTable m_names; /**< Interned names of every GameObject loaded into or created in this scene. */
+            std::unordered_multimap<NameId, GameObject*> m_nameIndex; /**< Live GameObjects by name. */
+            AssetPrefetcher m_prefetcher; /**< Holds assets referenced by the scene description resident until every GameObject is initialized. */
+            std::priority_queue<PendingInit> m_initQueue; /**< Top-level GameObjects waiting to be initialized. */
+            uint64_t m_initSequence{ 0 }; /**< Sequence number given to the next queued GameObject. */
+            uint32_t m_initBudget{ 0 }; /**< Microseconds per frame spent initializing GameObjects, 0 if unlimited. */
+            std::unordered_map<ObjectId, PrefabPool> m_pools; /**< Recycled prefab instances, by the prefab's ObjectId. */
+            RenderQueue m_renderQueue; /**< Views and draws added by Components during the last Update(). */
+            SceneArena m_arena; /**< Memory of every GameObject created in this scene and the Components it parses or clones. */
         };
     }
 }
@@ -0,0 +1,182 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class SceneArena
+* \ingroup HatchitGame
+*
+* \brief Chunked bump allocator owning the memory of a Scene's GameObjects and Components.
+*
+* Allocation advances a pointer within the current chunk. Blocks given back with Free() are kept
+* on a free list per size and handed out again before the cursor moves, so objects spawned and
+* destroyed at runtime do not grow the arena. The whole arena is released at once when its Scene
+* unloads, so tearing down a scene costs one free per chunk rather than one per object.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_noncopy.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class HT_API SceneArena : public Core::INonCopy
+        {
+        public:
+            static const std::size_t DefaultChunkSize = 256 * 1024; /**< Size of each chunk unless a larger allocation needs more. */
+
+            explicit SceneArena(std::size_t chunkSize = DefaultChunkSize);
+            SceneArena(SceneArena&& rhs);
+            SceneArena& operator=(SceneArena&& rhs);
+            ~SceneArena(void);
+
+            /**
+            * \brief Allocates uninitialized memory.
+            * \param size   Number of bytes.
+            * \param align  Required alignment, a power of two.
+            */
+            void* Allocate(std::size_t size, std::size_t align);
+
+            /**
+            * \brief Gives a block back to be reused by a later allocation of the same size.
+            *
+            * The block may be a single element of a larger allocation. Blocks too small or too
+            * loosely aligned to hold a free list link are left alone until Release().
+            * \param pointer  Start of the block, as returned by Allocate() or within an array it returned.
+            * \param size     Size of the block in bytes.
+            */
+            void Free(void* pointer, std::size_t size);
+
+            /**
+            * \brief Allocates and constructs an object of type T.
+            *
+            * The object's destructor is not run by the arena; call it explicitly before Release() if it owns resources.
+            */
+            template <typename T, typename... Args>
+            T* New(Args&&... args);
+
+            /**
+            * \brief Returns whether a pointer lies within memory handed out by this arena.
+            */
+            bool Owns(const void* pointer) const;
+
+            /**
+            * \brief Frees every chunk at once. All memory handed out becomes invalid.
+            */
+            void Release(void);
+
+            /**
+            * \brief Returns the number of bytes handed out and not freed since the last Release().
+            */
+            std::size_t BytesUsed(void) const;
+
+            /**
+            * \brief Returns the number of bytes held in chunks.
+            */
+            std::size_t BytesReserved(void) const;
+
+        private:
+            struct Chunk
+            {
+                uint8_t*    begin;
+                uint8_t*    end;
+            };
+
+            struct FreeBlock
+            {
+                FreeBlock*  next;
+            };
+
+            /**
+            * \brief Starts a new chunk able to hold at least size bytes at the given alignment.
+            */
+            void Grow(std::size_t size, std::size_t align);
+
+            std::size_t         m_chunkSize;    /**< Size of a regular chunk. */
+            std::vector<Chunk>  m_chunks;       /**< Every chunk, sorted by address so Owns() can binary search. */
+            std::unordered_map<std::size_t, FreeBlock*> m_freeLists; /**< Freed blocks by size. */
+            uint8_t*            m_cursor;       /**< Next free byte in the current chunk. */
+            uint8_t*            m_limit;        /**< End of the current chunk. */
+            std::size_t         m_used;         /**< Bytes handed out. */
+            std::size_t         m_reserved;     /**< Bytes held in chunks. */
+        };
+
+        template <typename T, typename... Args>
+        T* SceneArena::New(Args&&... args)
+        {
+            return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        /**
+        * \brief Standard allocator drawing from a SceneArena.
+        *
+        * Deallocation returns the block to the arena's free lists. An allocator without an arena
+        * falls back to the global heap, so containers can be default constructed.
+        */
+        template <typename T>
+        class ArenaAllocator
+        {
+        public:
+            typedef T value_type;
+
+            ArenaAllocator(void) : m_arena(nullptr) {}
+            explicit ArenaAllocator(SceneArena* arena) : m_arena(arena) {}
+
+            template <typename U>
+            ArenaAllocator(const ArenaAllocator<U>& rhs) : m_arena(rhs.GetArena()) {}
+
+            T* allocate(std::size_t count)
+            {
+                if (m_arena == nullptr)
+                    return static_cast<T*>(::operator new(count * sizeof(T)));
+
+                return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T)));
+            }
+
+            void deallocate(T* pointer, std::size_t count)
+            {
+                if (m_arena == nullptr)
+                    ::operator delete(pointer);
+                else
+                    m_arena->Free(pointer, count * sizeof(T));
+            }
+
+            SceneArena* GetArena(void) const { return m_arena; }
+
+        private:
+            SceneArena* m_arena;
+        };
+
+        template <typename T, typename U>
+        bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+        {
+            return lhs.GetArena() == rhs.GetArena();
+        }
+
+        template <typename T, typename U>
+        bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+        {
+            return lhs.GetArena() != rhs.GetArena();
+        }
+    }
+}
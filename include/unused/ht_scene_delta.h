@@ -0,0 +1,82 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class SceneDelta
+* \ingroup HatchitGame
+*
+* \brief Encodes the difference between two SceneStates compactly, and applies it.
+*
+* Meant for replicating a Scene to observers, such as spectator processes, without
+* sending its full state every frame. GameObjects are keyed by their dense ObjectId.
+* A delta lists the GameObjects destroyed and created since the previous state, and for
+* every other GameObject only the properties that changed: parent, flags, name, the
+* Transform channels that moved, and the bytes of Component state that differ.
+*
+* Transforms are quantized to fixed steps (1/1024 for position, 1/4096 for rotation and
+* scale) and sent as differences of whole steps. The sender therefore tracks the state the
+* receiver holds rather than the exact state it captured, which Encode() does in place:
+*
+*     SceneState sent, current;
+*     // every frame
+*     SceneSnapshot::Capture(scene, current);
+*     SceneDelta::Encode(sent, current, bytes);    // sent now matches the receiver
+*
+*     // on the receiver, starting from an empty SceneState
+*     SceneDelta::Apply(received, bytes.data(), bytes.size());
+*     SceneSnapshot::Restore(mirror, received);
+*
+* Deltas must be applied in the order they were encoded.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_scene_snapshot.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class HT_API SceneDelta
+        {
+        public:
+            /**
+            * \brief Encodes the changes from baseline to next.
+            * \param baseline   The state the receiver holds, or an empty SceneState for the first delta.
+            *                   Updated to the state the receiver holds once it applies the delta.
+            * \param next       The state to send, normally just captured with SceneSnapshot::Capture.
+            * \param out        Cleared and filled with the delta.
+            */
+            static void Encode(SceneState& baseline, const SceneState& next, std::vector<uint8_t>& out);
+
+            /**
+            * \brief Applies a delta written by Encode().
+            * \param state  The state the delta was encoded against. Updated to the state it encodes.
+            * \param data   The delta.
+            * \param size   The size of the delta in bytes.
+            * \return false if the delta is malformed or was not encoded against state; state is left untouched.
+            */
+            static bool Apply(SceneState& state, const uint8_t* data, std::size_t size);
+
+            /**
+            * \brief Applies a delta written by Encode().
+            */
+            static bool Apply(SceneState& state, const std::vector<uint8_t>& data);
+        };
+    }
+}
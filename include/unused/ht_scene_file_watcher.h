@@ -0,0 +1,102 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class SceneFileWatcher
+* \ingroup HatchitGame
+*
+* \brief Reports when a scene file changes on disk.
+*
+* The file's modification time and size are polled, at most once per interval, from whichever
+* thread calls Poll(); no OS notification API is required. A change keeps being reported until
+* it is acknowledged, so a file caught half written is read again.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class HT_API SceneFileWatcher
+        {
+        public:
+            SceneFileWatcher(void);
+
+            /**
+            * \brief Starts watching a file, forgetting any file watched before.
+            * \param path   Path to the file.
+            */
+            void Watch(const std::string& path);
+
+            /**
+            * \brief Stops watching.
+            */
+            void Clear(void);
+
+            /**
+            * \brief Checks whether the watched file changed since the last acknowledged change.
+            * \return true until Acknowledge() is called. false while nothing is watched or the interval has not elapsed.
+            */
+            bool Poll(void);
+
+            /**
+            * \brief Marks the change last reported by Poll() as handled.
+            */
+            void Acknowledge(void);
+
+            /**
+            * \brief Sets the minimum time between two checks of the file.
+            */
+            void SetInterval(uint32_t milliseconds);
+
+            /**
+            * \brief Returns the path of the watched file, empty if nothing is watched.
+            */
+            const std::string& GetPath(void) const;
+
+        private:
+            /**
+            * \brief Modification time, in nanoseconds, and size of a file.
+            */
+            struct Stamp
+            {
+                int64_t modified;
+                int64_t size;
+
+                bool operator==(const Stamp& other) const;
+            };
+
+            /**
+            * \brief Reads a file's modification time and size.
+            * \return false if the file could not be found.
+            */
+            static bool ReadStamp(const std::string& path, Stamp& out);
+
+            typedef std::chrono::steady_clock Clock;
+
+            std::string         m_path;         /**< The watched file. */
+            Stamp               m_modified;     /**< Stamp of the last acknowledged change. */
+            Stamp               m_reported;     /**< Stamp last reported by Poll(). */
+            Clock::duration     m_interval;     /**< Minimum time between two checks. */
+            Clock::time_point   m_nextCheck;    /**< Earliest time of the next check. */
+        };
+    }
+}
@@ -0,0 +1,125 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class SceneHasher
+* \ingroup HatchitGame
+*
+* \brief Hashes the simulation state of a Scene, per GameObject and per subtree.
+*
+* The hash of a GameObject covers its ObjectId, parent, enabled and initialized flags,
+* local Transform, and for each Component its type, enabled state and reflected fields.
+* Components flagged ComponentRegistry::NO_ROLLBACK are presentation only and left out,
+* as are the unreflected fields of other Components. The hash of a subtree combines the
+* hash of its root with the subtree hashes of its children in order, and the Scene hash
+* combines the subtree hashes of the top-level GameObjects.
+*
+* Two runs that should be identical, such as replays or peers in lockstep, compare Scene
+* hashes every frame. When they differ, FindMismatches() descends only into subtrees whose
+* hashes differ to find the GameObjects that diverged. Write() and Read() carry the hashes
+* of one machine to another for that comparison.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_guid_table.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class Scene;
+        class GameObject;
+
+        class HT_API SceneHasher
+        {
+        public:
+            SceneHasher(void);
+
+            /**
+            * \brief Hashes the current state of a Scene.
+            * \return The Scene hash.
+            */
+            uint64_t Update(const Scene& scene);
+
+            /**
+            * \brief Returns the Scene hash as of the last Update() or Read().
+            */
+            uint64_t GetSceneHash(void) const;
+
+            /**
+            * \brief Returns the number of GameObjects hashed.
+            */
+            std::size_t GetObjectCount(void) const;
+
+            /**
+            * \brief Returns the hash of the state of a single GameObject, or 0 if it was not hashed.
+            */
+            uint64_t GetObjectHash(ObjectId id) const;
+
+            /**
+            * \brief Returns the hash of a GameObject and all of its descendants, or 0 if it was not hashed.
+            */
+            uint64_t GetSubtreeHash(ObjectId id) const;
+
+            /**
+            * \brief Lists the GameObjects whose state differs from another hasher's.
+            * \param other  Hashes of the run to compare against.
+            * \param out    Cleared and filled with the ObjectIds of GameObjects whose own hash differs, and of
+            *               the topmost GameObjects present in only one of the hashers.
+            * \return The number of GameObjects listed.
+            *
+            * Subtrees with matching hashes are skipped whole, so only the path to each difference is visited.
+            */
+            std::size_t FindMismatches(const SceneHasher& other, std::vector<ObjectId>& out) const;
+
+            /**
+            * \brief Serializes the hashes of the last Update().
+            * \param out    Cleared and filled with the hashes.
+            */
+            void Write(std::vector<uint8_t>& out) const;
+
+            /**
+            * \brief Loads hashes written by Write(), typically on another machine.
+            * \return false if the data is malformed; the hasher is left empty.
+            */
+            bool Read(const uint8_t* data, std::size_t size);
+
+        private:
+            /**
+            * \brief Returns the index of a GameObject in the hashed columns, or UINT32_MAX.
+            */
+            uint32_t IndexOf(ObjectId id) const;
+
+            /**
+            * \brief Rebuilds m_index from m_ids.
+            */
+            void BuildIndex(void);
+
+            std::vector<GameObject*> m_objects; /**< Scratch space for Scene::CollectLiveGameObjects. */
+            std::vector<bool>       m_visited;  /**< Scratch space for Scene::CollectLiveGameObjects. */
+
+            std::vector<ObjectId>   m_ids;          /**< Hashed GameObjects, every parent before its children. */
+            std::vector<uint32_t>   m_parents;      /**< Index of the parent of each GameObject, UINT32_MAX for top-level ones. */
+            std::vector<uint64_t>   m_objectHashes;
+            std::vector<uint64_t>   m_subtreeHashes;
+            std::vector<uint32_t>   m_index;        /**< ObjectId to index in the columns, UINT32_MAX if not hashed. */
+            uint64_t                m_sceneHash;
+        };
+    }
+}
@@ -0,0 +1,85 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class SceneReclaimer
+* \ingroup HatchitGame
+*
+* \brief Destroys outgoing Scenes on a background thread.
+*
+* Reclaim() detaches a Scene on the calling (main) thread, destroying only the Components
+* flagged ComponentRegistry::MAIN_THREAD_TEARDOWN, and queues the rest of the Scene for a
+* worker thread. The worker runs the remaining VOnDestroy calls and destructors and frees
+* the Scene's arena, off the critical path of the next scene load.
+*
+* VOnDestroy of a Component without the flag may therefore run on the worker thread while the
+* next Scene is loading, and must not touch Scene::instance, the renderer or the audio device.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_noncopy.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class Scene;
+
+        class HT_API SceneReclaimer : public Core::INonCopy
+        {
+        public:
+            SceneReclaimer(void);
+            ~SceneReclaimer(void);
+
+            /**
+            * \brief Takes ownership of a Scene and destroys it in the background.
+            * \param scene  The Scene to destroy. It must no longer be Scene::instance.
+            *
+            * Must be called from the main thread. Starts the worker thread if it is not running.
+            */
+            void Reclaim(Scene* scene);
+
+            /**
+            * \brief Blocks until every queued Scene has been destroyed.
+            */
+            void Flush(void);
+
+            /**
+            * \brief Destroys every queued Scene and stops the worker thread.
+            */
+            void Stop(void);
+
+        private:
+            /**
+            * \brief Body of the worker thread.
+            */
+            void Run(void);
+
+            std::thread              m_thread;   /**< The worker, started on the first Reclaim(). */
+            std::mutex               m_mutex;    /**< Guards every member below. */
+            std::condition_variable  m_wake;     /**< Signalled when a Scene is queued or the worker should stop. */
+            std::condition_variable  m_idle;     /**< Signalled when the queue has drained. */
+            std::deque<Scene*>       m_queue;    /**< Scenes waiting to be destroyed. */
+            bool                     m_busy;     /**< Whether the worker is destroying a Scene. */
+            bool                     m_stopping; /**< Whether the worker should exit once the queue is empty. */
+        };
+    }
+}
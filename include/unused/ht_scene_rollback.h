@@ -0,0 +1,178 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class SceneRollback
+* \ingroup HatchitGame
+*
+* \brief Ring buffer of the simulation state of the last few frames of a Scene.
+*
+* Save() records, for every live GameObject, its enabled flag and Transform and the
+* binary state of each of its Components, in flat columns that are reused from one
+* save to the next, so saving does not allocate once the buffer has warmed up.
+* Restore() writes a saved frame back into the same GameObjects and Components.
+*
+* Frames also record the clock they ran at. Resimulate() restores a frame and runs
+* the scene forward again under those times, which makes re-simulation reproduce the
+* original frames exactly when fed the same inputs.
+*
+* When GameObjects were created, destroyed, reparented, or gained or lost Components
+* since a frame was saved, restoring it falls back to a full SceneSnapshot, which is
+* kept in the buffer each time the structure of the scene changes.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class Scene;
+        class GameObject;
+        class Component;
+
+        class HT_API SceneRollback
+        {
+        public:
+            /**
+            * \brief Creates a rollback buffer.
+            * \param capacity   The number of frames kept.
+            */
+            explicit SceneRollback(std::size_t capacity = 8);
+
+            /**
+            * \brief Changes the number of frames kept. Discards every saved frame.
+            */
+            void SetCapacity(std::size_t capacity);
+
+            /**
+            * \brief Returns the number of frames kept.
+            */
+            std::size_t GetCapacity(void) const;
+
+            /**
+            * \brief Returns the number of frames currently saved.
+            */
+            std::size_t Size(void) const;
+
+            /**
+            * \brief Returns true if the state at the start of frame is saved.
+            */
+            bool Contains(uint32_t frame) const;
+
+            /**
+            * \brief Returns the oldest saved frame. Only valid while Size() is not 0.
+            */
+            uint32_t GetOldestFrame(void) const;
+
+            /**
+            * \brief Returns the newest saved frame. Only valid while Size() is not 0.
+            */
+            uint32_t GetNewestFrame(void) const;
+
+            /**
+            * \brief Records the state of scene at the start of frame, before it is updated.
+            *
+            * Frames must be saved in increasing order. Saving a frame at or before the newest
+            * saved frame discards that frame and every frame after it, as they no longer happened.
+            * The oldest frame is dropped once the buffer is full.
+            */
+            void Save(const Scene& scene, uint32_t frame);
+
+            /**
+            * \brief Brings scene back to the state saved for frame.
+            * \return false if frame is not saved, or its structure could not be restored; the scene is then left as it was.
+            */
+            bool Restore(Scene& scene, uint32_t frame);
+
+            /**
+            * \brief Restores fromFrame and updates the scene up to the start of toFrame again.
+            * \param scene          The scene to re-simulate.
+            * \param fromFrame      The saved frame to start from.
+            * \param toFrame        The frame to stop at. Every frame in between must be saved.
+            * \param beforeUpdate   Called with each frame number before the scene is updated, to apply that frame's input.
+            * \return false if a frame in the range is not saved; the scene is left untouched.
+            *
+            * Each frame is updated with Time reporting the times it originally ran at, and is saved again
+            * before it is updated, replacing the frames that were rolled back. The scene's init budget is
+            * lifted meanwhile, since how much it covers depends on the wall clock rather than the frame.
+            */
+            bool Resimulate(Scene& scene, uint32_t fromFrame, uint32_t toFrame, const std::function<void(uint32_t)>& beforeUpdate = nullptr);
+
+            /**
+            * \brief Discards every saved frame, keeping the memory for reuse.
+            */
+            void Clear(void);
+
+        private:
+            /**
+            * \brief The saved state of one frame. Vectors keep their capacity between saves.
+            */
+            struct Frame
+            {
+                uint32_t                    frame;
+                float                       totalTime;          /**< Time::TotalTime() when the frame was saved. */
+                float                       deltaTime;          /**< Time::DeltaTime() when the frame was saved. */
+                uint64_t                    structure;          /**< Hash of the Guids, parents and Component types saved. */
+                std::vector<GameObject*>    objects;            /**< Live GameObjects in Scene::CollectLiveGameObjects() order. */
+                std::vector<uint8_t>        enabled;            /**< GameObject enabled flags. */
+                std::vector<float>          transforms;         /**< Position, rotation and scale, 9 floats per GameObject. */
+                std::vector<Component*>     components;         /**< Saved Components, GameObject by GameObject and by type within each. */
+                std::vector<uint8_t>        componentEnabled;   /**< Component enabled flags. */
+                std::vector<uint32_t>       componentOffsets;   /**< Start of each Component's state in state, plus the end. */
+                std::vector<uint8_t>        state;              /**< Concatenated Component::VWriteBinary output. */
+                std::vector<uint8_t>        snapshot;           /**< Full SceneSnapshot, only kept when the structure changed. */
+            };
+
+            /**
+            * \brief Returns the position of a saved frame counting from the oldest, or m_count if it is not saved.
+            */
+            std::size_t IndexOf(uint32_t frame) const;
+
+            /**
+            * \brief Returns the slot of the i-th saved frame, oldest first.
+            */
+            std::size_t SlotOf(std::size_t i) const;
+
+            /**
+            * \brief Lists the live GameObjects and rollback Components of scene into the scratch vectors.
+            * \return Hash of the structure found.
+            */
+            uint64_t CollectScene(const Scene& scene);
+
+            /**
+            * \brief Writes the state of a frame into the GameObjects and Components in the scratch vectors.
+            */
+            void ApplyFrame(const Frame& frame);
+
+            std::vector<Frame>          m_frames;   /**< Ring of frames, m_count of them saved. */
+            std::size_t                 m_oldest;   /**< Slot of the oldest saved frame. */
+            std::size_t                 m_count;    /**< Number of saved frames. */
+
+            std::vector<GameObject*>    m_objects;      /**< Scratch: live GameObjects. */
+            std::vector<uint32_t>       m_parents;      /**< Scratch: parent index of each live GameObject. */
+            std::vector<bool>           m_visited;      /**< Scratch: used by Scene::CollectLiveGameObjects(). */
+            std::vector<Component*>     m_components;   /**< Scratch: Components of the live GameObjects, in order. */
+            std::vector<std::pair<float, float>> m_times;   /**< Scratch: clock of each re-simulated frame. */
+            std::vector<uint8_t>        m_undo;         /**< Scratch: the scene before a snapshot was restored, in case the result is wrong. */
+        };
+    }
+}
@@ -0,0 +1,170 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class SceneSnapshot
+* \ingroup HatchitGame
+*
+* \brief Captures the runtime state of a Scene to a compact binary blob and restores it.
+*
+* A snapshot holds every live GameObject in hierarchy order: its Guid, prefab, name, parent,
+* enabled and initialized flags, Transform, and the binary state of each Component as
+* written by Component::VWriteBinary. Data is laid out in columns, one per property, so
+* capture and restore are straight loops over flat arrays rather than a JSON walk.
+*
+* Restoring matches GameObjects by Guid. Matched GameObjects and Components are updated
+* in place; GameObjects and Components missing from the scene are created, and live
+* GameObjects absent from the snapshot are destroyed. Prefabs are not captured.
+* Components whose type is not reflected only have their enabled state restored; when
+* missing, they are copied from the GameObject's prefab or deserialized from the scene
+* description again.
+*
+* The same state is also available unserialized as a SceneState, which is what a
+* SceneDelta is computed between.
+*/
+
+#pragma once
+
+#include <ht_platform.h>
+#include <ht_guid.h>
+#include <ht_guid_table.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class Scene;
+
+        /**
+        * \brief The runtime state of a Scene, laid out in columns.
+        *
+        * GameObjects are listed so that every parent precedes its children. The Components of
+        * GameObject i are the componentCounts[i] entries following those of the GameObjects before it.
+        */
+        struct HT_API SceneState
+        {
+            /**
+            * \brief Flags recorded for each GameObject.
+            */
+            enum ObjectFlags : uint8_t
+            {
+                ENABLED     = 1 << 0,
+                INITIALIZED = 1 << 1
+            };
+
+            std::vector<std::string>    typeNames;      /**< Name of each Component type referenced. */
+            std::vector<uint64_t>       layoutHashes;   /**< Reflected layout hash of each type, 0 if it is not reflected. */
+
+            std::vector<ObjectId>       ids;            /**< ObjectId of each GameObject in the captured Scene. */
+            std::vector<Core::Guid>     guids;          /**< Guid of each GameObject. */
+            std::vector<Core::Guid>     prefabs;        /**< Guid of the prefab each GameObject was instantiated from, its own Guid if none. */
+            std::vector<std::string>    names;          /**< Name of each GameObject. */
+            std::vector<uint32_t>       parents;        /**< Index of the parent of each GameObject, UINT32_MAX for roots. */
+            std::vector<uint8_t>        flags;          /**< Combination of ObjectFlags for each GameObject. */
+            std::vector<float>          transforms;     /**< Position, rotation and scale of each GameObject, 9 floats apiece. */
+            std::vector<uint32_t>       componentCounts; /**< Number of Components on each GameObject. */
+
+            std::vector<uint32_t>       componentTypes;     /**< Index into typeNames of each Component. */
+            std::vector<uint8_t>        componentEnabled;   /**< Enabled state of each Component. */
+            std::vector<uint32_t>       componentOffsets;   /**< Start of the state of each Component in componentData, followed by the end. */
+            std::vector<uint8_t>        componentData;      /**< State of every Component as written by Component::VWriteBinary. */
+
+            /**
+            * \brief Empties every column, keeping their storage.
+            */
+            void Clear(void);
+
+            /**
+            * \brief Returns the number of GameObjects in the state.
+            */
+            std::size_t ObjectCount(void) const;
+
+            /**
+            * \brief Returns the number of Components in the state.
+            */
+            std::size_t ComponentCount(void) const;
+
+            /**
+            * \brief Checks that the columns agree in length and that every index refers to an earlier
+            * GameObject, a known type or a byte inside componentData.
+            */
+            bool IsValid(void) const;
+        };
+
+        class HT_API SceneSnapshot
+        {
+        public:
+            /**
+            * \brief Records the runtime state of a Scene.
+            * \param scene  The Scene to capture.
+            * \param state  Cleared and filled with the state. Reusing the same SceneState avoids reallocating.
+            */
+            static void Capture(const Scene& scene, SceneState& state);
+
+            /**
+            * \brief Serializes a SceneState to a snapshot blob.
+            * \param state  The state to write.
+            * \param out    Cleared and filled with the snapshot.
+            */
+            static void Write(const SceneState& state, std::vector<uint8_t>& out);
+
+            /**
+            * \brief Reads a snapshot blob back into a SceneState.
+            * \param data   The snapshot written by Write() or Capture().
+            * \param size   The size of the snapshot in bytes.
+            * \param state  Filled with the state. Left in an unspecified state on failure.
+            * \return false if the snapshot is malformed or from another version.
+            */
+            static bool Read(const uint8_t* data, std::size_t size, SceneState& state);
+
+            /**
+            * \brief Brings a Scene to a recorded state.
+            * \param scene  The Scene to restore. Normally the Scene the state was captured from,
+            *               or a Scene loaded from the same description.
+            * \param state  The state to restore.
+            * \return false if the state is malformed, references a Component type that is unknown or whose
+            *         layout changed, or lacks a Component that is not reflected and that neither a prefab
+            *         nor the scene description holds; the scene is left untouched.
+            */
+            static bool Restore(Scene& scene, const SceneState& state);
+
+            /**
+            * \brief Writes the runtime state of a Scene to out.
+            * \param scene  The Scene to capture.
+            * \param out    Cleared and filled with the snapshot. Reusing the same vector avoids reallocating.
+            */
+            static void Capture(const Scene& scene, std::vector<uint8_t>& out);
+
+            /**
+            * \brief Brings a Scene back to the state recorded in a snapshot.
+            * \param scene  The Scene to restore. Normally the Scene the snapshot was captured from,
+            *               or a Scene loaded from the same description.
+            * \param data   The snapshot written by Capture().
+            * \param size   The size of the snapshot in bytes.
+            * \return false if the snapshot is malformed or references a Component type whose layout
+            *         changed; the scene is left untouched.
+            */
+            static bool Restore(Scene& scene, const uint8_t* data, std::size_t size);
+
+            /**
+            * \brief Brings a Scene back to the state recorded in a snapshot.
+            */
+            static bool Restore(Scene& scene, const std::vector<uint8_t>& data);
+        };
+    }
+}
@@ -17,8 +17,12 @@
 #include <ht_platform.h>
 #include <ht_singleton.h>
 #include <ht_scene.h>
+#include <ht_scene_reclaimer.h>
+#include <ht_scene_file_watcher.h>
 #include <ht_scene_resource.h>
 
+#include <future>
+#include <string>
 #include <vector>
 #include <unordered_map>
 
@@ -34,15 +38,30 @@ namespace Hatchit {
         public:
             /**
              * \brief De-initializes the scene manager.
+             *
+             * Blocks until every outgoing Scene has been destroyed.
              */
             static void Deinitialize();
 
             /**
              * \brief Initializes the scene manager.
              * \return true if the SceneManager could be initialized, false otherwise.
+             *
+             * Only the names in the scene list are registered; a scene's description is loaded
+             * the first time it is needed, or earlier through PrefetchScene().
              */
             static bool Initialize();
 
+            /**
+             * \brief Starts reading the description of a scene in the background.
+             * \param sceneName         The name of a Scene in the scene list.
+             * \return false if the scene is not in the scene list.
+             *
+             * A later LoadScene() of the same scene waits for the read to finish, then parses the description
+             * on the calling thread.
+             */
+            static bool PrefetchScene(const std::string& sceneName);
+
             /**
              * \brief Loads the given scene.
              * \param sceneName         The name of the next Scene to load.
@@ -51,6 +70,9 @@ namespace Hatchit {
              *
              * Unloads the current scene and loads in the specified scene.
              * If the scene does not exist in the list of scenes, an error is thrown.
+             *
+             * The current scene is only detached here; it is destroyed in the background by a SceneReclaimer,
+             * so both scenes may be resident while the next one loads.
              */
             static bool LoadScene(const std::string& sceneName);
 
@@ -59,14 +81,45 @@ namespace Hatchit {
              */
             static void Update();
 
+            /**
+             * \brief Enables or disables hot reloading of the current scene.
+             * \param enabled   Whether edits to the current scene's file should be applied to the live scene.
+             *
+             * While enabled, Update() watches the current scene's file and, when it changes, patches the
+             * live scene to match it with Scene::Patch() instead of reloading it.
+             */
+            static void EnableHotReload(bool enabled);
+
             SceneManager(void) = default;
             virtual ~SceneManager(void) = default;
 
         private:
+            /**
+             * \brief Returns the handle to a scene's description, loading it if it has not been already.
+             * \return The handle, or an invalid handle if the scene is not in the scene list or could not be loaded.
+             */
+            static Resource::SceneHandle ResolveScene(const std::string& sceneName);
+
+            /**
+             * \brief Starts watching the current scene's file, remembering the description it was loaded from.
+             */
+            static void WatchCurrentScene(void);
+
+            /**
+             * \brief Reads the current scene's file again and patches the live scene with it.
+             */
+            static void HotReload(void);
+
             static std::string SCENE_LIST; /**< Name of the file containing the master scene list. */
 
-            std::unordered_map<std::string, Resource::SceneHandle> m_sceneHandles; /**< Map of filenames to Scene JSON handles. */
-            Scene* m_currentScene; /**< The currently loaded scene. */
+            std::unordered_map<std::string, Resource::SceneHandle> m_sceneHandles; /**< Map of filenames to Scene JSON handles, invalid until first use. */
+            std::unordered_map<std::string, std::future<void>> m_prefetches; /**< Scene files being read in the background. */
+            Scene* m_currentScene{ nullptr }; /**< The currently loaded scene. */
+            SceneReclaimer m_reclaimer; /**< Destroys outgoing scenes off the main thread. */
+            std::string m_currentSceneName; /**< File name of the currently loaded scene. */
+            bool m_hotReload{ false }; /**< Whether edits to the current scene's file are applied to the live scene. */
+            SceneFileWatcher m_watcher; /**< Watches the current scene's file while hot reloading. */
+            Core::JSON m_liveDescription; /**< The description the current scene was last loaded or patched from, while hot reloading. */
         };
     }
 }
@@ -0,0 +1,119 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+/**
+* \class StateHash
+* \ingroup HatchitGame
+*
+* \brief Streaming 64-bit hash of simulation state.
+*
+* Consumes eight bytes per step, so hashing the state of a whole scene every frame stays
+* cheap. The result depends only on the bytes added and their order, so two machines with
+* the same byte order agree on it. Not suitable for anything security related.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        class StateHash
+        {
+        public:
+            /**
+            * \param seed   Starting value; hashes with different seeds are unrelated.
+            */
+            explicit StateHash(uint64_t seed = 0)
+                : m_state(seed ^ 0x9E3779B97F4A7C15ULL),
+                m_length(0)
+            {
+            }
+
+            /**
+            * \brief Adds a run of bytes to the hash.
+            */
+            void Add(const void* data, std::size_t size)
+            {
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                m_length += size;
+
+                for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t))
+                {
+                    uint64_t word;
+                    std::memcpy(&word, bytes, sizeof(word));
+                    Step(word);
+                }
+
+                if (size != 0)
+                {
+                    uint64_t word = 0;
+                    std::memcpy(&word, bytes, size);
+                    Step(word);
+                }
+            }
+
+            /**
+            * \brief Adds the bytes of a trivially copyable value to the hash.
+            */
+            template <typename T>
+            void Add(const T& value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be hashed by their bytes!");
+                Add(&value, sizeof(T));
+            }
+
+            /**
+            * \brief Returns the hash of everything added so far.
+            */
+            uint64_t Get(void) const
+            {
+                return Mix(m_state ^ m_length);
+            }
+
+            /**
+            * \brief Combines two hashes. The result depends on their order.
+            */
+            static uint64_t Combine(uint64_t first, uint64_t second)
+            {
+                return Mix(first ^ (second * 0xC2B2AE3D27D4EB4FULL + 0x165667B19E3779F9ULL));
+            }
+
+        private:
+            void Step(uint64_t word)
+            {
+                uint64_t state = m_state ^ (word * 0x87C37B91114253D5ULL);
+                m_state = ((state << 31) | (state >> 33)) * 0x4CF5AD432745937FULL;
+            }
+
+            static uint64_t Mix(uint64_t value)
+            {
+                value ^= value >> 30;
+                value *= 0xBF58476D1CE4E5B9ULL;
+                value ^= value >> 27;
+                value *= 0x94D049BB133111EBULL;
+                value ^= value >> 31;
+                return value;
+            }
+
+            uint64_t    m_state;
+            uint64_t    m_length;
+        };
+    }
+}
@@ -31,6 +31,7 @@ namespace Hatchit {
             void VOnUpdate() override;
             Component* VClone(void) const override;
             virtual Core::Guid VGetComponentId(void) const override;
+            virtual ComponentTypeId VGetComponentTypeId(void) const override;
         protected:
             void VOnEnabled() override;
             void VOnDisabled() override;
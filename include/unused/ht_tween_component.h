@@ -102,6 +102,8 @@ namespace Hatchit {
              */
             typedef float(*TweenFunction)(float start, float end, float time, float duration);
 
+            HT_REFLECTED();
+
             /**
              * \brief Creates a new tween component.
              */
@@ -221,6 +223,18 @@ namespace Hatchit {
             Component* VClone(void) const override;
 
             virtual Core::Guid VGetComponentId(void) const override;
+            virtual ComponentTypeId VGetComponentTypeId(void) const override;
+            virtual const TypeDescriptor* VGetTypeDescriptor(void) const override;
+
+            /**
+             * \brief Writes the reflected fields, with the start time stored relative to the current time.
+             */
+            virtual void VWriteBinary(std::vector<uint8_t>& out) const override;
+
+            /**
+             * \brief Restores the reflected fields, resuming the tween as far into it as it was when written.
+             */
+            virtual bool VReadBinary(const uint8_t*& cursor, const uint8_t* end) override;
         protected:
             static std::vector<TweenFunction> s_tweenFunctions;
 
@@ -259,6 +273,11 @@ namespace Hatchit {
              */
             void VOnDisabled() override;
 
+            /**
+             * \brief Looks the tween function back up after the tween method was loaded.
+             */
+            void VOnFieldsLoaded() override;
+
         private:
             /**
              * \brief Begins playing the tween by assuming all parameters are set.
@@ -74,6 +74,7 @@ namespace Hatchit {
             Component* VClone(void) const override;
 
             virtual Core::Guid VGetComponentId(void) const override;
+            virtual ComponentTypeId VGetComponentTypeId(void) const override;
         };
 
     }
@@ -16,6 +16,7 @@
 
 #include <ht_math.h>
 #include <ht_platform.h>
+#include <ht_reflection.h>
 
 namespace Hatchit {
 
@@ -38,6 +39,8 @@ namespace Hatchit {
         class HT_API TweenValue
         {
         public:
+            HT_REFLECTED();
+
             /**
              * \brief Creates a new tween value.
              *
@@ -23,6 +23,9 @@ namespace Hatchit {
             m_timer = new Core::Timer;
             m_fps = 0.0f;
             m_mspf = 0.0f;
+            m_simulated = false;
+            m_simulatedTotalTime = 0.0f;
+            m_simulatedDeltaTime = 0.0f;
         }
 
         void Time::Start()
@@ -65,6 +68,9 @@ namespace Hatchit {
         {
             Time& _instance = Time::instance();
 
+            if (_instance.m_simulated)
+                return _instance.m_simulatedDeltaTime;
+
             return _instance.m_timer->DeltaTime();
         }
 
@@ -86,8 +92,34 @@ namespace Hatchit {
         {
             Time& _instance = Time::instance();
 
+            if (_instance.m_simulated)
+                return _instance.m_simulatedTotalTime;
+
             return _instance.m_timer->TotalTime();
         }
+
+        void Time::SetSimulationTime(float totalTime, float deltaTime)
+        {
+            Time& _instance = Time::instance();
+
+            _instance.m_simulated = true;
+            _instance.m_simulatedTotalTime = totalTime;
+            _instance.m_simulatedDeltaTime = deltaTime;
+        }
+
+        void Time::ClearSimulationTime()
+        {
+            Time& _instance = Time::instance();
+
+            _instance.m_simulated = false;
+        }
+
+        bool Time::HasSimulationTime()
+        {
+            Time& _instance = Time::instance();
+
+            return _instance.m_simulated;
+        }
     }
 
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
 
 #include <ht_window_singleton.h>
 #include <ht_debug.h>
+#include <ht_nullwindow.h>
 
 #ifdef HT_SYS_LINUX
 #include <ht_glfwwindow.h>
@@ -33,15 +34,21 @@ namespace Hatchit {
         {
             Window& _instance = Window::instance();
 
+            if (params.headless)
+                _instance.m_window = new NullWindow(params);
+            else
+            {
 #ifdef HT_SYS_LINUX
-	    _instance.m_window = new GLFWWindow(params);
+                _instance.m_window = new GLFWWindow(params);
 #else
     #ifdef HT_WIN32_DESKTOP_APP
-            _instance.m_window = new GLFWWindow(params);
+                _instance.m_window = new GLFWWindow(params);
     #elif defined(HT_WIN32_UNIVERSAL_APP)
-            //_instance.m_window = new UWAWindow(params);
+                //_instance.m_window = new UWAWindow(params);
     #endif
 #endif
+            }
+
             if (!_instance.m_window->VInitialize())
             {
                 HT_DEBUG_PRINTF("Failed to initialize Window. Exiting. \n");
@@ -0,0 +1,80 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_nullwindow.h>
+#include <ht_debug.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        NullWindow::NullWindow(const WindowParams& params)
+        {
+            m_params = params;
+            m_nativeWindowHandle = nullptr;
+            m_nativeDisplayHandle = nullptr;
+            m_running = false;
+            m_frames = 0;
+        }
+
+        NullWindow::~NullWindow()
+        {
+            HT_DEBUG_PRINTF("Headless window closed after %llu frames.\n", static_cast<unsigned long long>(m_frames));
+        }
+
+        bool NullWindow::VInitialize()
+        {
+            m_running = true;
+
+            return true;
+        }
+
+        void NullWindow::VPollEvents()
+        {
+        }
+
+        void* NullWindow::VNativeWindowHandle()
+        {
+            return m_nativeWindowHandle;
+        }
+
+        void* NullWindow::VNativeDisplayHandle()
+        {
+            return m_nativeDisplayHandle;
+        }
+
+        bool NullWindow::VIsRunning()
+        {
+            return m_running;
+        }
+
+        void NullWindow::VClose()
+        {
+            m_running = false;
+        }
+
+        void NullWindow::VSwapBuffers()
+        {
+            m_frames++;
+            if (m_params.frameLimit != 0 && m_frames >= m_params.frameLimit)
+                m_running = false;
+        }
+
+        uint64_t NullWindow::GetFrameCount() const
+        {
+            return m_frames;
+        }
+    }
+
+}
@@ -147,6 +147,20 @@ namespace Hatchit {
 #endif
             wparams.renderer = rparams.renderer;
 
+            /*A NULL renderer draws nothing, so it gets a window that opens nothing on screen*/
+            bool headless = (renderer == "NULL");
+            wparams.headless = headless;
+
+            try
+            {
+                wparams.frameLimit = static_cast<uint32_t>(m_settings->GetValue<int>("WINDOW", "iFrameLimit"));
+            }
+            catch (const std::invalid_argument&)
+            {
+                /*Optional; run until closed*/
+                wparams.frameLimit = 0;
+            }
+
             if (!Window::Initialize(wparams))
                 return false;
 
@@ -178,10 +192,20 @@ namespace Hatchit {
                 rparams.clearColor = Color(0.0f, 0.0f, 0.0f, 0.0f);
             }
 
-            if (!Renderer::Initialize(rparams))
+            if (headless ? !Renderer::InitializeHeadless() : !Renderer::Initialize(rparams))
                 return false;
 
-            if (!AudioEmitter::Initialize())
+            /*Audio follows the renderer unless the settings file says otherwise*/
+            bool headlessAudio = headless;
+            try
+            {
+                headlessAudio = m_settings->GetValue<bool>("AUDIO", "bHeadless");
+            }
+            catch (const std::invalid_argument&)
+            {
+            }
+
+            if (!AudioEmitter::Initialize(headlessAudio))
                 return false;
 
             Input::Initialize();
@@ -198,6 +222,15 @@ namespace Hatchit {
         {
             SceneManager::Deinitialize();
             Input::DeInitialize();
+
+            const RenderStats& renderStats = Renderer::GetStats();
+            const AudioStats& audioStats = AudioEmitter::GetStats();
+            HT_DEBUG_PRINTF("Submitted %llu frames, %llu draw calls, %llu instances, %llu culled, %llu occluded, %llu cameras, %llu audio plays, %llu audio buffers.\n",
+                static_cast<unsigned long long>(renderStats.frames), static_cast<unsigned long long>(renderStats.drawCalls),
+                static_cast<unsigned long long>(renderStats.instances), static_cast<unsigned long long>(renderStats.culled),
+                static_cast<unsigned long long>(renderStats.occluded), static_cast<unsigned long long>(renderStats.cameras),
+                static_cast<unsigned long long>(audioStats.plays), static_cast<unsigned long long>(audioStats.buffersQueued));
+
             Renderer::DeInitialize();
             Window::DeInitialize();
             Core::Path::DeInitialize();
@@ -0,0 +1,205 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_asset_prefetcher.h>
+#include <ht_component_registry.h>
+#include <ht_path_singleton.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+            // Reads a file start to end and discards it, leaving its contents in the OS file cache.
+            void ReadThrough(const std::string& path, std::vector<char>& buffer)
+            {
+                std::ifstream file(path, std::ios::binary);
+                while (file.read(buffer.data(), buffer.size()))
+                    ;
+            }
+        }
+
+        void AssetPrefetcher::AddMesh(const std::string& fileName)
+        {
+            m_meshFiles.insert(fileName);
+        }
+
+        void AssetPrefetcher::AddMaterial(const std::string& fileName)
+        {
+            m_materialFiles.insert(fileName);
+        }
+
+        void AssetPrefetcher::AddAudio(const std::string& fileName)
+        {
+            m_audioFiles.insert(fileName);
+        }
+
+        void AssetPrefetcher::Gather(const Core::JSON& sceneDescription)
+        {
+            JSON::const_iterator iter = sceneDescription.find("GameObjects");
+            if (iter != sceneDescription.cend())
+                GatherGameObjects(*iter);
+
+            iter = sceneDescription.find("Prefabs");
+            if (iter != sceneDescription.cend())
+                GatherGameObjects(*iter);
+        }
+
+        void AssetPrefetcher::GatherGameObjects(const Core::JSON& gameObjects)
+        {
+            if (!gameObjects.is_array())
+                return;
+
+            for (const JSON& json_obj : gameObjects)
+            {
+                JSON::const_iterator components = json_obj.find("Components");
+                if (components == json_obj.cend() || !components->is_array())
+                    continue;
+
+                for (const JSON& json_component : *components)
+                {
+                    JSON::const_iterator type_iter = json_component.find("Type");
+                    if (type_iter == json_component.cend())
+                        continue;
+
+                    const JSON::string_t* type = type_iter->get_ptr<const JSON::string_t*>();
+                    if (type == nullptr)
+                        continue;
+
+                    const ComponentRegistry::Entry* entry = ComponentRegistry::Find(type->data(), type->size());
+                    if (entry != nullptr && entry->gatherAssets != nullptr)
+                        entry->gatherAssets(json_component, *this);
+                }
+            }
+        }
+
+        void AssetPrefetcher::Load(std::size_t workerCount)
+        {
+            enum class AssetKind { Mesh, Material, Audio };
+
+            struct Job
+            {
+                AssetKind           kind;
+                const std::string*  fileName;
+                std::string         path;
+            };
+
+            // The resource caches are not safe to call from several threads and creating a handle
+            // may touch the graphics device, so the workers only read the files through. The calling
+            // thread then creates every handle in order, each from a file that is already in memory.
+            std::vector<Job> jobs;
+            jobs.reserve(m_meshFiles.size() + m_materialFiles.size() + m_audioFiles.size());
+
+            for (const std::string& file : m_meshFiles)
+                jobs.push_back(Job{ AssetKind::Mesh, &file, Core::Path::Value(Core::Path::Directory::Models) + file });
+            for (const std::string& file : m_materialFiles)
+                jobs.push_back(Job{ AssetKind::Material, &file, Core::Path::Value(Core::Path::Directory::Materials) + file });
+            for (const std::string& file : m_audioFiles)
+                jobs.push_back(Job{ AssetKind::Audio, &file, Core::Path::Value(Core::Path::Directory::Audio) + file });
+
+            if (jobs.empty())
+                return;
+
+            m_meshes.reserve(m_meshes.size() + m_meshFiles.size());
+            m_materials.reserve(m_materials.size() + m_materialFiles.size());
+            m_audio.reserve(m_audio.size() + m_audioFiles.size());
+
+            std::unique_ptr<std::atomic<bool>[]> ready(new std::atomic<bool>[jobs.size()]);
+            for (std::size_t i = 0; i < jobs.size(); i++)
+                ready[i] = false;
+
+            std::atomic<std::size_t> nextJob(0);
+            auto readNext = [&](std::vector<char>& buffer)
+            {
+                std::size_t i = nextJob++;
+                if (i >= jobs.size())
+                    return false;
+
+                ReadThrough(jobs[i].path, buffer);
+                ready[i] = true;
+                return true;
+            };
+
+            if (workerCount == 0)
+                workerCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            workerCount = std::min(workerCount, jobs.size());
+
+            std::vector<std::thread> threads;
+            threads.reserve(workerCount - 1);
+            for (std::size_t i = 1; i < workerCount; i++)
+            {
+                threads.emplace_back([&]()
+                {
+                    std::vector<char> buffer(64 * 1024);
+                    while (readNext(buffer))
+                        ;
+                });
+            }
+
+            // The calling thread creates the handles as their files come in, and reads files
+            // itself whenever the next one is not ready yet.
+            std::vector<char> buffer(64 * 1024);
+            for (std::size_t i = 0; i < jobs.size(); i++)
+            {
+                while (!ready[i])
+                {
+                    if (!readNext(buffer))
+                        std::this_thread::yield();
+                }
+
+                const Job& job = jobs[i];
+                switch (job.kind)
+                {
+                    case AssetKind::Mesh:
+                        m_meshes.push_back(Graphics::Mesh::GetHandle(*job.fileName, *job.fileName));
+                        break;
+
+                    case AssetKind::Material:
+                        m_materials.push_back(Graphics::Material::GetHandle(*job.fileName, *job.fileName));
+                        break;
+
+                    case AssetKind::Audio:
+                        m_audio.push_back(Resource::Audio::GetHandleFromFileName(*job.fileName));
+                        break;
+                }
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            HT_DEBUG_PRINTF("Prefetched %zu assets, read on %zu threads.\n", jobs.size(), workerCount);
+
+            m_meshFiles.clear();
+            m_materialFiles.clear();
+            m_audioFiles.clear();
+        }
+
+        void AssetPrefetcher::Release(void)
+        {
+            m_meshFiles.clear();
+            m_materialFiles.clear();
+            m_audioFiles.clear();
+            m_meshes.clear();
+            m_materials.clear();
+            m_audio.clear();
+        }
+    }
+}
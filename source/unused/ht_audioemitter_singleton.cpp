@@ -13,19 +13,29 @@
 **/
 
 #include <ht_audioemitter_singleton.h>
+#include <ht_debug.h>
 
 namespace Hatchit
 {
     namespace Game
     {
-        bool AudioEmitter::Initialize()
+        bool AudioEmitter::Initialize(bool headless)
         {
             AudioEmitter& _instance = AudioEmitter::instance();
+            _instance.m_headless = headless;
+            _instance.m_stats = AudioStats{};
+            if (headless)
+            {
+                HT_DEBUG_PRINTF("Initialized headless AudioEmitter.\n");
+                return true;
+            }
+
             if (!_instance.m_device.Initialize())
             {
                 return false;
             }
             _instance.m_device.MakeContextCurrent();
+            _instance.m_deviceOpen = true;
             return true;
         }
 
@@ -33,12 +43,52 @@ namespace Hatchit
         {
             AudioEmitter& _instance = AudioEmitter::instance();
 
+            if (!_instance.m_deviceOpen)
+                return;
+
             _instance.m_device.~Device();
+            _instance.m_deviceOpen = false;
         }
 
         void AudioEmitter::Update()
         {
             //Do stuff
         }
+
+        bool AudioEmitter::IsHeadless()
+        {
+            AudioEmitter& _instance = AudioEmitter::instance();
+
+            return _instance.m_headless;
+        }
+
+        void AudioEmitter::CountPlay(uint32_t bufferCount)
+        {
+            AudioEmitter& _instance = AudioEmitter::instance();
+
+            _instance.m_stats.plays++;
+            _instance.m_stats.buffersQueued += bufferCount;
+        }
+
+        void AudioEmitter::CountBuffersQueued(uint32_t bufferCount)
+        {
+            AudioEmitter& _instance = AudioEmitter::instance();
+
+            _instance.m_stats.buffersQueued += bufferCount;
+        }
+
+        const AudioStats& AudioEmitter::GetStats()
+        {
+            AudioEmitter& _instance = AudioEmitter::instance();
+
+            return _instance.m_stats;
+        }
+
+        void AudioEmitter::ResetStats()
+        {
+            AudioEmitter& _instance = AudioEmitter::instance();
+
+            _instance.m_stats = AudioStats{};
+        }
     }
 }
\ No newline at end of file
@@ -13,15 +13,19 @@
 **/
 
 #include <ht_audiolistener_component.h>
+#include <ht_component_registry.h>
 
 #include <ht_gameobject.h> //GameObject
 #include <ht_transform.h> //Transform data
+#include <ht_audioemitter_singleton.h> //Headless check
 #include <AL/al.h>
 
 namespace Hatchit
 {
     namespace Game
     {
+        HT_REGISTER_COMPONENT_WITH_FLAGS(AudioListener, ComponentRegistry::TRIVIAL_TEARDOWN);
+
         AudioListener::AudioListener()
         {
 
@@ -45,6 +49,10 @@ namespace Hatchit
 
         void AudioListener::VOnUpdate()
         {
+            //Headless, there is no listener to update
+            if (AudioEmitter::IsHeadless())
+                return;
+
             //Update listener's transform data
             Transform& transformData = m_owner->GetTransform();
             Math::Vector3 position = transformData.GetPosition();
@@ -65,6 +73,11 @@ namespace Hatchit
             return Component::GetComponentId<AudioListener>();
         }
 
+        ComponentTypeId AudioListener::VGetComponentTypeId() const
+        {
+            return Component::GetComponentTypeId<AudioListener>();
+        }
+
         void AudioListener::VOnEnabled()
         {
             HT_DEBUG_PRINTF("Enabled AudioListener Component.\n");
@@ -13,57 +13,93 @@
 **/
 
 #include <ht_audiosource_component.h>
+#include <ht_component_registry.h>
+#include <ht_asset_prefetcher.h>
+#include <ht_audioemitter_singleton.h>
 #include <stb_vorbis.c>
 
 namespace Hatchit
 {
     namespace Game
     {
+        namespace
+        {
+            //A headless AudioEmitter plays nothing, so nothing is loaded for it
+            Resource::AudioResourceHandle LoadAudio(const std::string& fileName)
+            {
+                if (AudioEmitter::IsHeadless())
+                    return Resource::AudioResourceHandle();
+
+                return Resource::Audio::GetHandleFromFileName(fileName);
+            }
+        }
+
+        HT_REGISTER_COMPONENT_WITH_ASSETS_AND_FLAGS(AudioSource, &AudioSource::GatherAssets, ComponentRegistry::MAIN_THREAD_TEARDOWN | ComponentRegistry::NO_ROLLBACK);
+
+        HT_REFLECT_BEGIN(AudioSource)
+            HT_REFLECT_FIELD("Audio", m_audioFile)
+        HT_REFLECT_END()
+
+        const char* AudioSource::DefaultAudioFile = "Example2.ogg";
+
         AudioSource::AudioSource()
-            : m_currentAudioHandle(),
+            : m_audioFile(DefaultAudioFile),
+            m_currentAudioHandle(),
             m_playing(false),
             m_audioStream(nullptr),
             m_source(),
             m_bufferList(),
-            m_nextBufferIndex(0)
+            m_nextBufferIndex(0),
+            m_samplesPlayed(0)
         {
         }
 
+        //Copies only configuration; the copy opens its own stream and source when initialized
         AudioSource::AudioSource(const AudioSource& source)
-            : m_currentAudioHandle(source.m_currentAudioHandle),
-            m_playing(source.m_playing),
-            m_audioStream(),
-            m_source(source.m_source),
+            : Component(source),
+            m_audioFile(source.m_audioFile),
+            m_currentAudioHandle(),
+            m_playing(false),
+            m_audioStream(nullptr),
+            m_source(),
             m_bufferList(),
-            m_nextBufferIndex(0)
+            m_nextBufferIndex(0),
+            m_samplesPlayed(0)
         {
-            m_audioStream = reinterpret_cast<stb_vorbis*>(malloc(sizeof(stb_vorbis)));
-            std::memcpy(m_audioStream, source.m_audioStream, sizeof(stb_vorbis));
         }
 
         AudioSource::AudioSource(AudioSource&& source)
-            : m_currentAudioHandle(std::move(source.m_currentAudioHandle)),
+            : m_audioFile(std::move(source.m_audioFile)),
+            m_currentAudioHandle(std::move(source.m_currentAudioHandle)),
             m_playing(std::move(source.m_playing)),
             m_audioStream(std::move(source.m_audioStream)),
             m_source(std::move(source.m_source)),
             m_bufferList(std::move(source.m_bufferList)),
-            m_nextBufferIndex(std::move(source.m_nextBufferIndex))
+            m_nextBufferIndex(std::move(source.m_nextBufferIndex)),
+            m_samplesPlayed(source.m_samplesPlayed)
         {
             source.m_audioStream = nullptr;
         }
 
         AudioSource& AudioSource::operator=(const AudioSource& source)
         {
-            m_currentAudioHandle = source.m_currentAudioHandle;
-            m_playing = source.m_playing;
-            m_audioStream = reinterpret_cast<stb_vorbis*>(malloc(sizeof(stb_vorbis)));
-            std::memcpy(m_audioStream, source.m_audioStream, sizeof(stb_vorbis));
-            m_source = source.m_source;
+            if (this == &source)
+                return *this;
+
+            //Keep this source, but stop streaming into it until VOnInit plays the new file
+            stb_vorbis_close(m_audioStream);
+            m_audioStream = nullptr;
+            m_audioFile = source.m_audioFile;
+            m_currentAudioHandle = Resource::AudioResourceHandle();
+            m_playing = false;
+            m_nextBufferIndex = 0;
+            m_samplesPlayed = 0;
             return *this;
         }
 
         AudioSource& AudioSource::operator=(AudioSource&& source)
         {
+            m_audioFile = std::move(source.m_audioFile);
             m_currentAudioHandle = std::move(source.m_currentAudioHandle);
             m_playing = std::move(source.m_playing);
             m_audioStream = std::move(source.m_audioStream);
@@ -71,30 +107,45 @@ namespace Hatchit
             m_source = std::move(source.m_source);
             m_bufferList = std::move(source.m_bufferList);
             m_nextBufferIndex = std::move(source.m_nextBufferIndex);
+            m_samplesPlayed = source.m_samplesPlayed;
             return *this;
         }
 
         Core::JSON AudioSource::VSerialize()
         {
-            return Core::JSON();
+            return Reflect().ToJson(this);
         }
 
         bool AudioSource::VDeserialize(const Core::JSON& jsonObject)
         {
+            if (!Core::JsonExtract<std::string>(jsonObject, "Audio", m_audioFile))
+                m_audioFile = DefaultAudioFile;
+
             return true;
         }
 
+        void AudioSource::GatherAssets(const Core::JSON& jsonObject, AssetPrefetcher& prefetcher)
+        {
+            std::string audioFile;
+            if (AudioEmitter::IsHeadless())
+                return;
+
+            if (!Core::JsonExtract<std::string>(jsonObject, "Audio", audioFile))
+                audioFile = DefaultAudioFile;
+
+            prefetcher.AddAudio(audioFile);
+        }
+
         void AudioSource::VOnInit()
         {
             HT_DEBUG_PRINTF("Initialized AudioSource Component.\n");
 
-            //For testing
-            PlayAudio(Resource::Audio::GetHandleFromFileName("Example2.ogg"));
+            PlayAudio(LoadAudio(m_audioFile));
         }
 
         void AudioSource::VOnUpdate()
         {
-            if (!m_playing)
+            if (!m_playing || AudioEmitter::IsHeadless())
                 return;
 
             auto numBuffersToProcess = m_source.GetNumBuffersQueued();
@@ -108,12 +159,16 @@ namespace Hatchit
             while (numBuffersProcessed > 0)
             {
                 m_source.UnqueueBuffer(m_bufferList[m_nextBufferIndex]);
+                m_samplesPlayed += static_cast<uint32_t>(m_bufferList[m_nextBufferIndex].GetBufferSize() / (m_currentAudioHandle->GetNumChannels() * sizeof(short)));
                 SetupBuffer(m_bufferList[m_nextBufferIndex]);
 
                 //If there's nothing left to buffer, then don't queue it to
                 //play
                 if(m_bufferList[m_nextBufferIndex].GetBufferSize() > 0)
+                {
                     m_source.QueueBuffer(m_bufferList[m_nextBufferIndex]);
+                    AudioEmitter::CountBuffersQueued(1);
+                }
 
                 m_nextBufferIndex = (m_nextBufferIndex + 1) % numBuffers;
                 --numBuffersProcessed;
@@ -132,9 +187,76 @@ namespace Hatchit
             return Component::GetComponentId<AudioSource>();
         }
 
-        void AudioSource::PlayAudio(Resource::AudioResourceHandle handle)
+        ComponentTypeId AudioSource::VGetComponentTypeId() const
+        {
+            return Component::GetComponentTypeId<AudioSource>();
+        }
+
+        const TypeDescriptor* AudioSource::VGetTypeDescriptor() const
+        {
+            return &Reflect();
+        }
+
+        void AudioSource::VWriteBinary(std::vector<uint8_t>& out) const
+        {
+            Component::VWriteBinary(out);
+
+            out.push_back(m_playing ? 1 : 0);
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&m_samplesPlayed);
+            out.insert(out.end(), bytes, bytes + sizeof(m_samplesPlayed));
+        }
+
+        bool AudioSource::VReadBinary(const uint8_t*& cursor, const uint8_t* end)
+        {
+            std::string previousFile = m_audioFile;
+            if (!Component::VReadBinary(cursor, end))
+                return false;
+
+            uint32_t sample;
+            if (static_cast<std::size_t>(end - cursor) < 1 + sizeof(sample))
+                return false;
+            bool playing = cursor[0] != 0;
+            std::memcpy(&sample, cursor + 1, sizeof(sample));
+            cursor += 1 + sizeof(sample);
+
+            if (!playing)
+            {
+                //Stop streaming; whatever is queued drains on its own
+                m_playing = false;
+                return true;
+            }
+
+            if (AudioEmitter::IsHeadless() || m_source.GetNumBuffersQueued() == 0)
+            {
+                PlayAudio(LoadAudio(m_audioFile), sample);
+            }
+            else if (m_audioStream != nullptr && previousFile == m_audioFile)
+            {
+                stb_vorbis_seek(m_audioStream, sample);
+                m_samplesPlayed = sample;
+                m_playing = true;
+            }
+            else
+            {
+                HT_DEBUG_PRINTF("Cannot switch AudioSource to %s while buffers are queued.\n", m_audioFile.c_str());
+            }
+
+            return true;
+        }
+
+        void AudioSource::PlayAudio(Resource::AudioResourceHandle handle, uint32_t startSample)
         {
             m_currentAudioHandle = handle;
+
+            //Headless, only count what would have been queued
+            if (AudioEmitter::IsHeadless())
+            {
+                m_samplesPlayed = startSample;
+                m_playing = true;
+                AudioEmitter::CountPlay(numBuffers);
+                return;
+            }
+
             //Initialize for playing
             stb_vorbis_close(m_audioStream);
 
@@ -145,6 +267,10 @@ namespace Hatchit
                 return;
             }
 
+            if (startSample > 0)
+                stb_vorbis_seek(m_audioStream, startSample);
+            m_samplesPlayed = startSample;
+
             //Start setting up buffers
             for (auto& buffer : m_bufferList)
             {
@@ -176,6 +302,7 @@ namespace Hatchit
                 HT_ERROR_PRINTF("Error playing Audio source");
                 return;
             }
+            AudioEmitter::CountPlay(static_cast<uint32_t>(m_source.GetNumBuffersQueued()));
 
             m_playing = true;
         }
@@ -13,16 +13,20 @@
 **/
 
 #include <ht_camera_component.h>
+#include <ht_component_registry.h>
 #include <ht_renderer_singleton.h>
 #include <ht_input_singleton.h>
 #include <ht_swapchain.h>
 #include <ht_jsonhelper.h>
 #include <ht_gameobject.h>
+#include <ht_scene.h>
 
 namespace Hatchit {
 
     namespace Game {
 
+        HT_REGISTER_COMPONENT_WITH_FLAGS(Camera, ComponentRegistry::MAIN_THREAD_TEARDOWN);
+
         Camera::Camera()
         {
             m_useWindowScale = false;
@@ -72,7 +76,7 @@ namespace Hatchit {
                 HT_WARNING_PRINTF("Camera::VDeserialize: Failed to load layer; defaulting to 1\n");
 
             //If we want to use window scale lets make m_width and m_height relative to the renderer's swapchain size
-            if (m_useWindowScale)
+            if (m_useWindowScale && m_renderer != nullptr)
             {
                 Graphics::SwapChain* swapchain = m_renderer->GetSwapChain();
 
@@ -103,7 +107,14 @@ namespace Hatchit {
             //Send transform data to the GPU by registering the camera with the renderer
             m_camera.SetView(Math::MMMatrixLookAt(t.GetPosition(), t.GetPosition() + t.GetForward(), t.GetUp()));
             m_camera.SetProjection(Math::MMMatrixPerspProj(m_fov, m_width, m_height, m_near, m_far));
-            m_renderer->RegisterCamera(m_camera);
+            Renderer::CountCamera();
+            if (m_renderer != nullptr)
+                m_renderer->RegisterCamera(m_camera);
+
+            //cull this frame's draws against what the camera can see
+            Scene* scene = m_owner->GetScene();
+            if (scene != nullptr)
+                scene->GetRenderQueue().AddView(t.GetPosition(), t.GetForward(), t.GetUp(), m_fov, m_width / m_height, m_near, m_far, m_layer);
         }
 
         void Camera::VOnEnabled()
@@ -127,6 +138,11 @@ namespace Hatchit {
             return new Camera(*this);
         }
 
+        float Camera::GetFarPlane(void) const
+        {
+            return m_far;
+        }
+
         /**
         * \brief Retrieves the id associated with this class of Component.
         * \return The Core::Guid associated with this Component type.
@@ -137,6 +153,15 @@ namespace Hatchit {
             return Component::GetComponentId<Camera>();
         }
 
+        /**
+        * \brief Retrieves the dense runtime id associated with this class of Component.
+        * \return The ComponentTypeId associated with this Component type.
+        */
+        ComponentTypeId Camera::VGetComponentTypeId(void) const
+        {
+            return Component::GetComponentTypeId<Camera>();
+        }
+
         void Camera::Move()
         {
             Transform& t = m_owner->GetTransform();
@@ -15,9 +15,16 @@
 #include <ht_component.h>
 #include <ht_debug.h>
 #include <ht_gameobject.h>
+#include <ht_reflection.h>
 
 namespace Hatchit {
     namespace Game {
+        ComponentTypeId Component::NextComponentTypeId(void)
+        {
+            static ComponentTypeId nextId = 0;
+            return nextId++;
+        }
+
         GameObject* Component::GetOwner(void)
         {
             return m_owner;
@@ -52,5 +59,38 @@ namespace Hatchit {
 
             m_enabled = value;
         }
+
+        const TypeDescriptor* Component::VGetTypeDescriptor(void) const
+        {
+            return nullptr;
+        }
+
+        void Component::VWriteBinary(std::vector<uint8_t>& out) const
+        {
+            const TypeDescriptor* descriptor = VGetTypeDescriptor();
+            if (descriptor != nullptr)
+                descriptor->WriteBinary(this, out);
+        }
+
+        bool Component::VReadBinary(const uint8_t*& cursor, const uint8_t* end)
+        {
+            const TypeDescriptor* descriptor = VGetTypeDescriptor();
+            if (descriptor == nullptr)
+                return false;
+
+            if (!descriptor->ReadBinary(this, cursor, end))
+                return false;
+
+            VOnFieldsLoaded();
+            return true;
+        }
+
+        void Component::VOnFieldsLoaded(void)
+        {
+        }
+
+        void Component::VOnForked(void)
+        {
+        }
     }
 }
\ No newline at end of file
@@ -1,129 +1,36 @@
-
-#include "ht_component_factory.h"
-
-/*[[[cog
-import cog
-from os import listdir
-from os.path import isfile, join
-
-class Node():
-    def __init__(self, filename, className, superName):
-        self.filename = filename
-        self.className = className
-        self.superName = superName
-        self.children = []
-
-def findChildren(classes, componentList, components, superName):
-    for cl in classes:
-        if cl.superName == superName:
-            components.append(Node(cl.filename, cl.className, cl.superName))
-            componentList.append(cl)
-
-classes = []
-componentList = []
-components = []
-
-path = '../../../../HatchitGame/include/'
-files = [f for f in listdir(path) if isfile(join(path, f))]
-
-for filename in files:
-    with open(path + filename, 'r') as f:
-        for line in f:
-            if "class" in line and " : " in line and not ("enum" in line):
-                words = line.strip().split(" : ")
-                className = words[0].strip().split(' ')[-1]
-                supers = words[1].strip().split(' ')
-                for superName in supers:
-                    if not (superName == "public") and not (superName == ","):
-                        classes.append(Node(filename, className, superName))
-
-findChildren(classes, componentList, components, "Component")
-while len(componentList) > 0:
-    n = componentList.pop()
-    findChildren(classes, componentList, components, n.className)
-
-for t in components:
-    cog.outl("#include <%s>" % t.filename);
-
-]]]*/
-#include <ht_audiolistener_component.h>
-#include <ht_audiosource_component.h>
-#include <ht_camera_component.h>
-#include <ht_light_component.h>
-#include <ht_meshrenderer_component.h>
-#include <ht_test_component.h>
-#include <ht_tween_component.h>
-#include <ht_tween_position.h>
-#include <ht_tween_rotation.h>
-#include <ht_tween_scale.h>
-//[[[end]]]
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_component_factory.h>
+#include <ht_component_registry.h>
 
 namespace Hatchit {
 
     namespace Game {
 
-        Component* ComponentFactory::MakeComponent(std::string type)
+        Component* ComponentFactory::MakeComponent(const std::string& type)
         {
-            /*[[[cog
-                
-                import cog
-                from os import listdir
-                from os.path import isfile, join
-
-                path = '../../../../HatchitGame/include/'
-                files = [f for f in listdir(path) if isfile(join(path, f))]
-                
-                class Node():
-                    def __init__(self, filename, className, superName):
-                        self.filename = filename
-                        self.className = className
-                        self.superName = superName
-                        self.children = []
-                    def addChild(self, child):
-                        self.children.append(child)
-
-                def findChildren(classes, componentList, components, superName):
-                    for cl in classes:
-                        if cl.superName == superName:
-                            componentList.append(cl)
-                            components.append(Node(cl.filename, cl.className, cl.superName))
-
-                classes = []
-                componentList = []
-                components = []
+            return MakeComponent(type.data(), type.size());
+        }
 
-                for filename in files:
-                    with open(path + filename, 'r') as f:
-                        for line in f:
-                            if "class" in line and " : " in line and not ("enum" in line):
-                                words = line.strip().split(" : ")
-                                className = words[0].strip().split(' ')[-1]
-                                supers = words[1].strip().split(' ')
-                                for superName in supers:
-                                    if not (superName == "public") and not (superName == ","):
-                                        classes.append(Node(filename, className, superName))
+        Component* ComponentFactory::MakeComponent(const char* type, std::size_t length)
+        {
+            const ComponentRegistry::Entry* entry = ComponentRegistry::Find(type, length);
+            if (entry == nullptr)
+                return nullptr;
 
-                findChildren(classes, componentList, components, "Component")
-                while len(componentList) > 0:
-                    n = componentList.pop()
-                    findChildren(classes, componentList, components, n.className)
-                
-                for t in components:
-                    cog.outl("""if (type == "%s") return new %s();""" % (t.className, t.className));
-                
-            ]]]*/
-            if (type == "AudioListener") return new AudioListener();
-            if (type == "AudioSource") return new AudioSource();
-            if (type == "Camera") return new Camera();
-            if (type == "LightComponent") return new LightComponent();
-            if (type == "MeshRenderer") return new MeshRenderer();
-            if (type == "TestComponent") return new TestComponent();
-            if (type == "TweenComponent") return new TweenComponent();
-            if (type == "TweenPosition") return new TweenPosition();
-            if (type == "TweenRotation") return new TweenRotation();
-            if (type == "TweenScale") return new TweenScale();
-            //[[[end]]]
-            return nullptr;
+            return entry->construct();
         }
     }
 }
@@ -0,0 +1,120 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_component_registry.h>
+#include <ht_debug.h>
+
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        bool ComponentRegistry::Register(Entry entry)
+        {
+            ComponentRegistry& _instance = ComponentRegistry::instance();
+
+            std::size_t length = std::strlen(entry.name);
+            if (Find(entry.name, length) != nullptr)
+            {
+                HT_DEBUG_PRINTF("Component type %s was registered more than once!\n", entry.name);
+                return false;
+            }
+
+            entry.nameLength = length;
+            entry.hash = Hash(entry.name, length);
+            _instance.m_entries.push_back(entry);
+
+            if (entry.typeId >= _instance.m_byTypeId.size())
+                _instance.m_byTypeId.resize(entry.typeId + 1, 0);
+            _instance.m_byTypeId[entry.typeId] = static_cast<uint32_t>(_instance.m_entries.size());
+
+            _instance.RebuildSlots();
+
+            return true;
+        }
+
+        const ComponentRegistry::Entry* ComponentRegistry::Find(const char* name, std::size_t length)
+        {
+            ComponentRegistry& _instance = ComponentRegistry::instance();
+
+            if (_instance.m_slots.empty())
+                return nullptr;
+
+            uint64_t hash = Hash(name, length);
+            std::size_t mask = _instance.m_slots.size() - 1;
+
+            // Linear probing; the table is kept at most half full so probe chains stay short.
+            for (std::size_t slot = static_cast<std::size_t>(hash) & mask; ; slot = (slot + 1) & mask)
+            {
+                uint32_t index = _instance.m_slots[slot];
+                if (index == 0)
+                    return nullptr;
+
+                const Entry& entry = _instance.m_entries[index - 1];
+                if (entry.hash == hash && entry.nameLength == length && std::memcmp(entry.name, name, length) == 0)
+                    return &entry;
+            }
+        }
+
+        const ComponentRegistry::Entry* ComponentRegistry::Find(const std::string& name)
+        {
+            return Find(name.data(), name.size());
+        }
+
+        const ComponentRegistry::Entry* ComponentRegistry::Find(ComponentTypeId typeId)
+        {
+            ComponentRegistry& _instance = ComponentRegistry::instance();
+
+            if (typeId >= _instance.m_byTypeId.size() || _instance.m_byTypeId[typeId] == 0)
+                return nullptr;
+
+            return &_instance.m_entries[_instance.m_byTypeId[typeId] - 1];
+        }
+
+        std::size_t ComponentRegistry::Count(void)
+        {
+            return ComponentRegistry::instance().m_entries.size();
+        }
+
+        uint64_t ComponentRegistry::Hash(const char* name, std::size_t length)
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (std::size_t i = 0; i < length; i++)
+            {
+                hash ^= static_cast<uint8_t>(name[i]);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        void ComponentRegistry::RebuildSlots(void)
+        {
+            std::size_t capacity = 16;
+            while (capacity < m_entries.size() * 2)
+                capacity <<= 1;
+
+            m_slots.assign(capacity, 0);
+            std::size_t mask = capacity - 1;
+
+            for (std::size_t i = 0; i < m_entries.size(); i++)
+            {
+                std::size_t slot = static_cast<std::size_t>(m_entries[i].hash) & mask;
+                while (m_slots[slot] != 0)
+                    slot = (slot + 1) & mask;
+                m_slots[slot] = static_cast<uint32_t>(i + 1);
+            }
+        }
+    }
+}
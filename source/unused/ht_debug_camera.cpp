@@ -145,6 +145,10 @@ namespace Hatchit {
         */
         void DebugCamera::Zoom()
         {
+            //A headless Renderer has no swap chain to zoom relative to
+            if (Renderer::IsHeadless())
+                return;
+
             Graphics::SwapChain* chain = Renderer::instance().GetRenderer()->GetSwapChain();
             Math::Vector2 windowCenter = Math::Vector2(chain->GetWidth() / 2, chain->GetHeight() / 2);
 
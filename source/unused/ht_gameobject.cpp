@@ -15,22 +15,37 @@
 #include <ht_gameobject.h>
 #include <ht_debug.h>
 #include <ht_component.h>
+#include <ht_scene.h>
 #include <algorithm>
 
 namespace Hatchit {
 
     namespace Game {
-        GameObject::GameObject(void)
+        namespace {
+            SceneArena* ArenaOf(Scene* scene)
+            {
+                return (scene != nullptr) ? &scene->m_arena : nullptr;
+            }
+        }
+
+        GameObject::GameObject(Scene* scene)
+            : m_children(ChildList::allocator_type(ArenaOf(scene))),
+            m_components(ComponentList::allocator_type(ArenaOf(scene))),
+            m_componentMap(ComponentMap::allocator_type(ArenaOf(scene)))
         {
             m_destroyed = 0;
+            m_initialized = false;
+            m_id = InvalidObjectId;
+            m_prefab = InvalidObjectId;
+            m_name = InvalidNameId;
+            m_scene = scene;
+            m_initPriority = 0;
+            m_enabled = true;
             m_parent = nullptr;
-            m_components = std::vector<Component*>();
-            m_children = std::vector<GameObject*>();
-            m_componentMap = std::unordered_map<Core::Guid, std::vector<Component*>::size_type>();
         }
 
-        GameObject::GameObject(const Core::Guid guid, const std::string name, Transform t, bool enabled)
-            : GameObject()
+        GameObject::GameObject(Scene* scene, const Core::Guid& guid, NameId name, const Transform& t, bool enabled)
+            : GameObject(scene)
         {
             m_guid = guid;
             m_name = name;
@@ -42,12 +57,53 @@ namespace Hatchit {
         {
             for (Component *component : m_components)
             {
-                delete component;
+                DestroyComponent(component);
             }
             for (GameObject* child : m_children)
             {
-                delete child;
+                DestroyChild(child);
             }
+
+            if (m_scene)
+                m_scene->UnregisterGameObject(this);
+        }
+
+        void GameObject::DestroyComponent(Component* component)
+        {
+            if (component == nullptr)
+                return;
+
+            if (m_scene)
+                m_scene->DestroyComponent(component);
+            else
+                delete component;
+        }
+
+        bool GameObject::RemoveComponent(ComponentTypeId component_id)
+        {
+            ComponentMap::const_iterator iter = m_componentMap.find(component_id);
+            if (iter == m_componentMap.cend())
+                return false;
+
+            ComponentList::size_type index = iter->second;
+            Component *component = m_components[index];
+            if (component->GetEnabled())
+                component->SetEnabled(false);
+            component->VOnDestroy();
+
+            m_components[index] = nullptr;
+            m_componentMap.erase(component_id);
+            DestroyComponent(component);
+
+            return true;
+        }
+
+        void GameObject::DestroyChild(GameObject* child)
+        {
+            if (m_scene)
+                m_scene->DestroyGameObject(child);
+            else
+                delete child;
         }
 
         const Core::Guid& GameObject::GetGuid(void) const
@@ -55,11 +111,31 @@ namespace Hatchit {
             return m_guid;
         }
 
+        ObjectId GameObject::GetId(void) const
+        {
+            return m_id;
+        }
+
         const std::string& GameObject::GetName(void) const
+        {
+            static const std::string unnamed;
+
+            if (m_scene == nullptr || m_name == InvalidNameId)
+                return unnamed;
+
+            return m_scene->m_names.GetString(m_name);
+        }
+
+        NameId GameObject::GetNameId(void) const
         {
             return m_name;
         }
 
+        Scene* GameObject::GetScene(void) const
+        {
+            return m_scene;
+        }
+
         Transform& GameObject::GetTransform(void)
         {
             return m_transform;
@@ -89,7 +165,7 @@ namespace Hatchit {
         {
             for (Component *component : m_components)
             {
-                if(component->GetEnabled())
+                if(component && component->GetEnabled())
                     component->VOnUpdate();
             }
 
@@ -103,7 +179,7 @@ namespace Hatchit {
                 // if an object is marked to be destroyed, delete it and increase the shift size
                 if (m_children[i]->m_destroyed)
                 {
-                    delete m_children[i];
+                    DestroyChild(m_children[i]);
                     shift++;
                 }
                 //if the object is fine to update, update it and then shift it back
@@ -120,9 +196,11 @@ namespace Hatchit {
 
         void GameObject::MarkForDestroy(void)
         {
-            //disable and "destroy" all components
+            //disable and "destroy" all components, unless they were never initialized
             for (Component *component : m_components)
             {
+                if (component == nullptr || !m_initialized)
+                    continue;
                 if (component->GetEnabled())
                     component->SetEnabled(false);
                 component->VOnDestroy();
@@ -136,13 +214,19 @@ namespace Hatchit {
             Disable();
             //destroy this object
             m_destroyed = true;
+            //a destroyed object can no longer be found by name
+            if (m_scene)
+                m_scene->RemoveFromNameIndex(this);
         }
 
         void GameObject::OnInit(void)
         {
+            m_initialized = true;
+
             for (Component *component : m_components)
             {
-                component->VOnInit();
+                if (component)
+                    component->VOnInit();
             }
 
             for (GameObject* obj : m_children)
@@ -172,6 +256,7 @@ namespace Hatchit {
         {
             if (std::find(m_children.begin(), m_children.end(), child) == m_children.end())
                 m_children.push_back(child);
+            child->m_parent = this;
             child->m_transform.m_parent = &m_transform;
         }
 
@@ -181,6 +266,7 @@ namespace Hatchit {
             if (iter != m_children.end())
                 m_children.erase(iter);
             child->m_parent = nullptr;
+            child->m_transform.m_parent = nullptr;
         }
 
         void GameObject::RemoveChildAtIndex(std::size_t index)
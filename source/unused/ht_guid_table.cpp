@@ -0,0 +1,89 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_guid_table.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        ObjectId GuidTable::Intern(const Core::Guid& guid)
+        {
+            std::unordered_map<Core::Guid, ObjectId>::const_iterator iter = m_ids.find(guid);
+            if (iter != m_ids.cend())
+                return iter->second;
+
+            ObjectId id;
+            if (!m_freeIds.empty())
+            {
+                id = m_freeIds.back();
+                m_freeIds.pop_back();
+                m_guids[id] = guid;
+            }
+            else
+            {
+                id = static_cast<ObjectId>(m_guids.size());
+                m_guids.push_back(guid);
+            }
+
+            m_ids.insert(std::make_pair(guid, id));
+            return id;
+        }
+
+        ObjectId GuidTable::Find(const Core::Guid& guid) const
+        {
+            std::unordered_map<Core::Guid, ObjectId>::const_iterator iter = m_ids.find(guid);
+            if (iter == m_ids.cend())
+                return InvalidObjectId;
+
+            return iter->second;
+        }
+
+        const Core::Guid& GuidTable::GetGuid(ObjectId id) const
+        {
+            return m_guids[id];
+        }
+
+        void GuidTable::Erase(ObjectId id)
+        {
+            if (id >= m_guids.size())
+                return;
+
+            std::unordered_map<Core::Guid, ObjectId>::const_iterator iter = m_ids.find(m_guids[id]);
+            if (iter == m_ids.cend() || iter->second != id)
+                return;
+
+            m_ids.erase(iter);
+            m_freeIds.push_back(id);
+        }
+
+        std::size_t GuidTable::Size(void) const
+        {
+            return m_guids.size();
+        }
+
+        void GuidTable::Reserve(std::size_t count)
+        {
+            m_guids.reserve(count);
+            m_ids.reserve(count);
+        }
+
+        void GuidTable::Clear(void)
+        {
+            m_guids.clear();
+            m_ids.clear();
+            m_freeIds.clear();
+        }
+    }
+}
@@ -0,0 +1,360 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_interest_manager.h>
+#include <ht_scene.h>
+#include <ht_scene_snapshot.h>
+#include <ht_gameobject.h>
+#include <ht_camera_component.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+
+            const std::vector<ObjectId> NoObjects;
+
+            // Cell coordinates are clamped well inside int32_t so neighbouring cells never overflow.
+            const float CellLimit = 1073741823.0f;
+
+            int32_t CellOf(float value, float inverseCellSize)
+            {
+                float cell = std::floor(value * inverseCellSize);
+                if (!(cell > -CellLimit))
+                    return -static_cast<int32_t>(CellLimit);
+                if (cell > CellLimit)
+                    return static_cast<int32_t>(CellLimit);
+                return static_cast<int32_t>(cell);
+            }
+
+            uint32_t HashCell(int32_t x, int32_t y, int32_t z)
+            {
+                return (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u) ^ (static_cast<uint32_t>(z) * 83492791u);
+            }
+        }
+
+        InterestManager::InterestManager(float cellSize)
+            : m_cellSize(cellSize),
+            m_hysteresis(0.1f),
+            m_query(0)
+        {
+        }
+
+        void InterestManager::SetCellSize(float cellSize)
+        {
+            if (cellSize > 0.0f)
+                m_cellSize = cellSize;
+        }
+
+        float InterestManager::GetCellSize(void) const
+        {
+            return m_cellSize;
+        }
+
+        void InterestManager::SetHysteresis(float fraction)
+        {
+            m_hysteresis = std::max(fraction, 0.0f);
+        }
+
+        ObserverId InterestManager::AddObserver(const Math::Vector3& position, float radius)
+        {
+            ObserverId id;
+            if (!m_freeObservers.empty())
+            {
+                id = m_freeObservers.back();
+                m_freeObservers.pop_back();
+            }
+            else
+            {
+                id = static_cast<ObserverId>(m_observers.size());
+                m_observers.emplace_back();
+            }
+
+            Observer& observer = m_observers[id];
+            observer.active = true;
+            observer.follow = InvalidObjectId;
+            observer.position = position;
+            observer.radius = radius;
+            observer.relevant.clear();
+            observer.entered.clear();
+            observer.left.clear();
+            return id;
+        }
+
+        ObserverId InterestManager::AddObserver(ObjectId follow, float radius)
+        {
+            ObserverId id = AddObserver(Math::Vector3(0.0f, 0.0f, 0.0f), radius);
+            m_observers[id].follow = follow;
+            return id;
+        }
+
+        void InterestManager::SetObserverPosition(ObserverId observer, const Math::Vector3& position)
+        {
+            if (observer >= m_observers.size() || !m_observers[observer].active)
+                return;
+
+            m_observers[observer].follow = InvalidObjectId;
+            m_observers[observer].position = position;
+        }
+
+        void InterestManager::SetObserverRadius(ObserverId observer, float radius)
+        {
+            if (observer < m_observers.size() && m_observers[observer].active)
+                m_observers[observer].radius = radius;
+        }
+
+        void InterestManager::RemoveObserver(ObserverId observer)
+        {
+            if (observer >= m_observers.size() || !m_observers[observer].active)
+                return;
+
+            m_observers[observer].active = false;
+            m_freeObservers.push_back(observer);
+        }
+
+        void InterestManager::Update(const Scene& scene)
+        {
+            scene.CollectLiveGameObjects(m_objects, m_parents, m_visited);
+
+            std::size_t count = m_objects.size();
+            m_positions.resize(count * 3);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                Math::Vector3 position = m_objects[i]->GetTransform().GetWorldPosition();
+                m_positions[i * 3 + 0] = position.x;
+                m_positions[i * 3 + 1] = position.y;
+                m_positions[i * 3 + 2] = position.z;
+            }
+
+            BuildGrid();
+
+            m_marks.assign(count, 0);
+            m_query = 0;
+
+            for (Observer& observer : m_observers)
+            {
+                if (!observer.active)
+                    continue;
+
+                if (observer.follow != InvalidObjectId)
+                {
+                    GameObject* followed = scene.FindGameObject(observer.follow);
+                    if (followed != nullptr)
+                    {
+                        observer.position = followed->GetTransform().GetWorldPosition();
+                        if (observer.radius <= 0.0f)
+                        {
+                            Camera* camera = followed->GetComponent<Camera>();
+                            if (camera != nullptr)
+                                observer.radius = camera->GetFarPlane();
+                        }
+                    }
+                }
+
+                Query(observer);
+            }
+        }
+
+        void InterestManager::BuildGrid(void)
+        {
+            std::size_t count = m_objects.size();
+            float inverse = 1.0f / m_cellSize;
+
+            std::size_t bucket_count = 64;
+            while (bucket_count < count * 2)
+                bucket_count <<= 1;
+            uint32_t mask = static_cast<uint32_t>(bucket_count - 1);
+
+            // Counting sort of the GameObjects by bucket.
+            m_cells.resize(count * 3);
+            m_bucketStart.assign(bucket_count + 1, 0);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                int32_t* cell = &m_cells[i * 3];
+                cell[0] = CellOf(m_positions[i * 3 + 0], inverse);
+                cell[1] = CellOf(m_positions[i * 3 + 1], inverse);
+                cell[2] = CellOf(m_positions[i * 3 + 2], inverse);
+                m_bucketStart[(HashCell(cell[0], cell[1], cell[2]) & mask) + 1]++;
+            }
+
+            for (std::size_t b = 0; b < bucket_count; b++)
+                m_bucketStart[b + 1] += m_bucketStart[b];
+
+            m_bucketObjects.resize(count);
+            std::vector<uint32_t> next(m_bucketStart.begin(), m_bucketStart.end() - 1);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                const int32_t* cell = &m_cells[i * 3];
+                m_bucketObjects[next[HashCell(cell[0], cell[1], cell[2]) & mask]++] = static_cast<uint32_t>(i);
+            }
+        }
+
+        void InterestManager::Query(Observer& observer)
+        {
+            m_query++;
+            m_scratch.clear();
+
+            float radius = std::max(observer.radius, 0.0f);
+            float outer = radius * (1.0f + m_hysteresis);
+            float inner_squared = radius * radius;
+            float outer_squared = outer * outer;
+            float px = observer.position.x;
+            float py = observer.position.y;
+            float pz = observer.position.z;
+
+            auto test = [&](uint32_t index)
+            {
+                const float* position = &m_positions[index * 3];
+                float dx = position[0] - px;
+                float dy = position[1] - py;
+                float dz = position[2] - pz;
+                float distance_squared = dx * dx + dy * dy + dz * dz;
+                if (distance_squared > outer_squared)
+                    return;
+
+                // Between the radius and the widened radius only GameObjects already relevant stay.
+                if (distance_squared > inner_squared &&
+                    !std::binary_search(observer.relevant.begin(), observer.relevant.end(), m_objects[index]->GetId()))
+                    return;
+
+                Mark(index);
+            };
+
+            float inverse = 1.0f / m_cellSize;
+            int32_t min_x = CellOf(px - outer, inverse), max_x = CellOf(px + outer, inverse);
+            int32_t min_y = CellOf(py - outer, inverse), max_y = CellOf(py + outer, inverse);
+            int32_t min_z = CellOf(pz - outer, inverse), max_z = CellOf(pz + outer, inverse);
+
+            double cell_count = (double(max_x) - min_x + 1) * (double(max_y) - min_y + 1) * (double(max_z) - min_z + 1);
+            if (cell_count >= static_cast<double>(m_objects.size()))
+            {
+                // The sphere covers more cells than there are GameObjects; testing them all is cheaper.
+                for (uint32_t i = 0; i < m_objects.size(); i++)
+                    test(i);
+            }
+            else
+            {
+                uint32_t mask = static_cast<uint32_t>(m_bucketStart.size() - 2);
+                for (int32_t z = min_z; z <= max_z; z++)
+                {
+                    for (int32_t y = min_y; y <= max_y; y++)
+                    {
+                        for (int32_t x = min_x; x <= max_x; x++)
+                        {
+                            uint32_t bucket = HashCell(x, y, z) & mask;
+                            for (uint32_t b = m_bucketStart[bucket]; b < m_bucketStart[bucket + 1]; b++)
+                            {
+                                // Other cells may share the bucket; only take GameObjects from this one.
+                                uint32_t index = m_bucketObjects[b];
+                                const int32_t* cell = &m_cells[index * 3];
+                                if (cell[0] == x && cell[1] == y && cell[2] == z)
+                                    test(index);
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::sort(m_scratch.begin(), m_scratch.end());
+
+            observer.entered.clear();
+            observer.left.clear();
+            std::set_difference(m_scratch.begin(), m_scratch.end(), observer.relevant.begin(), observer.relevant.end(),
+                std::back_inserter(observer.entered));
+            std::set_difference(observer.relevant.begin(), observer.relevant.end(), m_scratch.begin(), m_scratch.end(),
+                std::back_inserter(observer.left));
+            observer.relevant.swap(m_scratch);
+        }
+
+        void InterestManager::Mark(uint32_t index)
+        {
+            // Stop at the first ancestor already marked; its own ancestors were marked with it.
+            while (index != UINT32_MAX && m_marks[index] != m_query)
+            {
+                m_marks[index] = m_query;
+                m_scratch.push_back(m_objects[index]->GetId());
+                index = m_parents[index];
+            }
+        }
+
+        const std::vector<ObjectId>& InterestManager::GetRelevant(ObserverId observer) const
+        {
+            return (observer < m_observers.size() && m_observers[observer].active) ? m_observers[observer].relevant : NoObjects;
+        }
+
+        const std::vector<ObjectId>& InterestManager::GetEntered(ObserverId observer) const
+        {
+            return (observer < m_observers.size() && m_observers[observer].active) ? m_observers[observer].entered : NoObjects;
+        }
+
+        const std::vector<ObjectId>& InterestManager::GetLeft(ObserverId observer) const
+        {
+            return (observer < m_observers.size() && m_observers[observer].active) ? m_observers[observer].left : NoObjects;
+        }
+
+        bool InterestManager::IsRelevant(ObserverId observer, ObjectId id) const
+        {
+            const std::vector<ObjectId>& relevant = GetRelevant(observer);
+            return std::binary_search(relevant.begin(), relevant.end(), id);
+        }
+
+        void InterestManager::Filter(ObserverId observer, const SceneState& state, SceneState& out) const
+        {
+            const std::vector<ObjectId>& relevant = GetRelevant(observer);
+
+            out.Clear();
+            out.typeNames = state.typeNames;
+            out.layoutHashes = state.layoutHashes;
+            out.componentOffsets.push_back(0);
+
+            std::vector<uint32_t> remap(state.ObjectCount(), UINT32_MAX);
+            uint32_t first = 0;
+            for (std::size_t i = 0; i < state.ObjectCount(); i++)
+            {
+                uint32_t component_count = state.componentCounts[i];
+                uint32_t last = first + component_count;
+
+                if (std::binary_search(relevant.begin(), relevant.end(), state.ids[i]))
+                {
+                    remap[i] = static_cast<uint32_t>(out.ids.size());
+
+                    out.ids.push_back(state.ids[i]);
+                    out.guids.push_back(state.guids[i]);
+                    out.prefabs.push_back(state.prefabs[i]);
+                    out.names.push_back(state.names[i]);
+                    out.parents.push_back((state.parents[i] != UINT32_MAX) ? remap[state.parents[i]] : UINT32_MAX);
+                    out.flags.push_back(state.flags[i]);
+                    out.transforms.insert(out.transforms.end(), state.transforms.begin() + i * 9, state.transforms.begin() + i * 9 + 9);
+                    out.componentCounts.push_back(component_count);
+
+                    out.componentTypes.insert(out.componentTypes.end(), state.componentTypes.begin() + first, state.componentTypes.begin() + last);
+                    out.componentEnabled.insert(out.componentEnabled.end(), state.componentEnabled.begin() + first, state.componentEnabled.begin() + last);
+                    for (uint32_t c = first; c < last; c++)
+                    {
+                        out.componentData.insert(out.componentData.end(), state.componentData.begin() + state.componentOffsets[c],
+                            state.componentData.begin() + state.componentOffsets[c + 1]);
+                        out.componentOffsets.push_back(static_cast<uint32_t>(out.componentData.size()));
+                    }
+                }
+
+                first = last;
+            }
+        }
+    }
+}
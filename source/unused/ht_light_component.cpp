@@ -25,7 +25,10 @@
 
 #include <unordered_map>
 #include <ht_gameobject.h>
+#include <ht_scene.h>
 #include <ht_light_component.h>
+#include <ht_component_registry.h>
+#include <ht_asset_prefetcher.h>
 #include <ht_shadervariablechunk.h>
 #include <ht_renderer_singleton.h>
 #include <ht_debug.h>
@@ -34,7 +37,31 @@ namespace Hatchit {
 
     namespace Game {
 
+        HT_REGISTER_COMPONENT_WITH_ASSETS_AND_FLAGS(LightComponent, &LightComponent::GatherAssets, ComponentRegistry::MAIN_THREAD_TEARDOWN);
+
+        LightComponent::Parameters::Parameters(void)
+            : lightType(LightType::POINT_LIGHT),
+            assetsLoaded(false),
+            radius(0.0f),
+            color(1, 1, 1, 1)
+        {
+        }
+
         LightComponent::LightComponent()
+            : m_parameters(CowPtr<Parameters>::Make()),
+            m_meshRenderer(nullptr),
+            m_data(nullptr),
+            m_layer(1)
+        {
+
+        }
+
+        LightComponent::LightComponent(const LightComponent& other)
+            : Component(other),
+            m_parameters(other.m_parameters),
+            m_meshRenderer(nullptr),
+            m_data(nullptr),
+            m_layer(other.m_layer)
         {
 
         }
@@ -52,12 +79,16 @@ namespace Hatchit {
         */
         bool LightComponent::VDeserialize(const Core::JSON& jsonObject)
         {
+            Core::JsonExtract<uint32_t>(jsonObject, "Layer", m_layer);
+
             int lightType;
             if (Core::JsonExtract<int32_t>(jsonObject, "LightType", lightType)) 
             {
+                Parameters& parameters = m_parameters.Write();
+
                 if (lightType == LightType::POINT_LIGHT)
                 {
-                    if (!Core::JsonExtract<float>(jsonObject, "Radius", m_radius))
+                    if (!Core::JsonExtract<float>(jsonObject, "Radius", parameters.radius))
                         return false;
 
                     Core::JSON attenuationJSON = jsonObject["Attenuation"];
@@ -65,7 +96,7 @@ namespace Hatchit {
                         return false;
 
                     for (size_t i = 0; i < attenuationJSON.size(); i++)
-                        m_attenuation[static_cast<int>(i)] = attenuationJSON[i];
+                        parameters.attenuation[static_cast<int>(i)] = attenuationJSON[i];
                 }
 
                 if (lightType == LightType::DIRECTIONAL_LIGHT || lightType == LightType::SPOT_LIGHT)
@@ -75,24 +106,25 @@ namespace Hatchit {
                         return false;
 
                     for (size_t i = 0; i < directionJSON.size(); i++)
-                        m_direction[static_cast<int>(i)] = directionJSON[i];
+                        parameters.direction[static_cast<int>(i)] = directionJSON[i];
 
-                    m_direction = Math::MMVector3Normalized(m_direction);
+                    parameters.direction = Math::MMVector3Normalized(parameters.direction);
                 }
 
                 //Always parse color; Use white if not defined
                 Core::JSON colorJSON = jsonObject["Color"];
                 if (colorJSON.size() <= 0)
                 {
-                    m_color = { 1, 1, 1, 1 };
+                    parameters.color = { 1, 1, 1, 1 };
                 }
                 else
                 {
                     for (size_t i = 0; i < colorJSON.size(); i++)
-                        m_color[i] = colorJSON[i];
+                        parameters.color[i] = colorJSON[i];
                 }
 
-                m_lightType = LightType(lightType);
+                // Loaded here, once for every instance sharing the parameters.
+                SetType(LightType(lightType));
             }
 
             return true;
@@ -104,24 +136,38 @@ namespace Hatchit {
         */
         void LightComponent::SetType(LightType lightType)
         {
-            m_lightType = lightType;
-            switch (lightType)
+            Parameters& parameters = m_parameters.Write();
+            parameters.lightType = lightType;
+
+            const char* meshFile;
+            const char* materialFile;
+            if (!Renderer::IsHeadless() && GetLightAssets(lightType, meshFile, materialFile))
+                SetMeshAndMaterial(meshFile, materialFile);
+            parameters.assetsLoaded = true;
+
+            if (m_meshRenderer != nullptr)
             {
-                case LightType::POINT_LIGHT:
-                {
-                    SetMeshAndMaterial("IcoSphere.dae", "PointLightMaterial.json");
-                    break;
-                }
-                case LightType::DIRECTIONAL_LIGHT:
-                {
-                    SetMeshAndMaterial("Tri.obj", "DirectionalLightMaterial.json");
-                    break;
-                }
-                case LightType::SPOT_LIGHT:
-                    break;
+                m_meshRenderer->SetMesh(parameters.mesh);
+                m_meshRenderer->SetMaterial(parameters.material);
+            }
+        }
+
+        /**
+        * \brief Reports the mesh and material used to draw the light described by jsonObject.
+        */
+        void LightComponent::GatherAssets(const Core::JSON& jsonObject, AssetPrefetcher& prefetcher)
+        {
+            int lightType;
+            if (Renderer::IsHeadless() || !Core::JsonExtract<int32_t>(jsonObject, "LightType", lightType))
+                return;
+
+            const char* meshFile;
+            const char* materialFile;
+            if (GetLightAssets(LightType(lightType), meshFile, materialFile))
+            {
+                prefetcher.AddMesh(meshFile);
+                prefetcher.AddMaterial(materialFile);
             }
-            m_meshRenderer->SetMesh(m_mesh);
-            m_meshRenderer->SetMaterial(m_material);
         }
 
         /**
@@ -129,32 +175,37 @@ namespace Hatchit {
         */
         void LightComponent::VOnInit()
         {
-            m_meshRenderer = new Graphics::MeshRenderer(Renderer::GetRenderer());
+            if (m_data != nullptr)
+                return;
+
+            const Parameters& parameters = *m_parameters;
+            if (!Renderer::IsHeadless())
+                m_meshRenderer = new Graphics::MeshRenderer(Renderer::GetRenderer());
 
             std::vector<Resource::ShaderVariable*> variables;
             
             //First var of every light is the transform
-            if (m_lightType == LightType::POINT_LIGHT || m_lightType == LightType::SPOT_LIGHT)
+            if (parameters.lightType == LightType::POINT_LIGHT || parameters.lightType == LightType::SPOT_LIGHT)
             {
                 Resource::Matrix4Variable* transform = new Resource::Matrix4Variable(Math::Matrix4());
                 variables.push_back(transform);
             }
 
-            Resource::Float4Variable* color = new Resource::Float4Variable(m_color);
+            Resource::Float4Variable* color = new Resource::Float4Variable(parameters.color);
             variables.push_back(color);
 
-            if (m_lightType == LightType::POINT_LIGHT)
+            if (parameters.lightType == LightType::POINT_LIGHT)
             {
-                Resource::FloatVariable* radius = new Resource::FloatVariable(m_radius);
-                Resource::Float3Variable* atten = new Resource::Float3Variable(m_attenuation);
+                Resource::FloatVariable* radius = new Resource::FloatVariable(parameters.radius);
+                Resource::Float3Variable* atten = new Resource::Float3Variable(parameters.attenuation);
 
                 variables.push_back(radius);
                 variables.push_back(atten);
             }
 
-            if (m_lightType == LightType::DIRECTIONAL_LIGHT || m_lightType == LightType::SPOT_LIGHT)
+            if (parameters.lightType == LightType::DIRECTIONAL_LIGHT || parameters.lightType == LightType::SPOT_LIGHT)
             {
-                Resource::Float3Variable* direction = new Resource::Float3Variable(m_direction);
+                Resource::Float3Variable* direction = new Resource::Float3Variable(parameters.direction);
 
                 variables.push_back(direction);
             }
@@ -165,7 +216,14 @@ namespace Hatchit {
             for (size_t i = 0; i < variables.size(); i++)
                 delete variables[i];
 
-            SetType(m_lightType);
+            // Lights that were never deserialized load their assets now.
+            if (!parameters.assetsLoaded)
+                SetType(parameters.lightType);
+            else if (m_meshRenderer != nullptr)
+            {
+                m_meshRenderer->SetMesh(parameters.mesh);
+                m_meshRenderer->SetMaterial(parameters.material);
+            }
             
             HT_DEBUG_PRINTF("Initialized Light Component.\n");
         }
@@ -177,10 +235,21 @@ namespace Hatchit {
         void LightComponent::VOnUpdate()
         {
             //0 is the beginning of the instance data array
-            if (m_lightType == LightType::POINT_LIGHT || m_lightType == LightType::SPOT_LIGHT)
-                m_data->SetMatrix4(0, Hatchit::Math::MMMatrixTranspose(*m_owner->GetTransform().GetWorldMatrix()));
-            m_meshRenderer->SetInstanceData(m_data);
-            m_meshRenderer->Render();
+            if (m_data == nullptr)
+                return;
+
+            const Parameters& parameters = *m_parameters;
+            Transform& t = m_owner->GetTransform();
+            if (parameters.lightType == LightType::POINT_LIGHT || parameters.lightType == LightType::SPOT_LIGHT)
+                m_data->SetMatrix4(0, Hatchit::Math::MMMatrixTranspose(*t.GetWorldMatrix()));
+
+            Scene* scene = m_owner->GetScene();
+            if (scene == nullptr)
+                return;
+
+            //point lights only reach as far as their radius; other lights are never culled
+            float radius = (parameters.lightType == LightType::POINT_LIGHT) ? parameters.radius * RenderQueue::GetBoundsScale(*m_owner) : 0.0f;
+            scene->GetRenderQueue().AddDraw(m_meshRenderer, m_data, t.GetWorldPosition(), radius, m_layer, RenderQueue::Pass::LIGHT_PASS);
         }
 
         /**
@@ -202,6 +271,15 @@ namespace Hatchit {
             return Component::GetComponentId<LightComponent>();
         }
 
+        /**
+        * \brief Retrieves the dense runtime id associated with this class of Component.
+        * \return The ComponentTypeId associated with this Component type.
+        */
+        ComponentTypeId LightComponent::VGetComponentTypeId(void) const
+        {
+            return Component::GetComponentTypeId<LightComponent>();
+        }
+
         /**
         * \brief Called when the Component is enabled.
         * This happens when a scene has finished loading, or immediately after creation if the scene is already loaded.
@@ -229,6 +307,9 @@ namespace Hatchit {
         void LightComponent::VOnDestroy()
         {
             delete m_meshRenderer;
+            delete m_data;
+            m_meshRenderer = nullptr;
+            m_data = nullptr;
             HT_DEBUG_PRINTF("Destroyed LightComponent Component.\n");
         }
 
@@ -239,10 +320,40 @@ namespace Hatchit {
         */
         bool LightComponent::SetMeshAndMaterial(std::string meshFile, std::string materialFile)
         {
-            m_mesh = Graphics::Mesh::GetHandle(meshFile, meshFile);
-            m_material = Graphics::Material::GetHandle(materialFile, materialFile);
+            Parameters& parameters = m_parameters.Write();
+            parameters.mesh = Graphics::Mesh::GetHandle(meshFile, meshFile);
+            parameters.material = Graphics::Material::GetHandle(materialFile, materialFile);
 
             return true;
         }
+
+        /**
+        * \brief Gets the mesh and material files used to draw a type of light.
+        * \param lightType     The type of light.
+        * \param meshFile      Set to the mesh file name.
+        * \param materialFile  Set to the material file name.
+        * \return false if the light type has no mesh.
+        */
+        bool LightComponent::GetLightAssets(LightType lightType, const char*& meshFile, const char*& materialFile)
+        {
+            switch (lightType)
+            {
+                case LightType::POINT_LIGHT:
+                {
+                    meshFile = "IcoSphere.dae";
+                    materialFile = "PointLightMaterial.json";
+                    return true;
+                }
+                case LightType::DIRECTIONAL_LIGHT:
+                {
+                    meshFile = "Tri.obj";
+                    materialFile = "DirectionalLightMaterial.json";
+                    return true;
+                }
+                case LightType::SPOT_LIGHT:
+                default:
+                    return false;
+            }
+        }
     }
 }
@@ -22,10 +22,13 @@
 #endif
 
 #include <ht_meshrenderer_component.h>
+#include <ht_component_registry.h>
+#include <ht_asset_prefetcher.h>
 #include <ht_shadervariablechunk.h>
 #include <ht_renderer_singleton.h>
 #include <ht_debug.h>
 #include <ht_gameobject.h>
+#include <ht_scene.h>
 
 #include <ht_gpuresourcepool.h>
 
@@ -33,10 +36,48 @@ namespace Hatchit {
 
     namespace Game {
 
-     
+        HT_REGISTER_COMPONENT_WITH_ASSETS_AND_FLAGS(MeshRenderer, &MeshRenderer::GatherAssets, ComponentRegistry::MAIN_THREAD_TEARDOWN);
+
+        MeshRenderer::Renderable::Renderable(void)
+            : batch(0)
+        {
+            // A headless Renderer has nothing to draw with.
+            meshRenderer = Renderer::IsHeadless() ? nullptr : new Graphics::MeshRenderer(Renderer::GetRenderer());
+        }
+
+        MeshRenderer::Renderable::Renderable(const Renderable& other)
+            : mesh(other.mesh),
+            material(other.material),
+            batch(other.batch)
+        {
+            meshRenderer = nullptr;
+            if (Renderer::IsHeadless())
+                return;
+
+            meshRenderer = new Graphics::MeshRenderer(Renderer::GetRenderer());
+            meshRenderer->SetMesh(mesh);
+            meshRenderer->SetMaterial(material);
+        }
+
+        MeshRenderer::Renderable::~Renderable(void)
+        {
+            delete meshRenderer;
+        }
+
         MeshRenderer::MeshRenderer()
+            : m_boundsRadius(0.0f),
+            m_layer(1),
+            m_transparent(false)
+        {
+        }
+
+        MeshRenderer::MeshRenderer(const MeshRenderer& other)
+            : Component(other),
+            m_renderable(other.m_renderable),
+            m_boundsRadius(other.m_boundsRadius),
+            m_layer(other.m_layer),
+            m_transparent(other.m_transparent)
         {
-            m_meshRenderer = new Graphics::MeshRenderer(Renderer::GetRenderer());
         }
 
         Core::JSON MeshRenderer::VSerialize(void)
@@ -58,11 +99,21 @@ namespace Hatchit {
             {
                 return false;
             }
-            
-            MaterialHandle material = Material::GetHandle(materialFile, materialFile);
+
+            //optional culling and sorting data; without bounds the mesh is never culled
+            Core::JsonExtract<float>(jsonObject, "BoundsRadius", m_boundsRadius);
+            Core::JsonExtract<uint32_t>(jsonObject, "Layer", m_layer);
+            Core::JsonExtract<bool>(jsonObject, "Transparent", m_transparent);
 
             //all data has been successfully parsed, attempt to set it all up...
 
+            //a headless Renderer loads no GPU assets, but still batches by file
+            if (Renderer::IsHeadless())
+            {
+                m_renderable.Write().batch = RenderQueue::GetBatchId(meshFile, materialFile);
+                return true;
+            }
+
             //get appropriate resource handles
             Graphics::MeshHandle mesh;
             Graphics::MaterialHandle mat;
@@ -86,43 +137,65 @@ namespace Hatchit {
             //        return false;
             //}
             //
-            SetRenderable(mesh, mat);
-
-
-
-            //setup instance data
-            Resource::Matrix4Variable* temp = new Resource::Matrix4Variable(Math::Matrix4());
-            std::vector<Resource::ShaderVariable*> variables;
-            variables.push_back(temp);
-            m_instanceData = new ShaderVariableChunk(variables);
-            delete temp;
+            //the same files load the same resources, so renderers using them can be batched together
+            AssignRenderable(mesh, mat, RenderQueue::GetBatchId(meshFile, materialFile));
 
+            return true;
+        }
 
+        void MeshRenderer::GatherAssets(const Core::JSON& jsonObject, AssetPrefetcher& prefetcher)
+        {
+            if (Renderer::IsHeadless())
+                return;
 
-            return true;
+            std::string materialFile;
+            std::string meshFile;
+            if (Core::JsonExtract<std::string>(jsonObject, "Material", materialFile))
+                prefetcher.AddMaterial(materialFile);
+            if (Core::JsonExtract<std::string>(jsonObject, "Mesh", meshFile))
+                prefetcher.AddMesh(meshFile);
         }
 
         void MeshRenderer::SetRenderable(Graphics::MeshHandle mesh,
             Graphics::MaterialHandle material)
         {
-            m_meshRenderer->SetMesh(mesh);
-            m_meshRenderer->SetMaterial(material);
+            AssignRenderable(mesh, material, RenderQueue::NewBatchId());
+        }
+
+        void MeshRenderer::AssignRenderable(Graphics::MeshHandle mesh,
+            Graphics::MaterialHandle material, uint64_t batch)
+        {
+            Renderable& renderable = m_renderable.Write();
+            renderable.mesh = mesh;
+            renderable.material = material;
+            renderable.batch = batch;
+            if (renderable.meshRenderer == nullptr)
+                return;
+
+            renderable.meshRenderer->SetMesh(mesh);
+            renderable.meshRenderer->SetMaterial(material);
         }
 
         void MeshRenderer::VOnInit()
         {
             //Graphics::RendererType rendererType = Renderer::GetRendererType();
-            //m_meshRenderer = new Graphics::MeshRenderer();
 
             HT_DEBUG_PRINTF("Initialized Mesh Renderer Component.\n");
         }
 
         void MeshRenderer::VOnUpdate()
         {
-            //TODO: send actual transform data
-            m_instanceData->SetMatrix4(0, Hatchit::Math::MMMatrixTranspose(*m_owner->GetTransform().GetWorldMatrix()));
-            m_meshRenderer->SetInstanceData(m_instanceData);
-            m_meshRenderer->Render();
+            Scene* scene = m_owner->GetScene();
+            if (!m_renderable || scene == nullptr)
+                return;
+
+            Transform& t = m_owner->GetTransform();
+
+            //drawn by the scene, batched with every visible instance of the same mesh and material
+            float radius = (m_boundsRadius > 0.0f) ? m_boundsRadius * RenderQueue::GetBoundsScale(*m_owner) : 0.0f;
+            scene->GetRenderQueue().AddInstance(m_renderable->meshRenderer, m_renderable->batch,
+                Hatchit::Math::MMMatrixTranspose(*t.GetWorldMatrix()), t.GetWorldPosition(), radius, m_layer,
+                m_transparent ? RenderQueue::Pass::TRANSPARENT_PASS : RenderQueue::Pass::OPAQUE_PASS);
         }
 
         Component* MeshRenderer::VClone(void) const
@@ -141,6 +214,15 @@ namespace Hatchit {
             return Component::GetComponentId<MeshRenderer>();
         }
 
+        /**
+        * \brief Retrieves the dense runtime id associated with this class of Component.
+        * \return The ComponentTypeId associated with this Component type.
+        */
+        ComponentTypeId MeshRenderer::VGetComponentTypeId(void) const
+        {
+            return Component::GetComponentTypeId<MeshRenderer>();
+        }
+
         void MeshRenderer::VOnEnabled()
         {
             HT_DEBUG_PRINTF("Enabled MeshRenderer Component.\n");
@@ -153,7 +235,8 @@ namespace Hatchit {
 
         void MeshRenderer::VOnDestroy()
         {
-            delete m_meshRenderer;
+            // The shared renderer goes with the last instance referencing it.
+            m_renderable.Reset();
             HT_DEBUG_PRINTF("Destroyed MeshRenderer Component.\n");
         }
 
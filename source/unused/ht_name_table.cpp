@@ -0,0 +1,73 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_name_table.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        NameTable::NameTable(const NameTable& rhs)
+            : m_ids(rhs.m_ids), m_strings(rhs.m_strings.size(), nullptr)
+        {
+            // m_strings points into m_ids, so it is rebuilt against this table's own copy.
+            for (const std::pair<const std::string, NameId>& entry : m_ids)
+                m_strings[entry.second] = &entry.first;
+        }
+
+        NameTable& NameTable::operator=(const NameTable& rhs)
+        {
+            if (this != &rhs)
+                *this = NameTable(rhs);
+            return *this;
+        }
+
+        NameId NameTable::Intern(const std::string& name)
+        {
+            std::unordered_map<std::string, NameId>::const_iterator iter = m_ids.find(name);
+            if (iter != m_ids.cend())
+                return iter->second;
+
+            NameId id = static_cast<NameId>(m_strings.size());
+            iter = m_ids.insert(std::make_pair(name, id)).first;
+            m_strings.push_back(&iter->first);
+            return id;
+        }
+
+        NameId NameTable::Find(const std::string& name) const
+        {
+            std::unordered_map<std::string, NameId>::const_iterator iter = m_ids.find(name);
+            if (iter == m_ids.cend())
+                return InvalidNameId;
+
+            return iter->second;
+        }
+
+        const std::string& NameTable::GetString(NameId id) const
+        {
+            return *m_strings[id];
+        }
+
+        std::size_t NameTable::Size(void) const
+        {
+            return m_strings.size();
+        }
+
+        void NameTable::Clear(void)
+        {
+            m_strings.clear();
+            m_ids.clear();
+        }
+    }
+}
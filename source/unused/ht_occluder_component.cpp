@@ -0,0 +1,121 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_occluder_component.h>
+#include <ht_component_registry.h>
+#include <ht_gameobject.h>
+#include <ht_scene.h>
+#include <ht_debug.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        HT_REGISTER_COMPONENT_WITH_FLAGS(Occluder, ComponentRegistry::TRIVIAL_TEARDOWN);
+
+        Occluder::Occluder(void)
+            : m_extents(0.5f, 0.5f, 0.5f),
+            m_layer(1)
+        {
+        }
+
+        Core::JSON Occluder::VSerialize(void)
+        {
+            return Core::JSON();
+        }
+
+        bool Occluder::VDeserialize(const Core::JSON& jsonObject)
+        {
+            Core::JSON::const_iterator extents = jsonObject.find("Extents");
+            if (extents == jsonObject.cend() || !extents->is_array() || extents->size() != 3)
+            {
+                HT_DEBUG_PRINTF("Occluder::VDeserialize: Extents must be an array of 3 numbers.\n");
+                return false;
+            }
+
+            for (size_t i = 0; i < 3; i++)
+                m_extents[static_cast<int>(i)] = (*extents)[i];
+
+            Core::JsonExtract<uint32_t>(jsonObject, "Layer", m_layer);
+            return true;
+        }
+
+        void Occluder::VOnInit()
+        {
+            HT_DEBUG_PRINTF("Initialized Occluder Component.\n");
+        }
+
+        void Occluder::VOnUpdate()
+        {
+            Scene* scene = m_owner->GetScene();
+            if (scene == nullptr)
+                return;
+
+            // The box is transformed by the world matrix, so the scale and rotation of every parent apply.
+            const Math::Matrix4& world = *m_owner->GetTransform().GetWorldMatrix();
+
+            // Corner i lies on the positive side of axis j when bit j of i is set.
+            Math::Vector3 corners[8];
+            for (int i = 0; i < 8; i++)
+            {
+                corners[i] = world * Math::Vector4((i & 1) ? m_extents.x : -m_extents.x,
+                                                   (i & 2) ? m_extents.y : -m_extents.y,
+                                                   (i & 4) ? m_extents.z : -m_extents.z, 1);
+            }
+
+            scene->GetRenderQueue().AddOccluder(corners, m_layer);
+        }
+
+        Component* Occluder::VClone(void) const
+        {
+            HT_DEBUG_PRINTF("Cloned Occluder.\n");
+            return new Occluder(*this);
+        }
+
+        Core::Guid Occluder::VGetComponentId(void) const
+        {
+            return Component::GetComponentId<Occluder>();
+        }
+
+        ComponentTypeId Occluder::VGetComponentTypeId(void) const
+        {
+            return Component::GetComponentTypeId<Occluder>();
+        }
+
+        void Occluder::SetExtents(const Math::Vector3& extents)
+        {
+            m_extents = extents;
+        }
+
+        const Math::Vector3& Occluder::GetExtents(void) const
+        {
+            return m_extents;
+        }
+
+        void Occluder::VOnEnabled()
+        {
+            HT_DEBUG_PRINTF("Enabled Occluder Component.\n");
+        }
+
+        void Occluder::VOnDisabled()
+        {
+            HT_DEBUG_PRINTF("Disabled Occluder Component.\n");
+        }
+
+        void Occluder::VOnDestroy()
+        {
+            HT_DEBUG_PRINTF("Destroyed Occluder Component.\n");
+        }
+    }
+}
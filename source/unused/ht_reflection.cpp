@@ -0,0 +1,364 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_reflection.h>
+#include <ht_state_hash.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+
+            uint64_t HashBytes(uint64_t hash, const void* data, std::size_t length)
+            {
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                for (std::size_t i = 0; i < length; i++)
+                {
+                    hash ^= bytes[i];
+                    hash *= 1099511628211ULL;
+                }
+                return hash;
+            }
+
+            int64_t LoadInt(const uint8_t* memory, uint32_t size)
+            {
+                switch (size)
+                {
+                    case 1: { int8_t value; std::memcpy(&value, memory, 1); return value; }
+                    case 2: { int16_t value; std::memcpy(&value, memory, 2); return value; }
+                    case 4: { int32_t value; std::memcpy(&value, memory, 4); return value; }
+                    default: { int64_t value; std::memcpy(&value, memory, 8); return value; }
+                }
+            }
+
+            uint64_t LoadUInt(const uint8_t* memory, uint32_t size)
+            {
+                switch (size)
+                {
+                    case 1: { uint8_t value; std::memcpy(&value, memory, 1); return value; }
+                    case 2: { uint16_t value; std::memcpy(&value, memory, 2); return value; }
+                    case 4: { uint32_t value; std::memcpy(&value, memory, 4); return value; }
+                    default: { uint64_t value; std::memcpy(&value, memory, 8); return value; }
+                }
+            }
+
+            void StoreInt(uint8_t* memory, uint32_t size, int64_t value)
+            {
+                switch (size)
+                {
+                    case 1: { int8_t narrow = static_cast<int8_t>(value); std::memcpy(memory, &narrow, 1); break; }
+                    case 2: { int16_t narrow = static_cast<int16_t>(value); std::memcpy(memory, &narrow, 2); break; }
+                    case 4: { int32_t narrow = static_cast<int32_t>(value); std::memcpy(memory, &narrow, 4); break; }
+                    default: std::memcpy(memory, &value, 8); break;
+                }
+            }
+
+            void StoreUInt(uint8_t* memory, uint32_t size, uint64_t value)
+            {
+                switch (size)
+                {
+                    case 1: { uint8_t narrow = static_cast<uint8_t>(value); std::memcpy(memory, &narrow, 1); break; }
+                    case 2: { uint16_t narrow = static_cast<uint16_t>(value); std::memcpy(memory, &narrow, 2); break; }
+                    case 4: { uint32_t narrow = static_cast<uint32_t>(value); std::memcpy(memory, &narrow, 4); break; }
+                    default: std::memcpy(memory, &value, 8); break;
+                }
+            }
+        }
+
+        TypeDescriptor::TypeDescriptor(const char* name, std::initializer_list<FieldDescriptor> fields)
+            : m_name(name),
+            m_fields(fields),
+            m_layoutHash(14695981039346656037ULL)
+        {
+            std::vector<Span> spans;
+            for (const FieldDescriptor& field : m_fields)
+            {
+                m_layoutHash = HashBytes(m_layoutHash, field.name, std::strlen(field.name));
+                m_layoutHash = HashBytes(m_layoutHash, &field.offset, sizeof(field.offset));
+                m_layoutHash = HashBytes(m_layoutHash, &field.size, sizeof(field.size));
+                m_layoutHash = HashBytes(m_layoutHash, &field.type, sizeof(field.type));
+
+                switch (field.type)
+                {
+                    case FieldType::String:
+                        m_strings.push_back(field.offset);
+                        break;
+
+                    case FieldType::Struct:
+                        // Nested descriptors are already flattened, so splice in their runs.
+                        m_layoutHash = HashBytes(m_layoutHash, &field.nested->m_layoutHash, sizeof(uint64_t));
+                        for (const Span& span : field.nested->m_spans)
+                            spans.push_back(Span{ field.offset + span.offset, span.size });
+                        for (uint32_t offset : field.nested->m_strings)
+                            m_strings.push_back(field.offset + offset);
+                        break;
+
+                    default:
+                        spans.push_back(Span{ field.offset, field.size });
+                        break;
+                }
+            }
+
+            // Merge runs that touch. Padding between fields is never included, so
+            // the binary form does not depend on uninitialized bytes.
+            std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.offset < b.offset; });
+            for (const Span& span : spans)
+            {
+                if (!m_spans.empty() && m_spans.back().offset + m_spans.back().size == span.offset)
+                    m_spans.back().size += span.size;
+                else
+                    m_spans.push_back(span);
+            }
+
+            std::sort(m_strings.begin(), m_strings.end());
+        }
+
+        const char* TypeDescriptor::GetName(void) const
+        {
+            return m_name;
+        }
+
+        const std::vector<FieldDescriptor>& TypeDescriptor::GetFields(void) const
+        {
+            return m_fields;
+        }
+
+        uint64_t TypeDescriptor::GetLayoutHash(void) const
+        {
+            return m_layoutHash;
+        }
+
+        bool TypeDescriptor::IsTriviallyCopyable(void) const
+        {
+            return m_strings.empty();
+        }
+
+        Core::JSON TypeDescriptor::ToJson(const void* object) const
+        {
+            const uint8_t* base = static_cast<const uint8_t*>(object);
+
+            Core::JSON jsonObject = Core::JSON::object();
+            for (const FieldDescriptor& field : m_fields)
+            {
+                const uint8_t* memory = base + field.offset;
+                Core::JSON& value = jsonObject[field.name];
+
+                switch (field.type)
+                {
+                    case FieldType::Bool:
+                        value = *reinterpret_cast<const bool*>(memory);
+                        break;
+
+                    case FieldType::Int:
+                        value = LoadInt(memory, field.size);
+                        break;
+
+                    case FieldType::UInt:
+                        value = LoadUInt(memory, field.size);
+                        break;
+
+                    case FieldType::Float:
+                    {
+                        const float* elements = reinterpret_cast<const float*>(memory);
+                        if (field.count == 1)
+                            value = elements[0];
+                        else
+                        {
+                            value = Core::JSON::array();
+                            for (uint32_t i = 0; i < field.count; i++)
+                                value.push_back(elements[i]);
+                        }
+                        break;
+                    }
+
+                    case FieldType::Double:
+                    {
+                        const double* elements = reinterpret_cast<const double*>(memory);
+                        if (field.count == 1)
+                            value = elements[0];
+                        else
+                        {
+                            value = Core::JSON::array();
+                            for (uint32_t i = 0; i < field.count; i++)
+                                value.push_back(elements[i]);
+                        }
+                        break;
+                    }
+
+                    case FieldType::String:
+                        value = *reinterpret_cast<const std::string*>(memory);
+                        break;
+
+                    case FieldType::Struct:
+                        value = field.nested->ToJson(memory);
+                        break;
+                }
+            }
+
+            return jsonObject;
+        }
+
+        bool TypeDescriptor::FromJson(const Core::JSON& jsonObject, void* object) const
+        {
+            if (!jsonObject.is_object())
+                return false;
+
+            uint8_t* base = static_cast<uint8_t*>(object);
+
+            for (const FieldDescriptor& field : m_fields)
+            {
+                Core::JSON::const_iterator iter = jsonObject.find(field.name);
+                if (iter == jsonObject.cend())
+                    continue;
+
+                const Core::JSON& value = *iter;
+                uint8_t* memory = base + field.offset;
+
+                switch (field.type)
+                {
+                    case FieldType::Bool:
+                        if (!value.is_boolean())
+                            return false;
+                        *reinterpret_cast<bool*>(memory) = value.get<bool>();
+                        break;
+
+                    case FieldType::Int:
+                        if (!value.is_number_integer())
+                            return false;
+                        StoreInt(memory, field.size, value.get<int64_t>());
+                        break;
+
+                    case FieldType::UInt:
+                        if (!value.is_number_integer())
+                            return false;
+                        StoreUInt(memory, field.size, value.get<uint64_t>());
+                        break;
+
+                    case FieldType::Float:
+                    case FieldType::Double:
+                    {
+                        if (field.count == 1 ? !value.is_number() : (!value.is_array() || value.size() != field.count))
+                            return false;
+
+                        for (uint32_t i = 0; i < field.count; i++)
+                        {
+                            const Core::JSON& element = field.count == 1 ? value : value[i];
+                            if (!element.is_number())
+                                return false;
+
+                            if (field.type == FieldType::Float)
+                                reinterpret_cast<float*>(memory)[i] = element.get<float>();
+                            else
+                                reinterpret_cast<double*>(memory)[i] = element.get<double>();
+                        }
+                        break;
+                    }
+
+                    case FieldType::String:
+                    {
+                        const Core::JSON::string_t* string = value.get_ptr<const Core::JSON::string_t*>();
+                        if (string == nullptr)
+                            return false;
+                        *reinterpret_cast<std::string*>(memory) = *string;
+                        break;
+                    }
+
+                    case FieldType::Struct:
+                        if (!field.nested->FromJson(value, memory))
+                            return false;
+                        break;
+                }
+            }
+
+            return true;
+        }
+
+        void TypeDescriptor::WriteBinary(const void* object, std::vector<uint8_t>& out) const
+        {
+            const uint8_t* base = static_cast<const uint8_t*>(object);
+
+            for (const Span& span : m_spans)
+                out.insert(out.end(), base + span.offset, base + span.offset + span.size);
+
+            for (uint32_t offset : m_strings)
+            {
+                const std::string& string = *reinterpret_cast<const std::string*>(base + offset);
+                uint32_t length = static_cast<uint32_t>(string.size());
+                const uint8_t* lengthBytes = reinterpret_cast<const uint8_t*>(&length);
+                out.insert(out.end(), lengthBytes, lengthBytes + sizeof(length));
+                out.insert(out.end(), string.begin(), string.end());
+            }
+        }
+
+        bool TypeDescriptor::ReadBinary(void* object, const uint8_t*& cursor, const uint8_t* end) const
+        {
+            uint8_t* base = static_cast<uint8_t*>(object);
+
+            for (const Span& span : m_spans)
+            {
+                if (static_cast<std::size_t>(end - cursor) < span.size)
+                    return false;
+                std::memcpy(base + span.offset, cursor, span.size);
+                cursor += span.size;
+            }
+
+            for (uint32_t offset : m_strings)
+            {
+                uint32_t length;
+                if (static_cast<std::size_t>(end - cursor) < sizeof(length))
+                    return false;
+                std::memcpy(&length, cursor, sizeof(length));
+                cursor += sizeof(length);
+
+                if (static_cast<std::size_t>(end - cursor) < length)
+                    return false;
+                reinterpret_cast<std::string*>(base + offset)->assign(reinterpret_cast<const char*>(cursor), length);
+                cursor += length;
+            }
+
+            return true;
+        }
+
+        void TypeDescriptor::Copy(void* destination, const void* source) const
+        {
+            uint8_t* to = static_cast<uint8_t*>(destination);
+            const uint8_t* from = static_cast<const uint8_t*>(source);
+
+            for (const Span& span : m_spans)
+                std::memcpy(to + span.offset, from + span.offset, span.size);
+
+            for (uint32_t offset : m_strings)
+                *reinterpret_cast<std::string*>(to + offset) = *reinterpret_cast<const std::string*>(from + offset);
+        }
+
+        void TypeDescriptor::HashState(const void* object, StateHash& hash) const
+        {
+            const uint8_t* base = static_cast<const uint8_t*>(object);
+
+            for (const Span& span : m_spans)
+                hash.Add(base + span.offset, span.size);
+
+            for (uint32_t offset : m_strings)
+            {
+                const std::string& string = *reinterpret_cast<const std::string*>(base + offset);
+                hash.Add(static_cast<uint32_t>(string.size()));
+                hash.Add(string.data(), string.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,823 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_render_queue.h>
+#include <ht_gameobject.h>
+#include <ht_renderer_singleton.h>
+#include <ht_meshrenderer.h>
+#include <ht_shadervariablechunk.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <mutex>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define HT_RENDER_QUEUE_SSE
+    #include <xmmintrin.h>
+#endif
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+
+            struct Float3
+            {
+                float x;
+                float y;
+                float z;
+            };
+
+            Float3 ToFloat3(const Math::Vector3& v)
+            {
+                return Float3{ v.x, v.y, v.z };
+            }
+
+            float Dot(const Float3& a, const Float3& b)
+            {
+                return a.x * b.x + a.y * b.y + a.z * b.z;
+            }
+
+            Float3 Cross(const Float3& a, const Float3& b)
+            {
+                return Float3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+            }
+
+            Float3 Normalize(const Float3& v)
+            {
+                float length = std::sqrt(Dot(v, v));
+                if (length <= 0.0f)
+                    return v;
+                return Float3{ v.x / length, v.y / length, v.z / length };
+            }
+
+            /**
+            * \brief Sets plane to the plane through point with the given (not necessarily unit) normal.
+            */
+            void SetPlane(float* plane, const Float3& normal, const Float3& point)
+            {
+                Float3 n = Normalize(normal);
+                plane[0] = n.x;
+                plane[1] = n.y;
+                plane[2] = n.z;
+                plane[3] = -Dot(n, point);
+            }
+
+            std::mutex s_batchMutex; /**< Guards the ids below; scenes may load on any thread. */
+            std::unordered_map<std::string, uint32_t> s_meshIds; /**< Id of each mesh file. */
+            std::unordered_map<std::string, uint32_t> s_materialIds; /**< Id of each material file. */
+            uint32_t s_nextMeshId = 1;
+            uint32_t s_nextMaterialId = 1;
+
+            /**
+            * \brief Gets the id of a file, handing out the next id if it has none yet. s_batchMutex must be held.
+            */
+            uint32_t InternFile(std::unordered_map<std::string, uint32_t>& ids, uint32_t& nextId, const std::string& file)
+            {
+                std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> slot = ids.insert(std::make_pair(file, nextId));
+                if (slot.second)
+                    nextId++;
+                return slot.first->second;
+            }
+
+            /**
+            * \brief Identifies a batch within a frame; the same mesh and material drawn in two passes are two batches.
+            */
+            uint64_t FrameBatchKey(uint64_t batch, RenderQueue::Pass pass)
+            {
+                return batch ^ (static_cast<uint64_t>(pass) << 62);
+            }
+
+            /**
+            * \brief Instance data of an unused slot in a batch's instance buffer. It scales the mesh to a point.
+            */
+            const Math::Matrix4 CollapsedInstance = Math::MMMatrixScale(Math::Vector3(0.0f, 0.0f, 0.0f));
+
+            /* Visibility of a draw, as kept in m_visible */
+            const uint8_t DrawHidden = 0;
+            const uint8_t DrawVisible = 1;
+            const uint8_t DrawOccluded = 2; /**< Inside a frustum, but behind occluders. */
+
+            /**
+            * \brief The faces of an occluder box as triangles, indexing its corners.
+            */
+            const uint8_t BoxTriangles[12][3] =
+            {
+                { 0, 2, 6 }, { 0, 6, 4 },   // -x
+                { 1, 3, 7 }, { 1, 7, 5 },   // +x
+                { 0, 1, 5 }, { 0, 5, 4 },   // -y
+                { 2, 3, 7 }, { 2, 7, 6 },   // +y
+                { 0, 1, 3 }, { 0, 3, 2 },   // -z
+                { 4, 5, 7 }, { 4, 7, 6 }    // +z
+            };
+        }
+
+        RenderQueue::RenderQueue(RenderQueue&& rhs)
+            : m_views(std::move(rhs.m_views)), m_draws(std::move(rhs.m_draws)),
+            m_centerX(std::move(rhs.m_centerX)), m_centerY(std::move(rhs.m_centerY)), m_centerZ(std::move(rhs.m_centerZ)),
+            m_radius(std::move(rhs.m_radius)), m_outside(std::move(rhs.m_outside)), m_visible(std::move(rhs.m_visible)),
+            m_occluders(std::move(rhs.m_occluders)), m_depth(std::move(rhs.m_depth)),
+            m_viewOf(std::move(rhs.m_viewOf)), m_keys(std::move(rhs.m_keys)), m_order(std::move(rhs.m_order)),
+            m_keysScratch(std::move(rhs.m_keysScratch)), m_orderScratch(std::move(rhs.m_orderScratch)), m_submissions(std::move(rhs.m_submissions)),
+            m_instances(std::move(rhs.m_instances)), m_batches(std::move(rhs.m_batches)), m_batchIndex(std::move(rhs.m_batchIndex)),
+            m_batchedInstances(std::move(rhs.m_batchedInstances)), m_batchBuffers(std::move(rhs.m_batchBuffers)), m_frame(rhs.m_frame)
+        {
+            rhs.m_batchBuffers.clear();
+        }
+
+        RenderQueue& RenderQueue::operator=(RenderQueue&& rhs)
+        {
+            if (this != &rhs)
+            {
+                ReleaseBatchBuffers();
+                m_views = std::move(rhs.m_views);
+                m_draws = std::move(rhs.m_draws);
+                m_centerX = std::move(rhs.m_centerX);
+                m_centerY = std::move(rhs.m_centerY);
+                m_centerZ = std::move(rhs.m_centerZ);
+                m_radius = std::move(rhs.m_radius);
+                m_outside = std::move(rhs.m_outside);
+                m_visible = std::move(rhs.m_visible);
+                m_occluders = std::move(rhs.m_occluders);
+                m_depth = std::move(rhs.m_depth);
+                m_viewOf = std::move(rhs.m_viewOf);
+                m_keys = std::move(rhs.m_keys);
+                m_order = std::move(rhs.m_order);
+                m_keysScratch = std::move(rhs.m_keysScratch);
+                m_orderScratch = std::move(rhs.m_orderScratch);
+                m_submissions = std::move(rhs.m_submissions);
+                m_instances = std::move(rhs.m_instances);
+                m_batches = std::move(rhs.m_batches);
+                m_batchIndex = std::move(rhs.m_batchIndex);
+                m_batchedInstances = std::move(rhs.m_batchedInstances);
+                m_batchBuffers = std::move(rhs.m_batchBuffers);
+                m_frame = rhs.m_frame;
+
+                rhs.m_batchBuffers.clear();
+            }
+            return *this;
+        }
+
+        RenderQueue::~RenderQueue(void)
+        {
+            ReleaseBatchBuffers();
+        }
+
+        void RenderQueue::AddView(const Math::Vector3& position, const Math::Vector3& forward, const Math::Vector3& up,
+            float fov, float aspect, float nearPlane, float farPlane, uint32_t layers)
+        {
+            // An orthonormal basis, whatever the Transform hands us.
+            Float3 p = ToFloat3(position);
+            Float3 f = Normalize(ToFloat3(forward));
+            Float3 r = Normalize(Cross(f, ToFloat3(up)));
+            Float3 u = Cross(r, f);
+
+            float tanV = std::tan(fov * 0.5f);
+            float tanH = tanV * aspect;
+
+            // A point c away from the camera is inside if |c.r| <= (c.f) tanH and |c.u| <= (c.f) tanV.
+            View view;
+            SetPlane(view.planes[0], f, Float3{ p.x + f.x * nearPlane, p.y + f.y * nearPlane, p.z + f.z * nearPlane });
+            SetPlane(view.planes[1], Float3{ -f.x, -f.y, -f.z }, Float3{ p.x + f.x * farPlane, p.y + f.y * farPlane, p.z + f.z * farPlane });
+            SetPlane(view.planes[2], Float3{ f.x * tanH - r.x, f.y * tanH - r.y, f.z * tanH - r.z }, p);
+            SetPlane(view.planes[3], Float3{ f.x * tanH + r.x, f.y * tanH + r.y, f.z * tanH + r.z }, p);
+            SetPlane(view.planes[4], Float3{ f.x * tanV - u.x, f.y * tanV - u.y, f.z * tanV - u.z }, p);
+            SetPlane(view.planes[5], Float3{ f.x * tanV + u.x, f.y * tanV + u.y, f.z * tanV + u.z }, p);
+            view.position[0] = p.x;
+            view.position[1] = p.y;
+            view.position[2] = p.z;
+            view.forward[0] = f.x;
+            view.forward[1] = f.y;
+            view.forward[2] = f.z;
+            view.right[0] = r.x;
+            view.right[1] = r.y;
+            view.right[2] = r.z;
+            view.up[0] = u.x;
+            view.up[1] = u.y;
+            view.up[2] = u.z;
+            view.tanHalfWidth = tanH;
+            view.tanHalfHeight = tanV;
+            view.nearPlane = nearPlane;
+            view.farPlane = farPlane;
+            view.layers = layers;
+
+            m_views.push_back(view);
+        }
+
+        void RenderQueue::AddDraw(Graphics::MeshRenderer* meshRenderer, Graphics::ShaderVariableChunk* instanceData,
+            const Math::Vector3& center, float radius, uint32_t layers, Pass pass)
+        {
+            m_draws.push_back(Draw{ meshRenderer, instanceData, 0, layers, 0, pass });
+            m_centerX.push_back(center.x);
+            m_centerY.push_back(center.y);
+            m_centerZ.push_back(center.z);
+            m_radius.push_back(radius > 0.0f ? radius : FLT_MAX);
+        }
+
+        void RenderQueue::AddInstance(Graphics::MeshRenderer* meshRenderer, uint64_t batch, const Math::Matrix4& instance,
+            const Math::Vector3& center, float radius, uint32_t layers, Pass pass)
+        {
+            m_draws.push_back(Draw{ meshRenderer, nullptr, batch, layers, static_cast<uint32_t>(m_instances.size()), pass });
+            m_instances.push_back(instance);
+            m_centerX.push_back(center.x);
+            m_centerY.push_back(center.y);
+            m_centerZ.push_back(center.z);
+            m_radius.push_back(radius > 0.0f ? radius : FLT_MAX);
+        }
+
+        void RenderQueue::AddOccluder(const Math::Vector3* corners, uint32_t layers)
+        {
+            Occluder occluder;
+            for (int i = 0; i < 8; i++)
+            {
+                occluder.corners[i][0] = corners[i].x;
+                occluder.corners[i][1] = corners[i].y;
+                occluder.corners[i][2] = corners[i].z;
+            }
+            occluder.layers = layers;
+
+            m_occluders.push_back(occluder);
+        }
+
+        std::size_t RenderQueue::Submit(void)
+        {
+            uint32_t occluded = Cull();
+
+            m_keys.clear();
+            m_order.clear();
+            for (std::size_t i = 0; i < m_draws.size(); i++)
+            {
+                if (m_visible[i] != DrawVisible)
+                    continue;
+
+                m_keys.push_back(MakeSortKey(i));
+                m_order.push_back(static_cast<uint32_t>(i));
+            }
+
+            SortByKey();
+            GroupBatches();
+
+            for (uint32_t submission : m_submissions)
+            {
+                if ((submission & BatchSubmission) == 0)
+                {
+                    const Draw& draw = m_draws[submission];
+                    if (draw.meshRenderer != nullptr)
+                    {
+                        draw.meshRenderer->SetInstanceData(draw.instanceData);
+                        draw.meshRenderer->Render();
+                    }
+                    Renderer::CountDrawCall();
+                    continue;
+                }
+
+                const Batch& batch = m_batches[submission & ~BatchSubmission];
+                if (batch.meshRenderer != nullptr)
+                {
+                    BatchBuffer& buffer = GetBatchBuffer(batch.id, batch.count);
+                    for (uint32_t i = 0; i < batch.count; i++)
+                        buffer.data->SetMatrix4(i * sizeof(Math::Matrix4), m_instances[m_batchedInstances[batch.first + i]]);
+
+                    // The instance count is taken from the size of the data, so the slots past the visible
+                    // instances are collapsed to a point and rasterize nothing.
+                    for (uint32_t i = batch.count; i < buffer.used; i++)
+                        buffer.data->SetMatrix4(i * sizeof(Math::Matrix4), CollapsedInstance);
+                    buffer.used = batch.count;
+
+                    batch.meshRenderer->SetInstanceData(buffer.data);
+                    batch.meshRenderer->Render();
+                }
+                Renderer::CountDrawCall(batch.count);
+            }
+
+            Renderer::CountCulled(static_cast<uint32_t>(m_draws.size() - m_order.size()));
+            Renderer::CountOccluded(occluded);
+
+            std::size_t calls = m_submissions.size();
+            m_batches.clear();
+            m_batchIndex.clear();
+
+            m_frame++;
+            if (m_frame % BatchBufferFrames == 0)
+                EvictBatchBuffers();
+
+            return calls;
+        }
+
+        uint64_t RenderQueue::MakeSortKey(std::size_t draw) const
+        {
+            const uint64_t DepthMax = (1u << 22) - 1;
+
+            const Draw& item = m_draws[draw];
+
+            uint64_t layer = 0;
+            while (layer < 31 && (item.layers & (1u << layer)) == 0)
+                layer++;
+
+            // Depth along the view the draw was first found visible in, as a fraction of its far plane.
+            uint64_t depth = 0;
+            if (!m_views.empty())
+            {
+                const View& view = m_views[m_viewOf[draw]];
+                float distance = (m_centerX[draw] - view.position[0]) * view.forward[0]
+                    + (m_centerY[draw] - view.position[1]) * view.forward[1]
+                    + (m_centerZ[draw] - view.position[2]) * view.forward[2];
+                float fraction = (view.farPlane > 0.0f) ? std::min(std::max(distance / view.farPlane, 0.0f), 1.0f) : 0.0f;
+                depth = static_cast<uint64_t>(fraction * static_cast<float>(DepthMax));
+            }
+
+            uint64_t material = (item.batch >> 32) & 0xFFFF;
+            uint64_t mesh = item.batch & 0xFFFF;
+
+            uint64_t key = (layer << 56) | (static_cast<uint64_t>(item.pass) << 54);
+            if (item.pass == Pass::TRANSPARENT_PASS)
+                return key | ((DepthMax - depth) << 32) | (material << 16) | mesh;
+            return key | (material << 38) | (mesh << 22) | depth;
+        }
+
+        void RenderQueue::SortByKey(void)
+        {
+            std::size_t count = m_keys.size();
+            if (count < 2)
+                return;
+
+            m_keysScratch.resize(count);
+            m_orderScratch.resize(count);
+
+            for (unsigned shift = 0; shift < 64; shift += 8)
+            {
+                std::size_t offsets[256] = {};
+                for (std::size_t i = 0; i < count; i++)
+                    offsets[(m_keys[i] >> shift) & 0xFF]++;
+
+                // Every key has the same byte here, so this pass would not move anything.
+                if (offsets[(m_keys[0] >> shift) & 0xFF] == count)
+                    continue;
+
+                std::size_t total = 0;
+                for (std::size_t& offset : offsets)
+                {
+                    std::size_t digitCount = offset;
+                    offset = total;
+                    total += digitCount;
+                }
+
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    std::size_t slot = offsets[(m_keys[i] >> shift) & 0xFF]++;
+                    m_keysScratch[slot] = m_keys[i];
+                    m_orderScratch[slot] = m_order[i];
+                }
+
+                m_keys.swap(m_keysScratch);
+                m_order.swap(m_orderScratch);
+            }
+        }
+
+        void RenderQueue::GroupBatches(void)
+        {
+            // A batch is submitted where its first instance sorts.
+            m_submissions.clear();
+            for (uint32_t index : m_order)
+            {
+                const Draw& draw = m_draws[index];
+                if (draw.batch == 0)
+                {
+                    m_submissions.push_back(index);
+                    continue;
+                }
+
+                uint64_t key = FrameBatchKey(draw.batch, draw.pass);
+                std::pair<std::unordered_map<uint64_t, uint32_t>::iterator, bool> slot =
+                    m_batchIndex.insert(std::make_pair(key, static_cast<uint32_t>(m_batches.size())));
+                if (slot.second)
+                {
+                    m_submissions.push_back(static_cast<uint32_t>(m_batches.size()) | BatchSubmission);
+                    m_batches.push_back(Batch{ key, draw.meshRenderer, 0, 0 });
+                }
+                m_batches[slot.first->second].count++;
+            }
+
+            // Counting sort of the instances by batch, keeping their sorted order within each batch.
+            uint32_t offset = 0;
+            for (Batch& batch : m_batches)
+            {
+                batch.first = offset;
+                offset += batch.count;
+                batch.count = 0;
+            }
+
+            m_batchedInstances.resize(offset);
+            for (uint32_t index : m_order)
+            {
+                const Draw& draw = m_draws[index];
+                if (draw.batch == 0)
+                    continue;
+
+                Batch& batch = m_batches[m_batchIndex[FrameBatchKey(draw.batch, draw.pass)]];
+                m_batchedInstances[batch.first + batch.count++] = draw.instance;
+            }
+        }
+
+        RenderQueue::BatchBuffer& RenderQueue::GetBatchBuffer(uint64_t batch, uint32_t count)
+        {
+            BatchBuffer& buffer = m_batchBuffers[batch];
+            buffer.lastFrame = m_frame;
+            if (buffer.data != nullptr && buffer.capacity >= count)
+                return buffer;
+
+            delete buffer.data;
+
+            uint32_t capacity = 1;
+            while (capacity < count)
+                capacity <<= 1;
+
+            Resource::Matrix4Variable* matrix = new Resource::Matrix4Variable(CollapsedInstance);
+            std::vector<Resource::ShaderVariable*> variables(capacity, matrix);
+            buffer.data = new Graphics::ShaderVariableChunk(variables);
+            buffer.capacity = capacity;
+            buffer.used = 0;
+            delete matrix;
+
+            return buffer;
+        }
+
+        void RenderQueue::EvictBatchBuffers(void)
+        {
+            for (std::unordered_map<uint64_t, BatchBuffer>::iterator iter = m_batchBuffers.begin(); iter != m_batchBuffers.end();)
+            {
+                if (m_frame - iter->second.lastFrame >= BatchBufferFrames)
+                {
+                    delete iter->second.data;
+                    iter = m_batchBuffers.erase(iter);
+                }
+                else
+                    ++iter;
+            }
+        }
+
+        void RenderQueue::ReleaseBatchBuffers(void)
+        {
+            for (std::pair<const uint64_t, BatchBuffer>& buffer : m_batchBuffers)
+                delete buffer.second.data;
+            m_batchBuffers.clear();
+        }
+
+        void RenderQueue::Clear(void)
+        {
+            m_views.clear();
+            m_draws.clear();
+            m_occluders.clear();
+            m_instances.clear();
+            m_centerX.clear();
+            m_centerY.clear();
+            m_centerZ.clear();
+            m_radius.clear();
+        }
+
+        std::size_t RenderQueue::GetDrawCount(void) const
+        {
+            return m_draws.size();
+        }
+
+        std::size_t RenderQueue::GetViewCount(void) const
+        {
+            return m_views.size();
+        }
+
+        std::size_t RenderQueue::GetOccluderCount(void) const
+        {
+            return m_occluders.size();
+        }
+
+        float RenderQueue::GetBoundsScale(GameObject& gameObject)
+        {
+            float scale = 1.0f;
+            for (GameObject* current = &gameObject; current != nullptr; current = current->GetParent())
+            {
+                Math::Vector3 axes = current->GetTransform().GetScale();
+                scale *= std::max(std::fabs(axes.x), std::max(std::fabs(axes.y), std::fabs(axes.z)));
+            }
+            return scale;
+        }
+
+        uint64_t RenderQueue::GetBatchId(const std::string& meshFile, const std::string& materialFile)
+        {
+            std::lock_guard<std::mutex> lock(s_batchMutex);
+            uint64_t material = InternFile(s_materialIds, s_nextMaterialId, materialFile);
+            uint64_t mesh = InternFile(s_meshIds, s_nextMeshId, meshFile);
+            return (material << 32) | mesh;
+        }
+
+        uint64_t RenderQueue::NewBatchId(void)
+        {
+            // A material of its own, so no other batch matches it.
+            std::lock_guard<std::mutex> lock(s_batchMutex);
+            uint64_t material = s_nextMaterialId++;
+            return material << 32;
+        }
+
+        uint32_t RenderQueue::Cull(void)
+        {
+            std::size_t count = m_draws.size();
+            m_visible.assign(count, m_views.empty() ? DrawVisible : DrawHidden);
+            m_viewOf.assign(count, 0);
+            if (m_views.empty() || count == 0)
+                return 0;
+
+            // Pad the bounds to whole batches of four; the padding is never read back.
+            std::size_t padded = (count + 3) & ~static_cast<std::size_t>(3);
+            m_centerX.resize(padded, 0.0f);
+            m_centerY.resize(padded, 0.0f);
+            m_centerZ.resize(padded, 0.0f);
+            m_radius.resize(padded, 0.0f);
+            m_outside.resize(padded);
+
+            for (std::size_t v = 0; v < m_views.size(); v++)
+            {
+                const View& view = m_views[v];
+                CullView(view, m_centerX.data(), m_centerY.data(), m_centerZ.data(), m_radius.data(), padded, m_outside.data());
+
+                bool occlusion = RasterizeOccluders(view);
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    if (m_visible[i] == DrawVisible || m_outside[i] || (m_draws[i].layers & view.layers) == 0)
+                        continue;
+
+                    if (occlusion && IsOccluded(view, i))
+                    {
+                        m_visible[i] = DrawOccluded;
+                        continue;
+                    }
+
+                    m_visible[i] = DrawVisible;
+                    m_viewOf[i] = static_cast<uint32_t>(v);
+                }
+            }
+
+            m_centerX.resize(count);
+            m_centerY.resize(count);
+            m_centerZ.resize(count);
+            m_radius.resize(count);
+
+            return static_cast<uint32_t>(std::count(m_visible.begin(), m_visible.end(), DrawOccluded));
+        }
+
+        bool RenderQueue::RasterizeOccluders(const View& view)
+        {
+            bool cleared = false;
+            for (const Occluder& occluder : m_occluders)
+            {
+                if ((occluder.layers & view.layers) == 0)
+                    continue;
+
+                if (!cleared)
+                {
+                    m_depth.assign(OcclusionWidth * OcclusionHeight, 0.0f);
+                    cleared = true;
+                }
+
+                // Project the corners to pixels; depth is stored inverted, as it interpolates linearly across the screen.
+                float screen[8][3];
+                bool clipped[8];
+                for (int i = 0; i < 8; i++)
+                {
+                    const float* corner = occluder.corners[i];
+                    Float3 offset{ corner[0] - view.position[0], corner[1] - view.position[1], corner[2] - view.position[2] };
+                    float z = offset.x * view.forward[0] + offset.y * view.forward[1] + offset.z * view.forward[2];
+                    float x = offset.x * view.right[0] + offset.y * view.right[1] + offset.z * view.right[2];
+                    float y = offset.x * view.up[0] + offset.y * view.up[1] + offset.z * view.up[2];
+
+                    clipped[i] = z < view.nearPlane;
+                    if (clipped[i])
+                        continue;
+
+                    screen[i][0] = (x / (z * view.tanHalfWidth) * 0.5f + 0.5f) * OcclusionWidth;
+                    screen[i][1] = (0.5f - y / (z * view.tanHalfHeight) * 0.5f) * OcclusionHeight;
+                    screen[i][2] = 1.0f / z;
+                }
+
+                // Triangles crossing the near plane are left out; an occluder missing a face only hides less.
+                for (const uint8_t* triangle : BoxTriangles)
+                {
+                    if (clipped[triangle[0]] || clipped[triangle[1]] || clipped[triangle[2]])
+                        continue;
+
+                    RasterizeTriangle(screen[triangle[0]], screen[triangle[1]], screen[triangle[2]]);
+                }
+            }
+
+            return cleared;
+        }
+
+        void RenderQueue::RasterizeTriangle(const float* a, const float* b, const float* c)
+        {
+            // Wind counter-clockwise so the inside of every edge is positive.
+            float area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+            if (area < 0.0f)
+            {
+                std::swap(b, c);
+                area = -area;
+            }
+            if (area < 1e-6f)
+                return;
+
+            int minX = std::max(static_cast<int>(std::floor(std::min(a[0], std::min(b[0], c[0])))), 0);
+            int maxX = std::min(static_cast<int>(std::ceil(std::max(a[0], std::max(b[0], c[0])))), static_cast<int>(OcclusionWidth) - 1);
+            int minY = std::max(static_cast<int>(std::floor(std::min(a[1], std::min(b[1], c[1])))), 0);
+            int maxY = std::min(static_cast<int>(std::ceil(std::max(a[1], std::max(b[1], c[1])))), static_cast<int>(OcclusionHeight) - 1);
+            if (minX > maxX || minY > maxY)
+                return;
+
+            // Edge functions, each zero on one edge and positive inside, and the inverse depth plane: A * x + B * y + C.
+            const float* edges[3][2] = { { b, c }, { c, a }, { a, b } };
+            float edgeA[3], edgeB[3], edgeC[3];
+            for (int i = 0; i < 3; i++)
+            {
+                const float* from = edges[i][0];
+                const float* to = edges[i][1];
+                edgeA[i] = from[1] - to[1];
+                edgeB[i] = to[0] - from[0];
+                edgeC[i] = -(edgeA[i] * from[0] + edgeB[i] * from[1]);
+            }
+
+            float depthA = (edgeA[0] * a[2] + edgeA[1] * b[2] + edgeA[2] * c[2]) / area;
+            float depthB = (edgeB[0] * a[2] + edgeB[1] * b[2] + edgeB[2] * c[2]) / area;
+            float depthC = (edgeC[0] * a[2] + edgeC[1] * b[2] + edgeC[2] * c[2]) / area;
+
+            // Rows are a multiple of four wide, so starting on a multiple of four keeps every batch of four in the row.
+            minX &= ~3;
+
+#ifdef HT_RENDER_QUEUE_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 steps = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            __m128 a0 = _mm_set1_ps(edgeA[0]), a1 = _mm_set1_ps(edgeA[1]), a2 = _mm_set1_ps(edgeA[2]);
+            __m128 aDepth = _mm_set1_ps(depthA);
+
+            for (int y = minY; y <= maxY; y++)
+            {
+                float py = static_cast<float>(y) + 0.5f;
+                __m128 row0 = _mm_set1_ps(edgeB[0] * py + edgeC[0]);
+                __m128 row1 = _mm_set1_ps(edgeB[1] * py + edgeC[1]);
+                __m128 row2 = _mm_set1_ps(edgeB[2] * py + edgeC[2]);
+                __m128 rowDepth = _mm_set1_ps(depthB * py + depthC);
+                float* depthRow = m_depth.data() + y * OcclusionWidth;
+
+                for (int x = minX; x <= maxX; x += 4)
+                {
+                    __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), steps);
+                    __m128 inside = _mm_and_ps(_mm_and_ps(
+                        _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), row0), zero),
+                        _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), row1), zero)),
+                        _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), row2), zero));
+                    if (_mm_movemask_ps(inside) == 0)
+                        continue;
+
+                    __m128 current = _mm_loadu_ps(depthRow + x);
+                    __m128 nearest = _mm_max_ps(current, _mm_add_ps(_mm_mul_ps(aDepth, px), rowDepth));
+                    _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+                }
+            }
+#else
+            for (int y = minY; y <= maxY; y++)
+            {
+                float py = static_cast<float>(y) + 0.5f;
+                float* depthRow = m_depth.data() + y * OcclusionWidth;
+
+                for (int x = minX; x <= maxX; x++)
+                {
+                    float px = static_cast<float>(x) + 0.5f;
+                    if (edgeA[0] * px + edgeB[0] * py + edgeC[0] < 0.0f
+                        || edgeA[1] * px + edgeB[1] * py + edgeC[1] < 0.0f
+                        || edgeA[2] * px + edgeB[2] * py + edgeC[2] < 0.0f)
+                        continue;
+
+                    depthRow[x] = std::max(depthRow[x], depthA * px + depthB * py + depthC);
+                }
+            }
+#endif
+        }
+
+        bool RenderQueue::IsOccluded(const View& view, std::size_t draw) const
+        {
+            Float3 offset{ m_centerX[draw] - view.position[0], m_centerY[draw] - view.position[1], m_centerZ[draw] - view.position[2] };
+            float radius = m_radius[draw];
+            float z = offset.x * view.forward[0] + offset.y * view.forward[1] + offset.z * view.forward[2];
+
+            // Nothing reaching past the near plane can be behind an occluder.
+            float nearest = z - radius;
+            if (nearest <= view.nearPlane)
+                return false;
+            float furthest = z + radius;
+
+            // Screen bounds of the sphere: each side is furthest out where the sphere is nearest if it is on the far side of
+            // the view axis, and where it is furthest if it is on the near side.
+            float x = offset.x * view.right[0] + offset.y * view.right[1] + offset.z * view.right[2];
+            float y = offset.x * view.up[0] + offset.y * view.up[1] + offset.z * view.up[2];
+            float left = (x - radius) / ((x - radius < 0.0f) ? nearest : furthest) / view.tanHalfWidth;
+            float right = (x + radius) / ((x + radius > 0.0f) ? nearest : furthest) / view.tanHalfWidth;
+            float bottom = (y - radius) / ((y - radius < 0.0f) ? nearest : furthest) / view.tanHalfHeight;
+            float top = (y + radius) / ((y + radius > 0.0f) ? nearest : furthest) / view.tanHalfHeight;
+
+            float minPixelX = std::floor((left * 0.5f + 0.5f) * OcclusionWidth);
+            float maxPixelX = std::floor((right * 0.5f + 0.5f) * OcclusionWidth);
+            float minPixelY = std::floor((0.5f - top * 0.5f) * OcclusionHeight);
+            float maxPixelY = std::floor((0.5f - bottom * 0.5f) * OcclusionHeight);
+
+            int minX = static_cast<int>(std::max(minPixelX, 0.0f));
+            int maxX = static_cast<int>(std::min(maxPixelX, static_cast<float>(OcclusionWidth - 1)));
+            int minY = static_cast<int>(std::max(minPixelY, 0.0f));
+            int maxY = static_cast<int>(std::min(maxPixelY, static_cast<float>(OcclusionHeight - 1)));
+            if (minX > maxX || minY > maxY)
+                return false;
+
+            // Occluded only if every covered pixel holds something nearer than the nearest point of the sphere.
+            float inverseNearest = 1.0f / nearest;
+            for (int py = minY; py <= maxY; py++)
+            {
+                const float* depthRow = m_depth.data() + py * OcclusionWidth;
+                int px = minX;
+
+#ifdef HT_RENDER_QUEUE_SSE
+                const __m128 limit = _mm_set1_ps(inverseNearest);
+                for (; px + 3 <= maxX; px += 4)
+                {
+                    if (_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(depthRow + px), limit)) != 0)
+                        return false;
+                }
+#endif
+                for (; px <= maxX; px++)
+                {
+                    if (depthRow[px] <= inverseNearest)
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        void RenderQueue::CullView(const View& view, const float* x, const float* y, const float* z, const float* radius,
+            std::size_t count, uint8_t* outside)
+        {
+#ifdef HT_RENDER_QUEUE_SSE
+            __m128 nx[6], ny[6], nz[6], d[6];
+            for (int p = 0; p < 6; p++)
+            {
+                nx[p] = _mm_set1_ps(view.planes[p][0]);
+                ny[p] = _mm_set1_ps(view.planes[p][1]);
+                nz[p] = _mm_set1_ps(view.planes[p][2]);
+                d[p] = _mm_set1_ps(view.planes[p][3]);
+            }
+
+            const __m128 zero = _mm_setzero_ps();
+            for (std::size_t i = 0; i < count; i += 4)
+            {
+                __m128 cx = _mm_loadu_ps(x + i);
+                __m128 cy = _mm_loadu_ps(y + i);
+                __m128 cz = _mm_loadu_ps(z + i);
+                __m128 negR = _mm_sub_ps(zero, _mm_loadu_ps(radius + i));
+
+                // Outside if the center is further than the radius behind any plane.
+                __m128 out = zero;
+                for (int p = 0; p < 6; p++)
+                {
+                    __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+                        _mm_add_ps(_mm_mul_ps(nz[p], cz), d[p]));
+                    out = _mm_or_ps(out, _mm_cmplt_ps(distance, negR));
+                }
+
+                int mask = _mm_movemask_ps(out);
+                outside[i] = static_cast<uint8_t>(mask & 1);
+                outside[i + 1] = static_cast<uint8_t>((mask >> 1) & 1);
+                outside[i + 2] = static_cast<uint8_t>((mask >> 2) & 1);
+                outside[i + 3] = static_cast<uint8_t>((mask >> 3) & 1);
+            }
+#else
+            for (std::size_t i = 0; i < count; i++)
+            {
+                uint8_t out = 0;
+                for (int p = 0; p < 6; p++)
+                {
+                    const float* plane = view.planes[p];
+                    float distance = plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + plane[3];
+                    out |= (distance < -radius[i]) ? 1 : 0;
+                }
+                outside[i] = out;
+            }
+#endif
+        }
+    }
+}
@@ -35,10 +35,76 @@ namespace Hatchit {
                 return false;
             
             _instance.m_initialized = true;
+            _instance.m_headless = false;
+            _instance.m_stats = RenderStats{};
 
             return true;
         }
 
+        bool Renderer::InitializeHeadless()
+        {
+            Renderer& _instance = Renderer::instance();
+            _instance.m_renderer = nullptr;
+
+            _instance.m_initialized = true;
+            _instance.m_headless = true;
+            _instance.m_stats = RenderStats{};
+
+            HT_DEBUG_PRINTF("Initialized headless Renderer.\n");
+
+            return true;
+        }
+
+        bool Renderer::IsHeadless()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            return _instance.m_headless;
+        }
+
+        void Renderer::CountDrawCall(uint32_t instanceCount)
+        {
+            Renderer& _instance = Renderer::instance();
+
+            _instance.m_stats.drawCalls++;
+            _instance.m_stats.instances += instanceCount;
+        }
+
+        void Renderer::CountCulled(uint32_t drawCount)
+        {
+            Renderer& _instance = Renderer::instance();
+
+            _instance.m_stats.culled += drawCount;
+        }
+
+        void Renderer::CountOccluded(uint32_t drawCount)
+        {
+            Renderer& _instance = Renderer::instance();
+
+            _instance.m_stats.occluded += drawCount;
+        }
+
+        void Renderer::CountCamera()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            _instance.m_stats.cameras++;
+        }
+
+        const RenderStats& Renderer::GetStats()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            return _instance.m_stats;
+        }
+
+        void Renderer::ResetStats()
+        {
+            Renderer& _instance = Renderer::instance();
+
+            _instance.m_stats = RenderStats{};
+        }
+
         void Renderer::DeInitialize()
         {
             Renderer& _instance = Renderer::instance();
@@ -46,11 +112,15 @@ namespace Hatchit {
             if (!_instance.m_initialized)
                 return;
 
-            /*Release GPUResourcePool*/
-            GPUResourcePool::DeInitialize();
+            if (!_instance.m_headless)
+            {
+                /*Release GPUResourcePool*/
+                GPUResourcePool::DeInitialize();
 
-            delete _instance.m_renderer;
-            
+                delete _instance.m_renderer;
+            }
+
+            _instance.m_renderer = nullptr;
             _instance.m_initialized = false;
         }
 
@@ -61,13 +131,17 @@ namespace Hatchit {
             if (!_instance.m_initialized)
                 return;
 
+            _instance.m_stats.frames++;
+            if (_instance.m_headless)
+                return;
+
             _instance.m_renderer->Render();
         }
 
         void Renderer::Present()
         {
             Renderer& _instance = Renderer::instance();
-            if (!_instance.m_initialized)
+            if (!_instance.m_initialized || _instance.m_headless)
                 return;
 
             _instance.m_renderer->Present();
@@ -76,7 +150,7 @@ namespace Hatchit {
         void Renderer::ResizeBuffers(uint32_t width, uint32_t height)
         {
             Renderer& _instance = Renderer::instance();
-            if (!_instance.m_initialized)
+            if (!_instance.m_initialized || _instance.m_headless)
                 return;
 
             _instance.m_renderer->ResizeBuffers(width, height);
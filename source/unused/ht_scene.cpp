@@ -14,12 +14,15 @@
 
 #include <ht_scene.h>
 #include <ht_jsonhelper.h>
-#include <ht_component_factory.h>
+#include <ht_component_registry.h>
 #include <ht_debug.h>
 #include <ht_test_component.h>
 #include <ht_meshrenderer_component.h>
 #include <ht_gameobject.h>
 #include <stdexcept>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
 
 namespace Hatchit {
 
@@ -31,19 +34,170 @@ namespace Hatchit {
 
         Scene* Scene::instance;
 
+        Scene* Scene::Fork() const
+        {
+            Scene* fork = new Scene();
+            fork->m_name = m_name;
+            fork->m_description = m_description;
+            fork->m_guid = m_guid;
+            fork->m_guidTable = m_guidTable;
+            fork->m_names = m_names;
+            fork->m_initSequence = m_initSequence;
+            fork->m_initBudget = m_initBudget;
 
+            // A GameObject under a destroyed parent goes with it, even though only the parent is marked.
+            std::vector<bool> live(m_objectsById.size(), false);
+            for (ObjectId id = 0; id < m_objectsById.size(); id++)
+            {
+                const GameObject* gameObject = m_objectsById[id];
+                while (gameObject != nullptr && !gameObject->m_destroyed)
+                    gameObject = gameObject->m_parent;
+                live[id] = m_objectsById[id] != nullptr && gameObject == nullptr;
+            }
 
-        Scene::Scene(Scene&& rhs)
-            : m_name(std::move(rhs.m_name)), m_guid(std::move(rhs.m_guid)), m_gameObjects(std::move(rhs.m_gameObjects))
-        {
+            // Count the live GameObjects and the Components of each type, so each gets a single block.
+            std::size_t live_count = 0;
+            std::vector<std::size_t> type_counts;
+            for (ObjectId id = 0; id < m_objectsById.size(); id++)
+            {
+                if (!live[id])
+                    continue;
+
+                const GameObject* gameObject = m_objectsById[id];
+                live_count++;
+                for (const Component* component : gameObject->m_components)
+                {
+                    if (component == nullptr)
+                        continue;
+
+                    ComponentTypeId typeId = component->VGetComponentTypeId();
+                    if (typeId >= type_counts.size())
+                        type_counts.resize(typeId + 1, 0);
+                    type_counts[typeId]++;
+                }
+            }
+
+            std::vector<uint8_t*> type_blocks(type_counts.size(), nullptr);
+            for (ComponentTypeId typeId = 0; typeId < type_counts.size(); typeId++)
+            {
+                const ComponentRegistry::Entry* entry = ComponentRegistry::Find(typeId);
+                if (entry != nullptr && type_counts[typeId] != 0)
+                    type_blocks[typeId] = static_cast<uint8_t*>(fork->m_arena.Allocate(entry->size * type_counts[typeId], entry->align));
+            }
+
+            // Copy every GameObject under its own ObjectId, and its Components into their type's block.
+            std::vector<GameObject*>& copies = fork->m_objectsById;
+            copies.assign(m_objectsById.size(), nullptr);
+
+            GameObject* objects = static_cast<GameObject*>(fork->m_arena.Allocate(sizeof(GameObject) * live_count, alignof(GameObject)));
+            std::size_t next = 0;
+            for (ObjectId id = 0; id < m_objectsById.size(); id++)
+            {
+                if (!live[id])
+                    continue;
+
+                const GameObject* source = m_objectsById[id];
+                GameObject* copy = new (objects + next++) GameObject(fork, source->m_guid, source->m_name, source->m_transform, source->m_enabled);
+                copy->m_id = id;
+                copy->m_prefab = source->m_prefab;
+                copy->m_initPriority = source->m_initPriority;
+                copy->m_initialized = source->m_initialized;
+                copy->m_components.reserve(source->m_components.size());
+
+                for (const Component* component : source->m_components)
+                {
+                    Component* clone = nullptr;
+                    if (component != nullptr)
+                    {
+                        ComponentTypeId typeId = component->VGetComponentTypeId();
+                        const ComponentRegistry::Entry* entry = ComponentRegistry::Find(typeId);
+                        if (entry == nullptr)
+                            clone = component->VClone();
+                        else
+                        {
+                            clone = entry->copyConstructAt(type_blocks[typeId], *component);
+                            type_blocks[typeId] += entry->size;
+                        }
+
+                        clone->SetOwner(copy);
+                        copy->m_componentMap.insert(std::make_pair(typeId, copy->m_components.size()));
+                    }
+
+                    // Removed Components leave an empty slot in the copy too.
+                    copy->m_components.push_back(clone);
+                }
+
+                copies[id] = copy;
+            }
+
+            // Point the hierarchy and the scene's lists at the copies.
+            for (ObjectId id = 0; id < m_objectsById.size(); id++)
+            {
+                if (copies[id] == nullptr)
+                    continue;
+
+                for (const GameObject* child : m_objectsById[id]->m_children)
+                {
+                    if (live[child->m_id])
+                        copies[id]->AddChild(copies[child->m_id]);
+                }
+            }
+
+            fork->m_gameObjects.reserve(m_gameObjects.size());
+            for (const GameObject* gameObject : m_gameObjects)
+            {
+                if (live[gameObject->m_id])
+                    fork->m_gameObjects.push_back(copies[gameObject->m_id]);
+            }
+
+            for (const GameObject* prefab : m_prefabs)
+                fork->m_prefabs.push_back(copies[prefab->m_id]);
+
+            std::priority_queue<PendingInit> pending(m_initQueue);
+            while (!pending.empty())
+            {
+                PendingInit queued = pending.top();
+                pending.pop();
+                if (!live[queued.gameObject->m_id])
+                    continue;
+
+                queued.gameObject = copies[queued.gameObject->m_id];
+                fork->m_initQueue.push(queued);
+            }
+
+            for (const std::pair<const NameId, GameObject*>& named : m_nameIndex)
+            {
+                if (live[named.second->m_id])
+                    fork->m_nameIndex.insert(std::make_pair(named.first, copies[named.second->m_id]));
+            }
+
+            for (const std::pair<const ObjectId, PrefabPool>& pool : m_pools)
+                fork->m_pools.insert(std::make_pair(pool.first, PrefabPool{ copies[pool.first], pool.second.capacity, std::vector<GameObject*>() }));
+
+            // Copies keep their enabled flags but are not initialized or enabled again, so nothing
+            // the source presents (playback, renderers) is started twice.
+            for (GameObject* copy : copies)
+            {
+                if (copy == nullptr || !copy->m_initialized)
+                    continue;
+
+                for (Component* component : copy->m_components)
+                {
+                    if (component != nullptr)
+                        component->VOnForked();
+                }
+            }
+
+            return fork;
         }
 
-        Scene& Scene::operator=(Scene&& rhs)
+        void Scene::DestroyFork(Scene* fork)
         {
-            this->m_name = std::move(rhs.m_name);
-            this->m_guid = std::move(rhs.m_guid);
-            this->m_gameObjects = std::move(rhs.m_gameObjects);
-            return *this;
+            if (fork == nullptr)
+                return;
+
+            fork->Unload();
+            delete fork;
         }
 
         /**
@@ -64,6 +218,98 @@ namespace Hatchit {
             return m_guid;
         }
 
+        GameObject* Scene::FindGameObject(ObjectId id) const
+        {
+            if (id >= m_objectsById.size())
+                return nullptr;
+
+            return m_objectsById[id];
+        }
+
+        GameObject* Scene::FindGameObject(const Guid& guid) const
+        {
+            return FindGameObject(m_guidTable.Find(guid));
+        }
+
+        const GuidTable& Scene::Guids() const
+        {
+            return m_guidTable;
+        }
+
+        GameObject* Scene::FindByName(const std::string& name) const
+        {
+            NameId id = m_names.Find(name);
+            if (id == InvalidNameId)
+                return nullptr;
+
+            std::unordered_multimap<NameId, GameObject*>::const_iterator iter = m_nameIndex.find(id);
+            if (iter == m_nameIndex.cend())
+                return nullptr;
+
+            return iter->second;
+        }
+
+        std::size_t Scene::FindAllByName(const std::string& name, std::vector<GameObject*>& out) const
+        {
+            NameId id = m_names.Find(name);
+            if (id == InvalidNameId)
+                return 0;
+
+            std::size_t count = 0;
+            auto range = m_nameIndex.equal_range(id);
+            for (auto iter = range.first; iter != range.second; ++iter)
+            {
+                out.push_back(iter->second);
+                count++;
+            }
+            return count;
+        }
+
+        const NameTable& Scene::Names() const
+        {
+            return m_names;
+        }
+
+        void Scene::RegisterGameObject(GameObject* gameObject, bool findByName)
+        {
+            ObjectId id = m_guidTable.Intern(gameObject->m_guid);
+            if (id >= m_objectsById.size())
+                m_objectsById.resize(id + 1, nullptr);
+
+            m_objectsById[id] = gameObject;
+            gameObject->m_id = id;
+            gameObject->m_scene = this;
+
+            if (findByName && gameObject->m_name != InvalidNameId)
+                m_nameIndex.insert(std::make_pair(gameObject->m_name, gameObject));
+        }
+
+        void Scene::UnregisterGameObject(GameObject* gameObject)
+        {
+            ObjectId id = gameObject->m_id;
+            if (id < m_objectsById.size() && m_objectsById[id] == gameObject)
+            {
+                m_objectsById[id] = nullptr;
+                m_guidTable.Erase(id);
+            }
+
+            RemoveFromNameIndex(gameObject);
+            gameObject->m_scene = nullptr;
+        }
+
+        void Scene::RemoveFromNameIndex(GameObject* gameObject)
+        {
+            auto range = m_nameIndex.equal_range(gameObject->m_name);
+            for (auto iter = range.first; iter != range.second; ++iter)
+            {
+                if (iter->second == gameObject)
+                {
+                    m_nameIndex.erase(iter);
+                    return;
+                }
+            }
+        }
+
         bool Scene::LoadFromHandle(Resource::SceneHandle sceneHandle)
         {
 
@@ -74,9 +320,15 @@ namespace Hatchit {
             }
 
             bool wasLoadedSuccessfully = true;
+            m_description = sceneHandle;
             const JSON& sceneDescription = sceneHandle->GetSceneDescription();
             try
             {
+                // Load every referenced asset concurrently up front, so Components built
+                // below find their meshes, materials and audio already in the caches.
+                m_prefetcher.Gather(sceneDescription);
+                m_prefetcher.Load();
+
                 wasLoadedSuccessfully = ParseScene(sceneDescription);
             }
             catch (std::out_of_range e)
@@ -100,6 +352,17 @@ namespace Hatchit {
         * \return True if loading was successful, false if not.
         */
         bool Scene::ParseScene(const JSON& obj)
+        {
+            std::vector<const JSON*> id_to_json;
+            if (!InstantiateGameObjects(obj, id_to_json))
+                return false;
+
+            LinkGameObjects(id_to_json);
+
+            return ParsePrefabs(obj, id_to_json);
+        }
+
+        bool Scene::InstantiateGameObjects(const JSON& obj, std::vector<const JSON*>& id_to_json)
         {
             // Get this scene's name
             if (!Core::JsonExtract<std::string>(obj, "Name", m_name))
@@ -123,32 +386,36 @@ namespace Hatchit {
                 return false;
             }
 
-            // Parse the Guid strings into Guids.
-            std::unordered_set<Guid> guids{};
+            // Intern every Guid up front. From here on GameObjects are referred to by their dense ObjectId,
+            // and the lookups below index plain arrays instead of hashing Guids.
+            m_guidTable.Reserve(string_guids.size());
             for (const std::string& string_guid : string_guids)
             {
                 Guid id;
                 if (!Guid::Parse(string_guid, id))
                 {
-                    HT_DEBUG_PRINTF("Failed to parse Guid %s in scene description!\n", string_guid);
+                    HT_DEBUG_PRINTF("Failed to parse Guid %s in scene description!\n", string_guid.c_str());
                     return false;
                 }
 
-                guids.insert(id);
+                m_guidTable.Intern(id);
             }
 
+            const std::size_t listed_count = m_guidTable.Size();
+            if (m_objectsById.size() < listed_count)
+                m_objectsById.resize(listed_count, nullptr);
+
             // Get an array of all the JSON GameObjects in the scene.
-            std::vector<JSON> json_gameobjs{};
-            if (!Core::JsonExtractContainer(obj, "GameObjects", json_gameobjs))
+            JSON::const_iterator json_gameobjs = obj.find("GameObjects");
+            if (json_gameobjs == obj.cend() || !json_gameobjs->is_array())
             {
                 HT_DEBUG_PRINTF("Failed to find property 'GameObjects' in scene description!\n");
                 return false;
             }
 
             // Attempt to parse the JSON GameObjects.
-            std::unordered_map<Guid, GameObject*> guid_to_obj{};
-            std::unordered_map<Guid, JSON> guid_to_json{};
-            for (const JSON& json_obj : json_gameobjs)
+            id_to_json.assign(listed_count, nullptr);
+            for (const JSON& json_obj : *json_gameobjs)
             {
                 // Attempt to parse a GameObject from the provided JSON.
                 GameObject* obj;
@@ -160,38 +427,53 @@ namespace Hatchit {
                 }
 
                 // Validate that the Guid for the parsed GameObject is present in the master list.
-                const Guid& id = obj->GetGuid();
-                std::unordered_set<Guid>::const_iterator iter = guids.find(id);
-                if (iter == guids.cend())
+                ObjectId id = m_guidTable.Find(obj->GetGuid());
+                if (id == InvalidObjectId || id >= listed_count || id_to_json[id] != nullptr)
                 {
-                    HT_DEBUG_PRINTF("Failed to locate %s within 'GUIDs' array in scene description!\n", id.ToString());
+                    HT_DEBUG_PRINTF("Failed to locate %s within 'GUIDs' array in scene description!\n", obj->GetGuid().ToString().c_str());
+                    DestroyGameObject(obj);
                     return false;
                 }
 
-                guid_to_obj.insert(std::make_pair(id, obj));
-                guid_to_json.insert(std::make_pair(id, json_obj));
+                RegisterGameObject(obj);
+                id_to_json[id] = &json_obj;
             }
 
+            return true;
+        }
+
+        void Scene::LinkGameObjects(const std::vector<const JSON*>& id_to_json)
+        {
+            const std::size_t listed_count = id_to_json.size();
+
             // Handles all GameObject parent/child arrangements.
-            for (const Guid& id : guids)
+            std::vector<bool> is_child(listed_count, false);
+            for (ObjectId id = 0; id < listed_count; id++)
             {
-                ParseChildGameObjects(id, guid_to_obj, guid_to_json);
+                ParseChildGameObjects(id, id_to_json, is_child);
             }
 
             // Copy the remaining top-level GameObjects into std::vector.
-            for (const std::pair<Guid, GameObject*>& guid_obj_pair : guid_to_obj)
+            for (ObjectId id = 0; id < listed_count; id++)
             {
-                m_gameObjects.push_back(guid_obj_pair.second);
+                if (id_to_json[id] != nullptr && !is_child[id])
+                    m_gameObjects.push_back(m_objectsById[id]);
             }
+        }
+
+        bool Scene::ParsePrefabs(const JSON& obj, const std::vector<const JSON*>& id_to_json)
+        {
+            const std::size_t listed_count = id_to_json.size();
 
             // Get an array of all the JSON Prefabs.
-            std::vector<JSON> json_prefabs{};
-            if (!Core::JsonExtractContainer(obj, "Prefabs", json_prefabs))
+            JSON::const_iterator json_prefabs = obj.find("Prefabs");
+            if (json_prefabs == obj.cend() || !json_prefabs->is_array())
             {
                 HT_DEBUG_PRINTF("Failed to find property 'Prefabs' in scene description!\n");
+                return true;
             }
 
-            for (const Core::JSON& json_obj : json_prefabs)
+            for (const Core::JSON& json_obj : *json_prefabs)
             {
                 // Attempt to parse a GameObject from the provided JSON.
                 GameObject* obj;
@@ -202,54 +484,70 @@ namespace Hatchit {
                 }
 
                 // Validate that the Guid for the parsed GameObject is present in the master list.
-                const Guid& id = obj->GetGuid();
-                std::unordered_set<Guid>::const_iterator iter = guids.find(id);
-                if (iter == guids.cend())
+                ObjectId id = m_guidTable.Find(obj->GetGuid());
+                if (id == InvalidObjectId || id >= listed_count || id_to_json[id] != nullptr)
                 {
-                    HT_DEBUG_PRINTF("Failed to locate %s within 'GUIDs' array in scene description!\n", id.ToString());
+                    HT_DEBUG_PRINTF("Failed to locate %s within 'GUIDs' array in scene description!\n", obj->GetGuid().ToString().c_str());
+                    DestroyGameObject(obj);
                     return false;
                 }
 
+                RegisterGameObject(obj, false);
                 m_prefabs.push_back(obj);
+                ConfigurePool(json_obj, *obj);
             }
 
             return true;
         }
 
-        void Scene::ParseChildGameObjects(const Guid& childGuid, std::unordered_map<Guid, GameObject*>& guidToObj, std::unordered_map<Guid, Core::JSON>& guidToJson)
+        void Scene::ConfigurePool(const JSON& obj, GameObject& prefab)
         {
-            // Locate the child GameObject/JSON.
-            auto childObjIter = guidToObj.find(childGuid);
-            auto childJsonIter = guidToJson.find(childGuid);
-            if ((childObjIter == guidToObj.cend()) || (childJsonIter == guidToJson.cend()))
+            // Extract the Prefab's (optional) pool capacity, and fill the pool now rather than on the first spawns.
+            JSON::const_iterator pool_iter = obj.find("PoolSize");
+            if (pool_iter == obj.cend())
+                return;
+
+            if (!pool_iter->is_number_unsigned())
             {
+                HT_DEBUG_PRINTF("Property 'PoolSize' of Prefab %s is not an unsigned integer!\n", prefab.GetGuid().ToString().c_str());
                 return;
             }
 
-            const Core::JSON& childJsonObj = childJsonIter->second;
-            GameObject* childObj = childObjIter->second;
+            std::size_t capacity = pool_iter->get<std::size_t>();
+            SetPoolSize(prefab, capacity);
+            PrewarmPool(prefab, capacity);
+        }
+
+        void Scene::ParseChildGameObjects(ObjectId childId, const std::vector<const JSON*>& idToJson, std::vector<bool>& isChild)
+        {
+            // Locate the child GameObject/JSON.
+            const Core::JSON* childJsonObj = idToJson[childId];
+            GameObject* childObj = m_objectsById[childId];
+            if (childJsonObj == nullptr || childObj == nullptr)
+            {
+                return;
+            }
 
             // Check if this GameObject has a parent.
             Guid parentGuid;
-            if (!Core::JsonExtract<Core::Guid>(childJsonObj, "Parent", parentGuid))
+            if (!Core::JsonExtract<Core::Guid>(*childJsonObj, "Parent", parentGuid))
             {
                 return;
             }
 
             // Search for the parent GameObject using the parsed Guid.
-            auto parentObjIter = guidToObj.find(parentGuid);
-            if (parentObjIter == guidToObj.cend())
+            ObjectId parentId = m_guidTable.Find(parentGuid);
+            if (parentId == InvalidObjectId || parentId >= idToJson.size() || idToJson[parentId] == nullptr)
             {
                 return;
             }
 
             // Parent the child GameObject to the newly located parent.
-            GameObject* parentObj = parentObjIter->second;
+            GameObject* parentObj = m_objectsById[parentId];
             parentObj->AddChild(childObj);
 
-            // Remove the child GameObject/JSON from the std::unordered_maps.
-            guidToObj.erase(childGuid);
-            guidToJson.erase(childGuid);
+            // Flag the child so it is not treated as a top-level GameObject.
+            isChild[childId] = true;
         }
 
         bool Scene::ParseGameObject(const Core::JSON& obj, GameObject*& out)
@@ -262,9 +560,10 @@ namespace Hatchit {
                 return false;
             }
 
-            // Extract the GameObject's Name.
-            std::string name;
-            if (!Core::JsonExtract<std::string>(obj, "Name", name))
+            // Extract the GameObject's Name, interning it straight from the JSON string.
+            JSON::const_iterator name_iter = obj.find("Name");
+            const JSON::string_t* name = (name_iter != obj.cend()) ? name_iter->get_ptr<const JSON::string_t*>() : nullptr;
+            if (name == nullptr)
             {
                 HT_DEBUG_PRINTF("Failed to find property 'Name' on GameObject %s in scene description!\n", id.ToString());
                 return false;
@@ -278,7 +577,12 @@ namespace Hatchit {
             Transform t = ParseTransform(obj);
 
             // Construct the GameObject using the GUID, Name, and Transform extracted from JSON.
-            out = new GameObject(id, name, t, enabled);
+            out = m_arena.New<GameObject>(this, id, m_names.Intern(*name), t, enabled);
+
+            // Extract the GameObject's (optional) initialization priority.
+            JSON::const_iterator priority_iter = obj.find("InitPriority");
+            if (priority_iter != obj.cend() && priority_iter->is_number_integer())
+                out->m_initPriority = priority_iter->get<int32_t>();
 
             // Attempt to extract a std::vector of Component JSON objects.
             std::vector<Core::JSON> components;
@@ -333,19 +637,22 @@ namespace Hatchit {
 
         bool Scene::ParseComponent(const JSON& obj, GameObject& out)
         {
-            std::string component_type;
             JSON::object_t component_data;
-            if (!Core::JsonExtract<std::string>(obj, "Type", component_type))
+
+            // Look the type up straight from the JSON string so no copy of it is made.
+            JSON::const_iterator type_iter = obj.find("Type");
+            const JSON::string_t* component_type = (type_iter != obj.cend()) ? type_iter->get_ptr<const JSON::string_t*>() : nullptr;
+            if (component_type == nullptr)
             {
-                HT_DEBUG_PRINTF("Failed to locate property 'Name' on Component in scene description!\n");
+                HT_DEBUG_PRINTF("Failed to locate property 'Type' on Component in scene description!\n");
                 return false;
             }
 
-            Component* comp = ComponentFactory::MakeComponent(component_type);
+            Component* comp = NewComponent(component_type->data(), component_type->size());
 
             if (comp == nullptr)
             {
-                HT_DEBUG_PRINTF("Unknown Component type %s in scene description!\n", component_type);
+                HT_DEBUG_PRINTF("Unknown Component type %s in scene description!\n", component_type->c_str());
                 return false;
             }
             else
@@ -353,29 +660,406 @@ namespace Hatchit {
                 if (!comp->VDeserialize(obj))
                 {
                     HT_DEBUG_PRINTF("Component Failed to Deserialize!\n", ((JSON)component_data).dump());
+                    DestroyComponent(comp);
+                }
+                else if (!out.AddUninitializedComponent(comp))
+                {
+                    HT_DEBUG_PRINTF("GameObject already has a Component of type %s!\n", component_type->c_str());
+                    DestroyComponent(comp);
+                }
+            }
+            return true;
+        }
+
+        namespace {
+            /**
+            * \brief Indexes the GameObjects of a list in a scene description by Guid.
+            */
+            void IndexByGuid(const JSON& description, const char* list, std::unordered_map<Guid, const JSON*>& out)
+            {
+                JSON::const_iterator objects = description.find(list);
+                if (objects == description.cend() || !objects->is_array())
+                    return;
+
+                for (const JSON& json_obj : *objects)
+                {
+                    Guid guid;
+                    if (Core::JsonExtract<Guid>(json_obj, "GUID", guid))
+                        out[guid] = &json_obj;
+                }
+            }
+
+            /**
+            * \brief Finds the Component of the provided type within a GameObject's JSON.
+            */
+            const JSON* FindComponentJson(const JSON* gameObject, const JSON::string_t& type)
+            {
+                if (gameObject == nullptr)
+                    return nullptr;
+
+                JSON::const_iterator components = gameObject->find("Components");
+                if (components == gameObject->cend() || !components->is_array())
+                    return nullptr;
+
+                for (const JSON& json_component : *components)
+                {
+                    JSON::const_iterator type_iter = json_component.find("Type");
+                    if (type_iter != json_component.cend() && type_iter->is_string() && *type_iter->get_ptr<const JSON::string_t*>() == type)
+                        return &json_component;
+                }
+                return nullptr;
+            }
+
+            /**
+            * \brief Whether a GameObject is another one or lies somewhere below it.
+            */
+            bool IsSelfOrDescendant(GameObject* gameObject, GameObject* ancestor)
+            {
+                for (; gameObject != nullptr; gameObject = gameObject->GetParent())
+                {
+                    if (gameObject == ancestor)
+                        return true;
+                }
+                return false;
+            }
+        }
+
+        bool Scene::Patch(const JSON& previous, const JSON& next)
+        {
+            JSON::const_iterator next_objects = next.find("GameObjects");
+            if (next_objects == next.cend() || !next_objects->is_array())
+            {
+                HT_DEBUG_PRINTF("Failed to find property 'GameObjects' in scene description!\n");
+                return false;
+            }
+
+            std::unordered_map<Guid, const JSON*> previous_by_guid;
+            IndexByGuid(previous, "GameObjects", previous_by_guid);
+
+            struct Described
+            {
+                GameObject* gameObject;
+                const JSON* json;
+                bool        created;
+            };
+
+            // Patch every GameObject still described, and create the ones that are new.
+            std::vector<Described> described;
+            described.reserve(next_objects->size());
+            std::unordered_set<Guid> next_guids;
+            for (const JSON& json_obj : *next_objects)
+            {
+                Guid guid;
+                if (!Core::JsonExtract<Core::Guid>(json_obj, "GUID", guid))
+                {
+                    HT_DEBUG_PRINTF("Failed to find property 'GUID' on GameObject in scene description!\n");
+                    continue;
+                }
+                next_guids.insert(guid);
+
+                GameObject* gameObject = FindGameObject(guid);
+                if (gameObject != nullptr && !gameObject->m_destroyed)
+                {
+                    std::unordered_map<Guid, const JSON*>::const_iterator previous_obj = previous_by_guid.find(guid);
+                    PatchGameObject(*gameObject, (previous_obj != previous_by_guid.cend()) ? previous_obj->second : nullptr, json_obj);
+                    described.push_back(Described{ gameObject, &json_obj, false });
+                    continue;
+                }
+
+                if (!ParseGameObject(json_obj, gameObject))
+                {
+                    HT_DEBUG_PRINTF("Failed to parse GameObject in scene description!\n");
+                    continue;
+                }
+
+                RegisterGameObject(gameObject);
+                described.push_back(Described{ gameObject, &json_obj, true });
+            }
+
+            // Re-establish parents where they changed. This happens before anything is destroyed,
+            // so a GameObject moved out from under a removed parent survives.
+            for (const Described& entry : described)
+            {
+                GameObject* gameObject = entry.gameObject;
+
+                GameObject* parent = nullptr;
+                Guid parent_guid;
+                if (Core::JsonExtract<Core::Guid>(*entry.json, "Parent", parent_guid))
+                {
+                    parent = FindGameObject(parent_guid);
+                    if (parent != nullptr && parent->m_destroyed)
+                        parent = nullptr;
+
+                    // A GameObject cannot be moved under itself or its own descendants.
+                    if (IsSelfOrDescendant(parent, gameObject))
+                    {
+                        HT_DEBUG_PRINTF("Cannot parent %s to one of its descendants!\n", gameObject->GetGuid().ToString().c_str());
+                        if (!entry.created)
+                            continue;
+                        parent = nullptr;
+                    }
+                }
+
+                if (!entry.created)
+                {
+                    if (parent == gameObject->m_parent)
+                        continue;
+
+                    // A top-level GameObject still waiting in the init queue cannot be pulled out of it.
+                    if (gameObject->m_parent == nullptr && !gameObject->m_initialized)
+                    {
+                        HT_DEBUG_PRINTF("Cannot reparent %s before it is initialized!\n", gameObject->GetGuid().ToString().c_str());
+                        continue;
+                    }
+
+                    if (gameObject->m_parent != nullptr)
+                        gameObject->m_parent->RemoveChild(gameObject);
+                    else
+                        m_gameObjects.erase(std::remove(m_gameObjects.begin(), m_gameObjects.end(), gameObject), m_gameObjects.end());
+
+                    if (parent != nullptr)
+                        parent->AddChild(gameObject);
+                    else
+                        m_gameObjects.push_back(gameObject);
+                }
+                else if (parent != nullptr)
+                {
+                    parent->AddChild(gameObject);
+
+                    // Children of GameObjects that are not initialized yet are initialized along with them.
+                    if (parent->m_initialized)
+                    {
+                        gameObject->OnInit();
+                        if (gameObject->GetEnabled())
+                            gameObject->OnEnabled();
+                    }
                 }
                 else
                 {
-                    out.AddUninitializedComponent(comp);
+                    QueueInit(gameObject);
                 }
             }
+
+            // Destroy the GameObjects the previous file described and the new one does not. Anything
+            // spawned at runtime was never in either file and is left alone.
+            for (const std::pair<const Guid, const JSON*>& previous_obj : previous_by_guid)
+            {
+                if (next_guids.count(previous_obj.first) != 0)
+                    continue;
+
+                GameObject* gameObject = FindGameObject(previous_obj.first);
+                if (gameObject != nullptr && !gameObject->m_destroyed)
+                    gameObject->MarkForDestroy();
+            }
+
+            PatchPrefabs(previous, next);
+
             return true;
         }
 
-        void Scene::Init()
+        void Scene::PatchGameObject(GameObject& gameObject, const JSON* previous, const JSON& next)
         {
-            for (GameObject* gameObject : m_gameObjects)
+            // Name.
+            JSON::const_iterator name_iter = next.find("Name");
+            const JSON::string_t* name = (name_iter != next.cend()) ? name_iter->get_ptr<const JSON::string_t*>() : nullptr;
+            if (name != nullptr && *name != gameObject.GetName())
             {
-                gameObject->OnInit();
+                RemoveFromNameIndex(&gameObject);
+                gameObject.m_name = m_names.Intern(*name);
+                m_nameIndex.insert(std::make_pair(gameObject.m_name, &gameObject));
             }
 
-            for (GameObject* gameObject : m_gameObjects)
+            // Transform, only if it was edited, so GameObjects moved at runtime stay where they are.
+            JSON::const_iterator transform_iter = next.find("Transform");
+            const JSON* previous_transform = nullptr;
+            if (previous != nullptr)
+            {
+                JSON::const_iterator iter = previous->find("Transform");
+                if (iter != previous->cend())
+                    previous_transform = &*iter;
+            }
+            if (transform_iter != next.cend() && (previous_transform == nullptr || *previous_transform != *transform_iter))
+            {
+                Transform t = ParseTransform(next);
+                gameObject.m_transform.SetPosition(t.GetPosition());
+                gameObject.m_transform.SetRotation(t.GetRotation());
+                gameObject.m_transform.SetScale(t.GetScale());
+            }
+
+            // Remove Components whose type is no longer described.
+            if (previous != nullptr)
+            {
+                JSON::const_iterator components = previous->find("Components");
+                if (components != previous->cend() && components->is_array())
+                {
+                    for (const JSON& json_component : *components)
+                    {
+                        JSON::const_iterator type_iter = json_component.find("Type");
+                        if (type_iter == json_component.cend() || !type_iter->is_string())
+                            continue;
+
+                        const JSON::string_t& type = *type_iter->get_ptr<const JSON::string_t*>();
+                        const ComponentRegistry::Entry* entry = ComponentRegistry::Find(type);
+                        if (entry != nullptr && FindComponentJson(&next, type) == nullptr)
+                            gameObject.RemoveComponent(entry->typeId);
+                    }
+                }
+            }
+
+            // Add new Components, and deserialize edited ones in place.
+            JSON::const_iterator components = next.find("Components");
+            if (components == next.cend() || !components->is_array())
+                return;
+
+            for (const JSON& json_component : *components)
+            {
+                JSON::const_iterator type_iter = json_component.find("Type");
+                if (type_iter == json_component.cend() || !type_iter->is_string())
+                    continue;
+
+                const JSON::string_t& type = *type_iter->get_ptr<const JSON::string_t*>();
+                const ComponentRegistry::Entry* entry = ComponentRegistry::Find(type);
+                if (entry == nullptr)
+                {
+                    HT_DEBUG_PRINTF("Unknown Component type %s in scene description!\n", type.c_str());
+                    continue;
+                }
+
+                GameObject::ComponentMap::const_iterator existing = gameObject.m_componentMap.find(entry->typeId);
+                if (existing != gameObject.m_componentMap.cend())
+                {
+                    const JSON* previous_component = FindComponentJson(previous, type);
+                    if (previous_component == nullptr || *previous_component != json_component)
+                    {
+                        if (!gameObject.m_components[existing->second]->VDeserialize(json_component))
+                            HT_DEBUG_PRINTF("Component Failed to Deserialize!\n");
+                    }
+                    continue;
+                }
+
+                if (!ParseComponent(json_component, gameObject))
+                    continue;
+
+                // GameObjects still waiting to be initialized initialize the new Component themselves.
+                if (gameObject.m_initialized)
+                {
+                    existing = gameObject.m_componentMap.find(entry->typeId);
+                    if (existing != gameObject.m_componentMap.cend())
+                        gameObject.m_components[existing->second]->VOnInit();
+                }
+            }
+        }
+
+        void Scene::PatchPrefabs(const JSON& previous, const JSON& next)
+        {
+            std::unordered_map<Guid, const JSON*> previous_by_guid;
+            IndexByGuid(previous, "Prefabs", previous_by_guid);
+
+            std::unordered_map<Guid, const JSON*> next_by_guid;
+            IndexByGuid(next, "Prefabs", next_by_guid);
+
+            // Keep the Prefabs whose JSON is unchanged; destroy the rest, to be parsed again below.
+            std::size_t kept = 0;
+            for (GameObject* prefab : m_prefabs)
+            {
+                std::unordered_map<Guid, const JSON*>::const_iterator next_prefab = next_by_guid.find(prefab->m_guid);
+                std::unordered_map<Guid, const JSON*>::const_iterator previous_prefab = previous_by_guid.find(prefab->m_guid);
+                if (next_prefab != next_by_guid.cend() && previous_prefab != previous_by_guid.cend() && *next_prefab->second == *previous_prefab->second)
+                {
+                    m_prefabs[kept++] = prefab;
+                    next_by_guid.erase(next_prefab);
+                }
+                else
+                {
+                    // Pooled instances were copied from the old Prefab.
+                    SetPoolSize(*prefab, 0);
+                    DestroyGameObject(prefab);
+                }
+            }
+            m_prefabs.resize(kept);
+
+            for (const std::pair<const Guid, const JSON*>& json_prefab : next_by_guid)
             {
-                if (gameObject->GetEnabled())
-                    gameObject->OnEnabled();
+                GameObject* prefab;
+                if (!ParseGameObject(*json_prefab.second, prefab))
+                {
+                    HT_DEBUG_PRINTF("Failed to parse Prefab in scene description!\n");
+                    continue;
+                }
+
+                RegisterGameObject(prefab, false);
+                m_prefabs.push_back(prefab);
+                ConfigurePool(*json_prefab.second, *prefab);
             }
         }
 
+        void Scene::Init()
+        {
+            // Loaded GameObjects only join the update list once they have been initialized.
+            std::vector<GameObject*> loaded;
+            loaded.swap(m_gameObjects);
+            for (GameObject* gameObject : loaded)
+            {
+                QueueInit(gameObject);
+            }
+
+            ProcessInitQueue();
+        }
+
+        void Scene::SetInitBudget(uint32_t microseconds)
+        {
+            m_initBudget = microseconds;
+        }
+
+        uint32_t Scene::GetInitBudget() const
+        {
+            return m_initBudget;
+        }
+
+        std::size_t Scene::GetPendingInitCount() const
+        {
+            return m_initQueue.size();
+        }
+
+        RenderQueue& Scene::GetRenderQueue()
+        {
+            return m_renderQueue;
+        }
+
+        void Scene::QueueInit(GameObject* gameObject)
+        {
+            m_initQueue.push(PendingInit{ gameObject->m_initPriority, m_initSequence++, gameObject });
+        }
+
+        void Scene::ProcessInitQueue()
+        {
+            if (m_initQueue.empty())
+                return;
+
+            typedef std::chrono::steady_clock Clock;
+            const Clock::time_point deadline = Clock::now() + std::chrono::microseconds(m_initBudget);
+
+            do
+            {
+                GameObject* gameObject = m_initQueue.top().gameObject;
+                m_initQueue.pop();
+
+                // Destroyed before it was ever initialized; Update() deletes it with the rest.
+                if (!gameObject->m_destroyed)
+                {
+                    gameObject->OnInit();
+                    if (gameObject->GetEnabled())
+                        gameObject->OnEnabled();
+                }
+
+                m_gameObjects.push_back(gameObject);
+            } while (!m_initQueue.empty() && (m_initBudget == 0 || Clock::now() < deadline));
+
+            // Every Component now holds its own handles.
+            if (m_initQueue.empty())
+                m_prefetcher.Release();
+        }
+
         /**
          * \brief Renders this scene.
          */
@@ -386,6 +1070,8 @@ namespace Hatchit {
                 Transform& t = obj->GetTransform();
                 t.UpdateWorldMatrix();
             }
+
+            m_renderQueue.Submit();
         }
         
         /**
@@ -393,15 +1079,24 @@ namespace Hatchit {
          */
         void Scene::Update()
         {
+            // Spawns made while updating land in this scene, even if it is a fork.
+            Scene* previous = instance;
+            instance = this;
+
+            m_renderQueue.Clear();
+
+            ProcessInitQueue();
+
             // # of deleted objects so far this pass (number to shift elements back by)
             std::size_t shift = 0;
 
             for (std::size_t i = 0; i < m_gameObjects.size(); i++)
             {
-                // if an object is marked to be destroyed, delete it and increase the shift size
+                // if an object is marked to be destroyed, recycle or delete it and increase the shift size
                 if (m_gameObjects[i]->m_destroyed)
                 {
-                    delete m_gameObjects[i];
+                    if (!ReleaseToPool(m_gameObjects[i]))
+                        DestroyGameObject(m_gameObjects[i]);
                     shift++;
                 }
                 //if the object is fine to update, update it and then shift it back
@@ -414,6 +1109,8 @@ namespace Hatchit {
 
             //shrink the vector by the number of deleted objects
             m_gameObjects.resize(m_gameObjects.size() - shift);
+
+            instance = previous;
         }
         
         /**
@@ -421,12 +1118,252 @@ namespace Hatchit {
          */
         void Scene::Unload()
         {
+            // Pooled instances are unregistered, so the pass over m_objectsById below would miss them.
+            ClearPools();
+
+            // Nothing can be looked up by name from here on, so skip removing each GameObject from the index.
+            m_nameIndex.clear();
+
             for (GameObject* gameObject : m_gameObjects)
             {
                 gameObject->MarkForDestroy();
-                delete gameObject;
             }
             m_gameObjects.clear();
+
+            while (!m_initQueue.empty())
+            {
+                m_initQueue.top().gameObject->MarkForDestroy();
+                m_initQueue.pop();
+            }
+            m_prefabs.clear();
+            m_description = Resource::SceneHandle();
+
+            // Every GameObject still alive, prefabs and queued ones included, is registered and lives in the arena.
+            // Their vectors and maps allocate from the arena too, so only Components whose teardown releases
+            // something need their destructors run before the arena is freed in one step.
+            for (GameObject* gameObject : m_objectsById)
+            {
+                if (gameObject == nullptr)
+                    continue;
+
+                for (Component* component : gameObject->m_components)
+                {
+                    if (component == nullptr)
+                        continue;
+
+                    if (!m_arena.Owns(component))
+                    {
+                        delete component;
+                        continue;
+                    }
+
+                    const ComponentRegistry::Entry* entry = ComponentRegistry::Find(component->VGetComponentTypeId());
+                    if (entry == nullptr || !(entry->flags & ComponentRegistry::TRIVIAL_TEARDOWN))
+                        component->~Component();
+                }
+
+                gameObject->m_transform.~Transform();
+            }
+
+            m_objectsById.clear();
+            m_guidTable.Clear();
+            m_names.Clear();
+            m_arena.Release();
+        }
+
+        void Scene::CollectLiveGameObjects(std::vector<GameObject*>& objects, std::vector<uint32_t>& parents, std::vector<bool>& visited) const
+        {
+            objects.clear();
+            parents.clear();
+            visited.assign(m_objectsById.size(), false);
+
+            for (GameObject* prefab : m_prefabs)
+            {
+                if (prefab->m_id < visited.size())
+                    visited[prefab->m_id] = true;
+            }
+
+            for (GameObject* gameObject : m_gameObjects)
+                CollectHierarchy(*gameObject, UINT32_MAX, objects, parents, visited);
+
+            // Top-level GameObjects still in the init queue, which cannot be iterated. They are taken in Guid
+            // order, since the same GameObjects recreated by a restore may have been given other ObjectIds.
+            std::vector<GameObject*> queued;
+            for (GameObject* gameObject : m_objectsById)
+            {
+                if (gameObject != nullptr && gameObject->m_parent == nullptr && !gameObject->m_destroyed &&
+                    gameObject->m_id < visited.size() && !visited[gameObject->m_id])
+                    queued.push_back(gameObject);
+            }
+            std::sort(queued.begin(), queued.end(), [](const GameObject* lhs, const GameObject* rhs)
+            {
+                return std::memcmp(&lhs->m_guid, &rhs->m_guid, sizeof(Core::Guid)) < 0;
+            });
+
+            for (GameObject* gameObject : queued)
+                CollectHierarchy(*gameObject, UINT32_MAX, objects, parents, visited);
+        }
+
+        void Scene::CollectHierarchy(GameObject& gameObject, uint32_t parent, std::vector<GameObject*>& objects,
+            std::vector<uint32_t>& parents, std::vector<bool>& visited)
+        {
+            if (gameObject.m_destroyed || gameObject.m_id >= visited.size() || visited[gameObject.m_id])
+                return;
+
+            visited[gameObject.m_id] = true;
+
+            uint32_t index = static_cast<uint32_t>(objects.size());
+            objects.push_back(&gameObject);
+            parents.push_back(parent);
+
+            for (GameObject* child : gameObject.m_children)
+                CollectHierarchy(*child, index, objects, parents, visited);
+        }
+
+        void Scene::DestroyMainThreadComponents()
+        {
+            // Pooled instances have had VOnDestroy already, or were never initialized.
+            ClearPools();
+
+            auto destroy = [this](GameObject* gameObject, bool live)
+            {
+                for (Component*& component : gameObject->m_components)
+                {
+                    if (component == nullptr)
+                        continue;
+
+                    ComponentTypeId typeId = component->VGetComponentTypeId();
+                    const ComponentRegistry::Entry* entry = ComponentRegistry::Find(typeId);
+                    if (entry == nullptr || !(entry->flags & ComponentRegistry::MAIN_THREAD_TEARDOWN))
+                        continue;
+
+                    if (live)
+                    {
+                        if (component->GetEnabled())
+                            component->SetEnabled(false);
+                        component->VOnDestroy();
+                    }
+
+                    DestroyComponent(component);
+                    component = nullptr;
+                    gameObject->m_componentMap.erase(typeId);
+                }
+            };
+
+            // Prefabs are destroyed without VOnDestroy, as in Unload(); clear them first so the pass below skips them.
+            for (GameObject* prefab : m_prefabs)
+            {
+                destroy(prefab, false);
+            }
+
+            // GameObjects still waiting in the init queue never had VOnInit, so they get no VOnDestroy either.
+            for (GameObject* gameObject : m_objectsById)
+            {
+                if (gameObject != nullptr)
+                    destroy(gameObject, !gameObject->m_destroyed && gameObject->m_initialized);
+            }
+
+            // The prefetched handles would otherwise be dropped with the Scene, on whichever thread deletes it.
+            m_prefetcher.Release();
+        }
+
+        void Scene::DestroyGameObject(GameObject* gameObject)
+        {
+            if (m_arena.Owns(gameObject))
+            {
+                gameObject->~GameObject();
+                m_arena.Free(gameObject, sizeof(GameObject));
+            }
+            else
+                delete gameObject;
+        }
+
+        void Scene::DestroyComponent(Component* component)
+        {
+            if (!m_arena.Owns(component))
+            {
+                delete component;
+                return;
+            }
+
+            // Components in the arena were built from their registry entry, which knows their size.
+            const ComponentRegistry::Entry* entry = ComponentRegistry::Find(component->VGetComponentTypeId());
+            void* memory = dynamic_cast<void*>(component);
+            component->~Component();
+            if (entry != nullptr)
+                m_arena.Free(memory, entry->size);
+        }
+
+        Component* Scene::NewComponent(const char* type, std::size_t length)
+        {
+            const ComponentRegistry::Entry* entry = ComponentRegistry::Find(type, length);
+            if (entry == nullptr)
+                return nullptr;
+
+            return entry->constructAt(m_arena.Allocate(entry->size, entry->align));
+        }
+
+        Component* Scene::CloneComponent(const Component& component)
+        {
+            const ComponentRegistry::Entry* entry = ComponentRegistry::Find(component.VGetComponentTypeId());
+            if (entry == nullptr)
+                return component.VClone();
+
+            return entry->copyConstructAt(m_arena.Allocate(entry->size, entry->align), component);
+        }
+
+        Component* Scene::RebuildComponent(const GameObject* prefab, const Core::Guid& guid, const std::string& type)
+        {
+            const Component* prototype = FindPrefabComponent(prefab, type);
+            if (prototype != nullptr)
+                return CloneComponent(*prototype);
+
+            const JSON* description = FindDescribedComponent(guid, type);
+            if (description == nullptr)
+                return nullptr;
+
+            Component* component = NewComponent(type.data(), type.size());
+            if (component != nullptr && !component->VDeserialize(*description))
+            {
+                HT_DEBUG_PRINTF("Component %s Failed to Deserialize!\n", type.c_str());
+                DestroyComponent(component);
+                return nullptr;
+            }
+            return component;
+        }
+
+        bool Scene::CanRebuildComponent(const GameObject* prefab, const Core::Guid& guid, const std::string& type) const
+        {
+            return FindPrefabComponent(prefab, type) != nullptr || FindDescribedComponent(guid, type) != nullptr;
+        }
+
+        const Component* Scene::FindPrefabComponent(const GameObject* prefab, const std::string& type)
+        {
+            const ComponentRegistry::Entry* entry = ComponentRegistry::Find(type);
+            if (prefab == nullptr || entry == nullptr)
+                return nullptr;
+
+            GameObject::ComponentMap::const_iterator iter = prefab->m_componentMap.find(entry->typeId);
+            return (iter != prefab->m_componentMap.cend()) ? prefab->m_components[iter->second] : nullptr;
+        }
+
+        const JSON* Scene::FindDescribedComponent(const Core::Guid& guid, const std::string& type) const
+        {
+            if (!m_description.IsValid())
+                return nullptr;
+
+            const JSON& description = m_description->GetSceneDescription();
+            JSON::const_iterator objects = description.find("GameObjects");
+            if (objects == description.cend() || !objects->is_array())
+                return nullptr;
+
+            for (const JSON& json_obj : *objects)
+            {
+                Guid described;
+                if (Core::JsonExtract<Guid>(json_obj, "GUID", described) && described == guid)
+                    return FindComponentJson(&json_obj, type);
+            }
+            return nullptr;
         }
 
         /**
@@ -434,8 +1371,10 @@ namespace Hatchit {
          */
         GameObject* Scene::CreateGameObject()
         {
-            instance->m_gameObjects.emplace_back(nullptr);
-            return (GameObject*)&instance->m_gameObjects.back();
+            GameObject* gameObject = instance->m_arena.New<GameObject>(instance);
+            instance->RegisterGameObject(gameObject);
+            instance->m_gameObjects.push_back(gameObject);
+            return gameObject;
         }
 
         /**
@@ -443,23 +1382,265 @@ namespace Hatchit {
          */
         GameObject* Scene::CreateGameObject(GameObject& prefab)
         {
-            GameObject* gameObject = CreateGameObject();
-            gameObject->m_transform = prefab.GetTransform();
-            
-            for (const Game::Component* const component : prefab.m_components)
+            GameObject* gameObject = instance->TakeFromPool(prefab);
+            if (gameObject == nullptr)
+            {
+                gameObject = instance->m_arena.New<GameObject>(instance);
+                gameObject->m_name = prefab.m_name;
+                gameObject->m_initPriority = prefab.m_initPriority;
+                gameObject->m_transform = prefab.GetTransform();
+                gameObject->m_prefab = prefab.m_id;
+                instance->RegisterGameObject(gameObject);
+
+                for (const Game::Component* const component : prefab.m_components)
+                {
+                    if (component != nullptr)
+                        gameObject->AddUninitializedComponent(instance->CloneComponent(*component));
+                }
+            }
+
+            // Initialized and added to the update list within the Scene's init budget.
+            instance->QueueInit(gameObject);
+            return gameObject;
+        }
+
+        std::size_t Scene::Instantiate(GameObject& prefab, std::size_t count, const Transform* transforms, std::vector<GameObject*>* out)
+        {
+            if (instance == nullptr || count == 0)
+                return 0;
+
+            Scene& scene = *instance;
+
+            scene.m_guidTable.Reserve(scene.m_guidTable.Size() + count);
+            scene.m_objectsById.reserve(scene.m_guidTable.Size() + count);
+            scene.m_gameObjects.reserve(scene.m_gameObjects.size() + count);
+
+            // Recycled instances first, then whatever the pool could not supply is copied in bulk.
+            std::vector<GameObject*> objects;
+            objects.reserve(count);
+            while (objects.size() < count)
+            {
+                GameObject* gameObject = scene.TakeFromPool(prefab);
+                if (gameObject == nullptr)
+                    break;
+                objects.push_back(gameObject);
+            }
+
+            std::size_t recycled = objects.size();
+            objects.resize(count);
+            scene.CopyPrefab(prefab, count - recycled, objects.data() + recycled);
+
+            // Initialized and added to the update list within the Scene's init budget, like CreateGameObject(GameObject&).
+            for (std::size_t i = 0; i < count; i++)
+            {
+                if (transforms != nullptr)
+                    objects[i]->m_transform = transforms[i];
+                if (i >= recycled)
+                    scene.RegisterGameObject(objects[i]);
+                scene.QueueInit(objects[i]);
+            }
+
+            if (out != nullptr)
+                out->insert(out->end(), objects.begin(), objects.end());
+
+            return count;
+        }
+
+        void Scene::CopyPrefab(GameObject& prefab, std::size_t count, GameObject** out)
+        {
+            if (count == 0)
+                return;
+
+            std::vector<const Component*> prototypes;
+            std::vector<const ComponentRegistry::Entry*> entries;
+            for (const Component* component : prefab.m_components)
+            {
+                if (component == nullptr)
+                    continue;
+                prototypes.push_back(component);
+                entries.push_back(ComponentRegistry::Find(component->VGetComponentTypeId()));
+            }
+
+            // Every GameObject in one block.
+            GameObject* objects = static_cast<GameObject*>(m_arena.Allocate(sizeof(GameObject) * count, alignof(GameObject)));
+            for (std::size_t i = 0; i < count; i++)
+            {
+                GameObject* gameObject = new (objects + i) GameObject(this);
+                gameObject->m_name = prefab.m_name;
+                gameObject->m_initPriority = prefab.m_initPriority;
+                gameObject->m_transform = prefab.GetTransform();
+                gameObject->m_prefab = prefab.m_id;
+                gameObject->m_components.reserve(prototypes.size());
+                out[i] = gameObject;
+            }
+
+            // Then every Component of one type in one block, copied in a single loop.
+            std::vector<Component*> copies(count);
+            for (std::size_t c = 0; c < prototypes.size(); c++)
+            {
+                const ComponentRegistry::Entry* entry = entries[c];
+                if (entry != nullptr)
+                    entry->copyConstructArray(m_arena.Allocate(entry->size * count, entry->align), *prototypes[c], count, copies.data());
+                else
+                {
+                    for (std::size_t i = 0; i < count; i++)
+                        copies[i] = prototypes[c]->VClone();
+                }
+
+                for (std::size_t i = 0; i < count; i++)
+                    objects[i].AddUninitializedComponent(copies[i]);
+            }
+        }
+
+        void Scene::SetPoolSize(GameObject& prefab, std::size_t capacity)
+        {
+            if (prefab.m_scene != this || prefab.m_id == InvalidObjectId)
             {
-                gameObject->AddUninitializedComponent(component->VClone());
+                HT_DEBUG_PRINTF("Cannot pool a GameObject that is not a prefab of this scene!\n");
+                return;
             }
-            for (Game::Component* component : gameObject->m_components)
+
+            std::unordered_map<ObjectId, PrefabPool>::iterator pool = m_pools.find(prefab.m_id);
+            if (pool == m_pools.end())
             {
-                component->VOnInit();
+                if (capacity == 0)
+                    return;
+                pool = m_pools.insert(std::make_pair(prefab.m_id, PrefabPool{ &prefab, 0, std::vector<GameObject*>() })).first;
             }
-            for (Game::Component* component : gameObject->m_components)
+
+            pool->second.prefab = &prefab;
+            pool->second.capacity = capacity;
+            while (pool->second.free.size() > capacity)
             {
-                component->SetEnabled(true);
+                DestroyGameObject(pool->second.free.back());
+                pool->second.free.pop_back();
             }
+
+            if (capacity == 0)
+                m_pools.erase(pool);
+        }
+
+        std::size_t Scene::PrewarmPool(GameObject& prefab, std::size_t count)
+        {
+            std::unordered_map<ObjectId, PrefabPool>::iterator pool = m_pools.find(prefab.m_id);
+            if (pool == m_pools.end())
+                return 0;
+
+            std::vector<GameObject*>& free = pool->second.free;
+            count = std::min(count, pool->second.capacity - free.size());
+
+            std::size_t first = free.size();
+            free.resize(first + count);
+            CopyPrefab(prefab, count, free.data() + first);
+            return count;
+        }
+
+        std::size_t Scene::GetPooledCount(const GameObject& prefab) const
+        {
+            std::unordered_map<ObjectId, PrefabPool>::const_iterator pool = m_pools.find(prefab.m_id);
+            return (pool != m_pools.cend()) ? pool->second.free.size() : 0;
+        }
+
+        GameObject* Scene::TakeFromPool(GameObject& prefab)
+        {
+            std::unordered_map<ObjectId, PrefabPool>::iterator pool = m_pools.find(prefab.m_id);
+            if (pool == m_pools.end() || pool->second.free.empty())
+                return nullptr;
+
+            GameObject* gameObject = pool->second.free.back();
+            pool->second.free.pop_back();
+
+            // A spawned instance is a new GameObject as far as lookups, snapshots and deltas are concerned.
+            gameObject->m_guid = Core::Guid();
+            RegisterGameObject(gameObject);
             return gameObject;
         }
 
+        bool Scene::ReleaseToPool(GameObject* gameObject)
+        {
+            if (gameObject->m_prefab == InvalidObjectId || !gameObject->m_children.empty() || !m_arena.Owns(gameObject))
+                return false;
+
+            std::unordered_map<ObjectId, PrefabPool>::iterator pool = m_pools.find(gameObject->m_prefab);
+            if (pool == m_pools.end() || pool->second.free.size() >= pool->second.capacity)
+                return false;
+
+            if (!ResetToPrefab(*gameObject, *pool->second.prefab))
+                return false;
+
+            // MarkForDestroy() already took it out of the name index.
+            UnregisterGameObject(gameObject);
+            gameObject->m_scene = this;
+            gameObject->m_id = InvalidObjectId;
+
+            pool->second.free.push_back(gameObject);
+            return true;
+        }
+
+        bool Scene::ResetToPrefab(GameObject& gameObject, const GameObject& prefab)
+        {
+            // Components may have been removed or added since the instance was spawned; only reset it if
+            // what is left still matches the prefab one for one.
+            ComponentList& components = gameObject.m_components;
+            components.erase(std::remove(components.begin(), components.end(), nullptr), components.end());
+
+            std::size_t index = 0;
+            for (const Component* prototype : prefab.m_components)
+            {
+                if (prototype == nullptr)
+                    continue;
+                if (index == components.size() || components[index]->VGetComponentTypeId() != prototype->VGetComponentTypeId())
+                    return false;
+                index++;
+            }
+            if (index != components.size())
+                return false;
+
+            gameObject.m_componentMap.clear();
+            index = 0;
+            for (const Component* prototype : prefab.m_components)
+            {
+                if (prototype == nullptr)
+                    continue;
+
+                Component*& component = components[index];
+                const ComponentRegistry::Entry* entry = ComponentRegistry::Find(prototype->VGetComponentTypeId());
+                if (entry != nullptr && m_arena.Owns(component))
+                {
+                    // Same type, so the prefab's state is copied back into the same memory.
+                    void* memory = dynamic_cast<void*>(component);
+                    component->~Component();
+                    component = entry->copyConstructAt(memory, *prototype);
+                }
+                else
+                {
+                    DestroyComponent(component);
+                    component = prototype->VClone();
+                }
+
+                component->SetOwner(&gameObject);
+                gameObject.m_componentMap.insert(std::make_pair(component->VGetComponentTypeId(), index));
+                index++;
+            }
+
+            gameObject.m_name = prefab.m_name;
+            gameObject.m_initPriority = prefab.m_initPriority;
+            gameObject.m_transform = prefab.m_transform;
+            gameObject.m_enabled = true;
+            gameObject.m_destroyed = false;
+            gameObject.m_initialized = false;
+            return true;
+        }
+
+        void Scene::ClearPools()
+        {
+            for (std::pair<const ObjectId, PrefabPool>& pool : m_pools)
+            {
+                for (GameObject* gameObject : pool.second.free)
+                    DestroyGameObject(gameObject);
+            }
+            m_pools.clear();
+        }
+
     }
 }
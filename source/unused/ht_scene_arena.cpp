@@ -0,0 +1,160 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_scene_arena.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        SceneArena::SceneArena(std::size_t chunkSize)
+            : m_chunkSize(chunkSize), m_cursor(nullptr), m_limit(nullptr), m_used(0), m_reserved(0)
+        {
+        }
+
+        SceneArena::SceneArena(SceneArena&& rhs)
+            : m_chunkSize(rhs.m_chunkSize), m_chunks(std::move(rhs.m_chunks)),
+            m_freeLists(std::move(rhs.m_freeLists)), m_cursor(rhs.m_cursor), m_limit(rhs.m_limit),
+            m_used(rhs.m_used), m_reserved(rhs.m_reserved)
+        {
+            rhs.m_chunks.clear();
+            rhs.m_freeLists.clear();
+            rhs.m_cursor = rhs.m_limit = nullptr;
+            rhs.m_used = rhs.m_reserved = 0;
+        }
+
+        SceneArena& SceneArena::operator=(SceneArena&& rhs)
+        {
+            if (this != &rhs)
+            {
+                Release();
+                m_chunkSize = rhs.m_chunkSize;
+                m_chunks = std::move(rhs.m_chunks);
+                m_freeLists = std::move(rhs.m_freeLists);
+                m_cursor = rhs.m_cursor;
+                m_limit = rhs.m_limit;
+                m_used = rhs.m_used;
+                m_reserved = rhs.m_reserved;
+
+                rhs.m_chunks.clear();
+                rhs.m_freeLists.clear();
+                rhs.m_cursor = rhs.m_limit = nullptr;
+                rhs.m_used = rhs.m_reserved = 0;
+            }
+            return *this;
+        }
+
+        SceneArena::~SceneArena(void)
+        {
+            Release();
+        }
+
+        void* SceneArena::Allocate(std::size_t size, std::size_t align)
+        {
+            if (!m_freeLists.empty())
+            {
+                std::unordered_map<std::size_t, FreeBlock*>::iterator list = m_freeLists.find(size);
+                if (list != m_freeLists.end() && (reinterpret_cast<uintptr_t>(list->second) & (align - 1)) == 0)
+                {
+                    FreeBlock* block = list->second;
+                    if (block->next != nullptr)
+                        list->second = block->next;
+                    else
+                        m_freeLists.erase(list);
+
+                    m_used += size;
+                    return block;
+                }
+            }
+
+            uintptr_t aligned = (reinterpret_cast<uintptr_t>(m_cursor) + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+            if (m_cursor == nullptr || aligned + size > reinterpret_cast<uintptr_t>(m_limit))
+            {
+                Grow(size, align);
+                aligned = (reinterpret_cast<uintptr_t>(m_cursor) + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+            }
+
+            m_cursor = reinterpret_cast<uint8_t*>(aligned + size);
+            m_used += size;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        void SceneArena::Free(void* pointer, std::size_t size)
+        {
+            if (pointer == nullptr || size < sizeof(FreeBlock) || (reinterpret_cast<uintptr_t>(pointer) & (alignof(FreeBlock) - 1)) != 0)
+                return;
+
+            FreeBlock*& head = m_freeLists[size];
+            head = new (pointer) FreeBlock{ head };
+            m_used -= size;
+        }
+
+        bool SceneArena::Owns(const void* pointer) const
+        {
+            const uint8_t* address = static_cast<const uint8_t*>(pointer);
+
+            // Find the last chunk starting at or before the address.
+            std::vector<Chunk>::const_iterator iter = std::upper_bound(m_chunks.cbegin(), m_chunks.cend(), address,
+                [](const uint8_t* value, const Chunk& chunk) { return std::less<const uint8_t*>()(value, chunk.begin); });
+            if (iter == m_chunks.cbegin())
+                return false;
+
+            --iter;
+            return std::less<const uint8_t*>()(address, iter->end);
+        }
+
+        void SceneArena::Release(void)
+        {
+            for (const Chunk& chunk : m_chunks)
+                std::free(chunk.begin);
+
+            m_chunks.clear();
+            m_freeLists.clear();
+            m_cursor = m_limit = nullptr;
+            m_used = m_reserved = 0;
+        }
+
+        std::size_t SceneArena::BytesUsed(void) const
+        {
+            return m_used;
+        }
+
+        std::size_t SceneArena::BytesReserved(void) const
+        {
+            return m_reserved;
+        }
+
+        void SceneArena::Grow(std::size_t size, std::size_t align)
+        {
+            // Oversized allocations get a chunk of their own.
+            std::size_t chunkSize = std::max(m_chunkSize, size + align);
+
+            uint8_t* begin = static_cast<uint8_t*>(std::malloc(chunkSize));
+            if (begin == nullptr)
+                throw std::bad_alloc();
+
+            Chunk chunk{ begin, begin + chunkSize };
+            m_chunks.insert(std::upper_bound(m_chunks.begin(), m_chunks.end(), chunk,
+                [](const Chunk& lhs, const Chunk& rhs) { return std::less<uint8_t*>()(lhs.begin, rhs.begin); }), chunk);
+
+            m_cursor = chunk.begin;
+            m_limit = chunk.end;
+            m_reserved += chunkSize;
+        }
+    }
+}
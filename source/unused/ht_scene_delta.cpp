@@ -0,0 +1,913 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_scene_delta.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+
+            const uint32_t DeltaMagic = 0x44535448; // "HTSD"
+
+            // Header flags.
+            const uint8_t DeltaTypes        = 1 << 0; // A new type table follows.
+            const uint8_t DeltaOrder        = 1 << 1; // The order of every GameObject follows.
+
+            // What changed on a surviving GameObject.
+            const uint8_t ChangedParent     = 1 << 0;
+            const uint8_t ChangedFlags      = 1 << 1;
+            const uint8_t ChangedName       = 1 << 2;
+            const uint8_t ChangedTransform  = 1 << 3;
+            const uint8_t PatchedComponents = 1 << 4; // Same Component types, some state changed.
+            const uint8_t ReplacedComponents = 1 << 5; // Component types changed; all are resent.
+
+            // Quantization steps of position, rotation and scale. Powers of two, so a quantized
+            // value is represented exactly and quantizing it again gives back the same step count.
+            const float TransformSteps[9] = {
+                1.0f / 1024.0f, 1.0f / 1024.0f, 1.0f / 1024.0f,
+                1.0f / 4096.0f, 1.0f / 4096.0f, 1.0f / 4096.0f,
+                1.0f / 4096.0f, 1.0f / 4096.0f, 1.0f / 4096.0f
+            };
+            const double QuantizeLimit = 1073741823.0;
+
+            // Changed bytes closer together than this are sent as a single run.
+            const uint32_t RunGap = 4;
+
+            // Largest ObjectId a delta may refer to, so a corrupt delta cannot make Apply allocate without bound.
+            // Scenes reuse the ids of deleted GameObjects, so this caps GameObjects alive at once, not spawned in total.
+            const ObjectId MaxObjectId = 1 << 24;
+
+            // Guids are sent as their 16 raw bytes.
+            static_assert(sizeof(Core::Guid) == 16, "Core::Guid is expected to hold exactly its 16 bytes");
+
+            int32_t Quantize(float value, int channel)
+            {
+                double steps = static_cast<double>(value) / TransformSteps[channel];
+                if (steps != steps)
+                    return 0;
+                if (steps > QuantizeLimit)
+                    steps = QuantizeLimit;
+                else if (steps < -QuantizeLimit)
+                    steps = -QuantizeLimit;
+                return static_cast<int32_t>(std::lround(steps));
+            }
+
+            float Dequantize(int32_t steps, int channel)
+            {
+                return static_cast<float>(steps) * TransformSteps[channel];
+            }
+
+            template <typename T>
+            void Put(std::vector<uint8_t>& out, const T& value)
+            {
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                out.insert(out.end(), bytes, bytes + sizeof(T));
+            }
+
+            void PutVarint(std::vector<uint8_t>& out, uint32_t value)
+            {
+                while (value >= 0x80)
+                {
+                    out.push_back(static_cast<uint8_t>(value | 0x80));
+                    value >>= 7;
+                }
+                out.push_back(static_cast<uint8_t>(value));
+            }
+
+            void PutSigned(std::vector<uint8_t>& out, int32_t value)
+            {
+                PutVarint(out, (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+            }
+
+            void PutString(std::vector<uint8_t>& out, const std::string& value)
+            {
+                PutVarint(out, static_cast<uint32_t>(value.size()));
+                out.insert(out.end(), value.begin(), value.end());
+            }
+
+            template <typename T>
+            bool Get(const uint8_t*& cursor, const uint8_t* end, T& value)
+            {
+                if (static_cast<std::size_t>(end - cursor) < sizeof(T))
+                    return false;
+                std::memcpy(&value, cursor, sizeof(T));
+                cursor += sizeof(T);
+                return true;
+            }
+
+            bool GetVarint(const uint8_t*& cursor, const uint8_t* end, uint32_t& value)
+            {
+                value = 0;
+                for (uint32_t shift = 0; shift < 35 && cursor != end; shift += 7)
+                {
+                    uint8_t byte = *cursor++;
+                    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0)
+                        return true;
+                }
+                return false;
+            }
+
+            bool GetSigned(const uint8_t*& cursor, const uint8_t* end, int32_t& value)
+            {
+                uint32_t zigzag;
+                if (!GetVarint(cursor, end, zigzag))
+                    return false;
+                value = static_cast<int32_t>((zigzag >> 1) ^ (0u - (zigzag & 1)));
+                return true;
+            }
+
+            // Reads a count of records that each take at least one byte.
+            bool GetCount(const uint8_t*& cursor, const uint8_t* end, uint32_t& count)
+            {
+                return GetVarint(cursor, end, count) && count <= static_cast<std::size_t>(end - cursor);
+            }
+
+            bool GetBytes(const uint8_t*& cursor, const uint8_t* end, uint32_t length, const uint8_t*& bytes)
+            {
+                if (static_cast<std::size_t>(end - cursor) < length)
+                    return false;
+                bytes = cursor;
+                cursor += length;
+                return true;
+            }
+
+            bool GetString(const uint8_t*& cursor, const uint8_t* end, std::string& value)
+            {
+                uint32_t length;
+                const uint8_t* bytes;
+                if (!GetVarint(cursor, end, length) || !GetBytes(cursor, end, length, bytes))
+                    return false;
+                value.assign(reinterpret_cast<const char*>(bytes), length);
+                return true;
+            }
+
+            bool GetObjectId(const uint8_t*& cursor, const uint8_t* end, ObjectId& id)
+            {
+                return GetVarint(cursor, end, id) && id < MaxObjectId;
+            }
+
+            // Maps each ObjectId in ids to its index, UINT32_MAX where absent.
+            void BuildIndex(const std::vector<ObjectId>& ids, std::vector<uint32_t>& index)
+            {
+                index.clear();
+                for (std::size_t i = 0; i < ids.size(); i++)
+                {
+                    if (ids[i] >= index.size())
+                        index.resize(ids[i] + 1, UINT32_MAX);
+                    index[ids[i]] = static_cast<uint32_t>(i);
+                }
+            }
+
+            uint32_t Find(const std::vector<uint32_t>& index, ObjectId id)
+            {
+                return (id < index.size()) ? index[id] : UINT32_MAX;
+            }
+
+            // Index of the first Component of each GameObject.
+            void FirstComponents(const SceneState& state, std::vector<uint32_t>& first)
+            {
+                first.resize(state.ObjectCount());
+                uint32_t total = 0;
+                for (std::size_t i = 0; i < first.size(); i++)
+                {
+                    first[i] = total;
+                    total += state.componentCounts[i];
+                }
+            }
+
+            ObjectId ParentId(const SceneState& state, std::size_t index)
+            {
+                return (state.parents[index] != UINT32_MAX) ? state.ids[state.parents[index]] : InvalidObjectId;
+            }
+
+            // Maps each type of from to the type with the same name and layout in to, UINT32_MAX where absent.
+            void RemapTypes(const SceneState& from, const SceneState& to, std::vector<uint32_t>& remap)
+            {
+                remap.assign(from.typeNames.size(), UINT32_MAX);
+                for (std::size_t i = 0; i < from.typeNames.size(); i++)
+                {
+                    for (std::size_t j = 0; j < to.typeNames.size(); j++)
+                    {
+                        if (from.layoutHashes[i] == to.layoutHashes[j] && from.typeNames[i] == to.typeNames[j])
+                        {
+                            remap[i] = static_cast<uint32_t>(j);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            void PutComponents(std::vector<uint8_t>& out, const SceneState& state, uint32_t first, uint32_t count)
+            {
+                PutVarint(out, count);
+                for (uint32_t c = first; c < first + count; c++)
+                {
+                    uint32_t begin = state.componentOffsets[c];
+                    uint32_t end = state.componentOffsets[c + 1];
+
+                    PutVarint(out, state.componentTypes[c]);
+                    out.push_back(state.componentEnabled[c]);
+                    PutVarint(out, end - begin);
+                    out.insert(out.end(), state.componentData.begin() + begin, state.componentData.begin() + end);
+                }
+            }
+
+            void AppendComponent(SceneState& state, uint32_t type, uint8_t enabled, const uint8_t* data, uint32_t size)
+            {
+                state.componentTypes.push_back(type);
+                state.componentEnabled.push_back(enabled);
+                state.componentOffsets.push_back(static_cast<uint32_t>(state.componentData.size()));
+                state.componentData.insert(state.componentData.end(), data, data + size);
+            }
+
+            // Reads a Component list written by PutComponents, appending it to result if it is not null.
+            bool GetComponents(const uint8_t*& cursor, const uint8_t* end, std::size_t typeCount, SceneState* result, uint32_t& count)
+            {
+                if (!GetCount(cursor, end, count))
+                    return false;
+
+                for (uint32_t c = 0; c < count; c++)
+                {
+                    uint32_t type, size;
+                    uint8_t enabled;
+                    const uint8_t* data;
+                    if (!GetVarint(cursor, end, type) || type >= typeCount || !Get(cursor, end, enabled) ||
+                        !GetVarint(cursor, end, size) || !GetBytes(cursor, end, size, data))
+                        return false;
+
+                    if (result != nullptr)
+                        AppendComponent(*result, type, enabled, data, size);
+                }
+                return true;
+            }
+
+            // Reads the patches to the Components of a baseline GameObject, appending all of them to result
+            // if it is not null. With no patches to read, copies the Components unchanged.
+            bool GetPatchedComponents(const uint8_t*& cursor, const uint8_t* end, bool patched, const SceneState& base,
+                                      uint32_t first, uint32_t count, const std::vector<uint32_t>& remap, SceneState* result)
+            {
+                uint32_t patch_count = 0;
+                if (patched && (!GetVarint(cursor, end, patch_count) || patch_count > count))
+                    return false;
+
+                uint32_t c = 0;
+                for (uint32_t p = 0; p <= patch_count; p++)
+                {
+                    // Each patch starts with the number of unchanged Components preceding it.
+                    uint32_t stop = count;
+                    if (p < patch_count)
+                    {
+                        uint32_t skip;
+                        if (!GetVarint(cursor, end, skip) || skip >= count - c)
+                            return false;
+                        stop = c + skip;
+                    }
+
+                    for (; c < stop; c++)
+                    {
+                        uint32_t source = first + c;
+                        uint32_t type = remap[base.componentTypes[source]];
+                        if (type == UINT32_MAX)
+                            return false;
+
+                        if (result != nullptr)
+                        {
+                            AppendComponent(*result, type, base.componentEnabled[source], base.componentData.data() + base.componentOffsets[source],
+                                            base.componentOffsets[source + 1] - base.componentOffsets[source]);
+                        }
+                    }
+
+                    if (p == patch_count)
+                        break;
+
+                    uint32_t source = first + c;
+                    uint32_t type = remap[base.componentTypes[source]];
+                    uint32_t base_size = base.componentOffsets[source + 1] - base.componentOffsets[source];
+
+                    uint8_t enabled;
+                    uint32_t size, run_count;
+                    if (type == UINT32_MAX || !Get(cursor, end, enabled) || !GetVarint(cursor, end, size) ||
+                        size > base_size + static_cast<std::size_t>(end - cursor) || !GetCount(cursor, end, run_count))
+                        return false;
+
+                    std::size_t start = 0;
+                    if (result != nullptr)
+                    {
+                        start = result->componentData.size();
+                        AppendComponent(*result, type, enabled, base.componentData.data() + base.componentOffsets[source], std::min(base_size, size));
+                        result->componentData.resize(start + size, 0);
+                    }
+
+                    uint32_t position = 0;
+                    for (uint32_t r = 0; r < run_count; r++)
+                    {
+                        uint32_t offset, length;
+                        const uint8_t* bytes;
+                        if (!GetVarint(cursor, end, offset) || offset > size - position)
+                            return false;
+                        position += offset;
+
+                        if (!GetVarint(cursor, end, length) || length > size - position || !GetBytes(cursor, end, length, bytes))
+                            return false;
+
+                        if (result != nullptr && length != 0)
+                            std::memcpy(&result->componentData[start + position], bytes, length);
+                        position += length;
+                    }
+
+                    c++;
+                }
+                return true;
+            }
+
+            // Appends the [begin, end) ranges of the bytes that differ between a and b.
+            void DiffRuns(const uint8_t* a, const uint8_t* b, uint32_t size, std::vector<uint32_t>& runs)
+            {
+                runs.clear();
+                uint32_t i = 0;
+                while (i < size)
+                {
+                    if (a[i] == b[i])
+                    {
+                        i++;
+                        continue;
+                    }
+
+                    uint32_t start = i;
+                    uint32_t last = i;
+                    for (i = i + 1; i < size && i - last <= RunGap; i++)
+                    {
+                        if (a[i] != b[i])
+                            last = i;
+                    }
+
+                    runs.push_back(start);
+                    runs.push_back(last + 1);
+                    i = last + 1;
+                }
+            }
+
+            struct Created
+            {
+                ObjectId        id;
+                Core::Guid      guid;
+                Core::Guid      prefab;
+                std::string     name;
+                ObjectId        parent;
+                uint8_t         flags;
+                float           transform[9];
+                const uint8_t*  components; /**< Component list in the delta, already validated. */
+            };
+
+            struct Change
+            {
+                uint8_t         mask;
+                ObjectId        parent;
+                uint8_t         flags;
+                std::string     name;
+                uint32_t        channels;
+                int32_t         steps[9];
+                const uint8_t*  components; /**< Component patches or list in the delta, already validated. */
+            };
+        }
+
+        void SceneDelta::Encode(SceneState& baseline, const SceneState& next, std::vector<uint8_t>& out)
+        {
+            out.clear();
+
+            std::size_t base_count = baseline.ObjectCount();
+            std::size_t next_count = next.ObjectCount();
+
+            std::vector<uint32_t> base_index, base_first, next_first, type_remap;
+            BuildIndex(baseline.ids, base_index);
+            FirstComponents(baseline, base_first);
+            FirstComponents(next, next_first);
+            RemapTypes(baseline, next, type_remap);
+
+            bool types_changed = baseline.typeNames != next.typeNames || baseline.layoutHashes != next.layoutHashes;
+
+            // Match GameObjects by id. An id whose Guid changed belongs to another GameObject.
+            std::vector<uint32_t> matched(next_count, UINT32_MAX);
+            std::vector<bool> survives(base_count, false);
+            std::size_t survivor_count = 0;
+            for (std::size_t i = 0; i < next_count; i++)
+            {
+                uint32_t b = Find(base_index, next.ids[i]);
+                if (b != UINT32_MAX && baseline.guids[b] == next.guids[i])
+                {
+                    matched[i] = b;
+                    survives[b] = true;
+                    survivor_count++;
+                }
+            }
+
+            // Apply assumes survivors keep their order and created GameObjects follow them.
+            std::vector<ObjectId> order;
+            order.reserve(next_count);
+            for (std::size_t b = 0; b < base_count; b++)
+            {
+                if (survives[b])
+                    order.push_back(baseline.ids[b]);
+            }
+            for (std::size_t i = 0; i < next_count; i++)
+            {
+                if (matched[i] == UINT32_MAX)
+                    order.push_back(next.ids[i]);
+            }
+            bool reordered = order != next.ids;
+
+            Put(out, DeltaMagic);
+            PutVarint(out, static_cast<uint32_t>(base_count));
+            PutVarint(out, static_cast<uint32_t>(baseline.ComponentCount()));
+            out.push_back(static_cast<uint8_t>((types_changed ? DeltaTypes : 0) | (reordered ? DeltaOrder : 0)));
+
+            if (types_changed)
+            {
+                PutVarint(out, static_cast<uint32_t>(next.typeNames.size()));
+                for (std::size_t t = 0; t < next.typeNames.size(); t++)
+                {
+                    PutString(out, next.typeNames[t]);
+                    Put(out, next.layoutHashes[t]);
+                }
+            }
+
+            PutVarint(out, static_cast<uint32_t>(base_count - survivor_count));
+            for (std::size_t b = 0; b < base_count; b++)
+            {
+                if (!survives[b])
+                    PutVarint(out, baseline.ids[b]);
+            }
+
+            // The transforms the receiver ends up with.
+            std::vector<float> transforms(next.transforms.size());
+
+            PutVarint(out, static_cast<uint32_t>(next_count - survivor_count));
+            for (std::size_t i = 0; i < next_count; i++)
+            {
+                if (matched[i] != UINT32_MAX)
+                    continue;
+
+                ObjectId parent = ParentId(next, i);
+                PutVarint(out, next.ids[i]);
+                Put(out, next.guids[i]);
+                Put(out, next.prefabs[i]);
+                PutString(out, next.names[i]);
+                PutVarint(out, (parent != InvalidObjectId) ? parent + 1 : 0);
+                out.push_back(next.flags[i]);
+
+                for (int channel = 0; channel < 9; channel++)
+                {
+                    int32_t steps = Quantize(next.transforms[i * 9 + channel], channel);
+                    PutSigned(out, steps);
+                    transforms[i * 9 + channel] = Dequantize(steps, channel);
+                }
+
+                PutComponents(out, next, next_first[i], next.componentCounts[i]);
+            }
+
+            // Changed GameObjects go to their own buffer until they are counted.
+            std::vector<uint8_t> changes;
+            std::vector<uint32_t> patched, runs;
+            uint32_t change_count = 0;
+            for (std::size_t i = 0; i < next_count; i++)
+            {
+                uint32_t b = matched[i];
+                if (b == UINT32_MAX)
+                    continue;
+
+                uint8_t mask = 0;
+                if (ParentId(baseline, b) != ParentId(next, i))
+                    mask |= ChangedParent;
+                if (baseline.flags[b] != next.flags[i])
+                    mask |= ChangedFlags;
+                if (baseline.names[b] != next.names[i])
+                    mask |= ChangedName;
+
+                int32_t steps[9];
+                uint32_t channels = 0;
+                for (int channel = 0; channel < 9; channel++)
+                {
+                    steps[channel] = Quantize(next.transforms[i * 9 + channel], channel);
+                    int32_t base_steps = Quantize(baseline.transforms[b * 9 + channel], channel);
+                    if (steps[channel] != base_steps)
+                    {
+                        channels |= 1u << channel;
+                        transforms[i * 9 + channel] = Dequantize(steps[channel], channel);
+                        steps[channel] -= base_steps;
+                    }
+                    else
+                        transforms[i * 9 + channel] = baseline.transforms[b * 9 + channel];
+                }
+                if (channels != 0)
+                    mask |= ChangedTransform;
+
+                // Components are patched in place as long as the same types are present in the same order.
+                uint32_t count = next.componentCounts[i];
+                bool replaced = baseline.componentCounts[b] != count;
+                patched.clear();
+                for (uint32_t c = 0; c < count && !replaced; c++)
+                {
+                    uint32_t base_c = base_first[b] + c;
+                    uint32_t next_c = next_first[i] + c;
+                    if (type_remap[baseline.componentTypes[base_c]] != next.componentTypes[next_c])
+                    {
+                        replaced = true;
+                        break;
+                    }
+
+                    uint32_t base_size = baseline.componentOffsets[base_c + 1] - baseline.componentOffsets[base_c];
+                    uint32_t next_size = next.componentOffsets[next_c + 1] - next.componentOffsets[next_c];
+                    if (baseline.componentEnabled[base_c] != next.componentEnabled[next_c] || base_size != next_size ||
+                        std::memcmp(baseline.componentData.data() + baseline.componentOffsets[base_c],
+                                    next.componentData.data() + next.componentOffsets[next_c], next_size) != 0)
+                        patched.push_back(c);
+                }
+                if (replaced)
+                    mask |= ReplacedComponents;
+                else if (!patched.empty())
+                    mask |= PatchedComponents;
+
+                if (mask == 0)
+                    continue;
+
+                change_count++;
+                PutVarint(changes, next.ids[i]);
+                changes.push_back(mask);
+
+                if (mask & ChangedParent)
+                {
+                    ObjectId parent = ParentId(next, i);
+                    PutVarint(changes, (parent != InvalidObjectId) ? parent + 1 : 0);
+                }
+                if (mask & ChangedFlags)
+                    changes.push_back(next.flags[i]);
+                if (mask & ChangedName)
+                    PutString(changes, next.names[i]);
+
+                if (mask & ChangedTransform)
+                {
+                    PutVarint(changes, channels);
+                    for (int channel = 0; channel < 9; channel++)
+                    {
+                        if (channels & (1u << channel))
+                            PutSigned(changes, steps[channel]);
+                    }
+                }
+
+                if (mask & ReplacedComponents)
+                    PutComponents(changes, next, next_first[i], count);
+                else if (mask & PatchedComponents)
+                {
+                    PutVarint(changes, static_cast<uint32_t>(patched.size()));
+                    uint32_t previous = 0;
+                    for (uint32_t c : patched)
+                    {
+                        uint32_t base_c = base_first[b] + c;
+                        uint32_t next_c = next_first[i] + c;
+                        const uint8_t* base_data = baseline.componentData.data() + baseline.componentOffsets[base_c];
+                        const uint8_t* next_data = next.componentData.data() + next.componentOffsets[next_c];
+                        uint32_t base_size = baseline.componentOffsets[base_c + 1] - baseline.componentOffsets[base_c];
+                        uint32_t next_size = next.componentOffsets[next_c + 1] - next.componentOffsets[next_c];
+
+                        PutVarint(changes, c - previous);
+                        previous = c + 1;
+                        changes.push_back(next.componentEnabled[next_c]);
+                        PutVarint(changes, next_size);
+
+                        // A resized state is resent whole.
+                        if (base_size == next_size)
+                            DiffRuns(base_data, next_data, next_size, runs);
+                        else
+                            runs.assign({ 0, next_size });
+
+                        PutVarint(changes, static_cast<uint32_t>(runs.size() / 2));
+                        uint32_t position = 0;
+                        for (std::size_t r = 0; r < runs.size(); r += 2)
+                        {
+                            PutVarint(changes, runs[r] - position);
+                            PutVarint(changes, runs[r + 1] - runs[r]);
+                            changes.insert(changes.end(), next_data + runs[r], next_data + runs[r + 1]);
+                            position = runs[r + 1];
+                        }
+                    }
+                }
+            }
+
+            PutVarint(out, change_count);
+            out.insert(out.end(), changes.begin(), changes.end());
+
+            if (reordered)
+            {
+                PutVarint(out, static_cast<uint32_t>(next_count));
+                for (ObjectId id : next.ids)
+                    PutVarint(out, id);
+            }
+
+            baseline = next;
+            baseline.transforms.swap(transforms);
+        }
+
+        bool SceneDelta::Apply(SceneState& state, const std::vector<uint8_t>& data)
+        {
+            return Apply(state, data.data(), data.size());
+        }
+
+        bool SceneDelta::Apply(SceneState& state, const uint8_t* data, std::size_t size)
+        {
+            const uint8_t* cursor = data;
+            const uint8_t* end = data + size;
+
+            uint32_t magic, base_count, base_component_count;
+            uint8_t flags;
+            if (!Get(cursor, end, magic) || magic != DeltaMagic)
+            {
+                HT_DEBUG_PRINTF("SceneDelta::Apply: Not a scene delta!\n");
+                return false;
+            }
+
+            if (!GetVarint(cursor, end, base_count) || !GetVarint(cursor, end, base_component_count) || !Get(cursor, end, flags))
+                return false;
+
+            if (!state.IsValid() || base_count != state.ObjectCount() || base_component_count != state.ComponentCount())
+            {
+                HT_DEBUG_PRINTF("SceneDelta::Apply: The delta was not encoded against this state!\n");
+                return false;
+            }
+
+            SceneState result;
+            if (flags & DeltaTypes)
+            {
+                uint32_t type_count;
+                if (!GetCount(cursor, end, type_count))
+                    return false;
+
+                result.typeNames.resize(type_count);
+                result.layoutHashes.resize(type_count);
+                for (uint32_t t = 0; t < type_count; t++)
+                {
+                    if (!GetString(cursor, end, result.typeNames[t]) || !Get(cursor, end, result.layoutHashes[t]))
+                        return false;
+                }
+            }
+            else
+            {
+                result.typeNames = state.typeNames;
+                result.layoutHashes = state.layoutHashes;
+            }
+
+            std::vector<uint32_t> base_index, base_first, type_remap;
+            BuildIndex(state.ids, base_index);
+            FirstComponents(state, base_first);
+            RemapTypes(state, result, type_remap);
+
+            // Destroyed GameObjects.
+            uint32_t destroyed_count;
+            if (!GetCount(cursor, end, destroyed_count) || destroyed_count > base_count)
+                return false;
+
+            std::vector<bool> survives(base_count, true);
+            for (uint32_t d = 0; d < destroyed_count; d++)
+            {
+                ObjectId id;
+                if (!GetObjectId(cursor, end, id))
+                    return false;
+
+                uint32_t b = Find(base_index, id);
+                if (b == UINT32_MAX || !survives[b])
+                    return false;
+                survives[b] = false;
+            }
+
+            // Created GameObjects.
+            uint32_t created_count;
+            if (!GetCount(cursor, end, created_count))
+                return false;
+
+            std::vector<Created> created(created_count);
+            std::vector<uint32_t> created_index;
+            for (uint32_t n = 0; n < created_count; n++)
+            {
+                Created& record = created[n];
+                uint32_t parent, component_count;
+                if (!GetObjectId(cursor, end, record.id) || !Get(cursor, end, record.guid) || !Get(cursor, end, record.prefab) ||
+                    !GetString(cursor, end, record.name) || !GetVarint(cursor, end, parent) || parent > MaxObjectId || !Get(cursor, end, record.flags))
+                    return false;
+                record.parent = (parent != 0) ? parent - 1 : InvalidObjectId;
+
+                for (int channel = 0; channel < 9; channel++)
+                {
+                    int32_t steps;
+                    if (!GetSigned(cursor, end, steps))
+                        return false;
+                    record.transform[channel] = Dequantize(steps, channel);
+                }
+
+                record.components = cursor;
+                if (!GetComponents(cursor, end, result.typeNames.size(), nullptr, component_count))
+                    return false;
+
+                // An id may only be reused once its previous GameObject is destroyed.
+                uint32_t b = Find(base_index, record.id);
+                if ((b != UINT32_MAX && survives[b]) || Find(created_index, record.id) != UINT32_MAX)
+                    return false;
+                if (record.id >= created_index.size())
+                    created_index.resize(record.id + 1, UINT32_MAX);
+                created_index[record.id] = n;
+            }
+
+            // Changed GameObjects.
+            uint32_t change_count;
+            if (!GetCount(cursor, end, change_count))
+                return false;
+
+            std::vector<Change> changes(change_count);
+            std::vector<uint32_t> change_index(base_count, UINT32_MAX);
+            for (uint32_t n = 0; n < change_count; n++)
+            {
+                Change& change = changes[n];
+                ObjectId id;
+                if (!GetObjectId(cursor, end, id) || !Get(cursor, end, change.mask))
+                    return false;
+
+                uint32_t b = Find(base_index, id);
+                if (b == UINT32_MAX || !survives[b] || change_index[b] != UINT32_MAX)
+                    return false;
+                change_index[b] = n;
+
+                if (change.mask & ChangedParent)
+                {
+                    uint32_t parent;
+                    if (!GetVarint(cursor, end, parent) || parent > MaxObjectId)
+                        return false;
+                    change.parent = (parent != 0) ? parent - 1 : InvalidObjectId;
+                }
+                if ((change.mask & ChangedFlags) && !Get(cursor, end, change.flags))
+                    return false;
+                if ((change.mask & ChangedName) && !GetString(cursor, end, change.name))
+                    return false;
+
+                change.channels = 0;
+                if (change.mask & ChangedTransform)
+                {
+                    if (!GetVarint(cursor, end, change.channels) || change.channels >= (1u << 9))
+                        return false;
+                    for (int channel = 0; channel < 9; channel++)
+                    {
+                        if ((change.channels & (1u << channel)) && !GetSigned(cursor, end, change.steps[channel]))
+                            return false;
+                    }
+                }
+
+                change.components = cursor;
+                uint32_t component_count;
+                if (change.mask & ReplacedComponents)
+                {
+                    if (!GetComponents(cursor, end, result.typeNames.size(), nullptr, component_count))
+                        return false;
+                }
+                else if (!GetPatchedComponents(cursor, end, (change.mask & PatchedComponents) != 0, state, base_first[b],
+                                               state.componentCounts[b], type_remap, nullptr))
+                    return false;
+            }
+
+            // Order of the resulting GameObjects.
+            std::size_t survivor_count = base_count - destroyed_count;
+            if (flags & DeltaOrder)
+            {
+                uint32_t count;
+                if (!GetCount(cursor, end, count) || count != survivor_count + created_count)
+                    return false;
+
+                result.ids.resize(count);
+                for (ObjectId& id : result.ids)
+                {
+                    if (!GetObjectId(cursor, end, id))
+                        return false;
+                }
+            }
+            else
+            {
+                result.ids.reserve(survivor_count + created_count);
+                for (uint32_t b = 0; b < base_count; b++)
+                {
+                    if (survives[b])
+                        result.ids.push_back(state.ids[b]);
+                }
+                for (const Created& record : created)
+                    result.ids.push_back(record.id);
+            }
+
+            if (cursor != end)
+                return false;
+
+            // Build the new state in order.
+            std::size_t object_count = result.ids.size();
+            std::vector<uint32_t> result_index;
+            BuildIndex(result.ids, result_index);
+
+            result.guids.resize(object_count);
+            result.prefabs.resize(object_count);
+            result.names.resize(object_count);
+            result.parents.resize(object_count);
+            result.flags.resize(object_count);
+            result.transforms.resize(object_count * 9);
+            result.componentCounts.resize(object_count);
+
+            std::vector<bool> placed(base_count + created_count, false);
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                ObjectId id = result.ids[i];
+                ObjectId parent;
+                uint32_t component_count;
+
+                uint32_t n = Find(created_index, id);
+                if (n != UINT32_MAX)
+                {
+                    const Created& record = created[n];
+                    if (placed[base_count + n])
+                        return false;
+                    placed[base_count + n] = true;
+
+                    result.guids[i] = record.guid;
+                    result.prefabs[i] = record.prefab;
+                    result.names[i] = record.name;
+                    result.flags[i] = record.flags;
+                    parent = record.parent;
+                    std::memcpy(&result.transforms[i * 9], record.transform, sizeof(record.transform));
+
+                    const uint8_t* components = record.components;
+                    GetComponents(components, end, result.typeNames.size(), &result, component_count);
+                }
+                else
+                {
+                    uint32_t b = Find(base_index, id);
+                    if (b == UINT32_MAX || !survives[b] || placed[b])
+                        return false;
+                    placed[b] = true;
+
+                    const Change* change = (change_index[b] != UINT32_MAX) ? &changes[change_index[b]] : nullptr;
+                    uint8_t mask = (change != nullptr) ? change->mask : 0;
+
+                    result.guids[i] = state.guids[b];
+                    result.prefabs[i] = state.prefabs[b];
+                    result.names[i] = (mask & ChangedName) ? change->name : state.names[b];
+                    result.flags[i] = (mask & ChangedFlags) ? change->flags : state.flags[b];
+                    parent = (mask & ChangedParent) ? change->parent : ParentId(state, b);
+
+                    for (int channel = 0; channel < 9; channel++)
+                    {
+                        float value = state.transforms[b * 9 + channel];
+                        if ((mask & ChangedTransform) && (change->channels & (1u << channel)))
+                            value = Dequantize(Quantize(value, channel) + change->steps[channel], channel);
+                        result.transforms[i * 9 + channel] = value;
+                    }
+
+                    const uint8_t* components = (change != nullptr) ? change->components : end;
+                    component_count = state.componentCounts[b];
+                    if (mask & ReplacedComponents)
+                        GetComponents(components, end, result.typeNames.size(), &result, component_count);
+                    else
+                        GetPatchedComponents(components, end, (mask & PatchedComponents) != 0, state, base_first[b], component_count, type_remap, &result);
+                }
+
+                result.componentCounts[i] = component_count;
+
+                if (parent == InvalidObjectId)
+                    result.parents[i] = UINT32_MAX;
+                else if ((result.parents[i] = Find(result_index, parent)) == UINT32_MAX)
+                    return false;
+            }
+            result.componentOffsets.push_back(static_cast<uint32_t>(result.componentData.size()));
+
+            if (!result.IsValid())
+            {
+                HT_DEBUG_PRINTF("SceneDelta::Apply: The delta produces a malformed scene state!\n");
+                return false;
+            }
+
+            state = std::move(result);
+            return true;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_scene_file_watcher.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        bool SceneFileWatcher::Stamp::operator==(const Stamp& other) const
+        {
+            return modified == other.modified && size == other.size;
+        }
+
+        SceneFileWatcher::SceneFileWatcher(void)
+            : m_modified{ 0, 0 }, m_reported{ 0, 0 }, m_interval(std::chrono::milliseconds(250)), m_nextCheck()
+        {
+        }
+
+        void SceneFileWatcher::Watch(const std::string& path)
+        {
+            m_path = path;
+            m_modified = Stamp{ 0, 0 };
+            ReadStamp(m_path, m_modified);
+            m_reported = m_modified;
+            m_nextCheck = Clock::now() + m_interval;
+        }
+
+        void SceneFileWatcher::Clear(void)
+        {
+            m_path.clear();
+            m_modified = Stamp{ 0, 0 };
+            m_reported = m_modified;
+        }
+
+        bool SceneFileWatcher::Poll(void)
+        {
+            if (m_path.empty())
+                return false;
+
+            Clock::time_point now = Clock::now();
+            if (now < m_nextCheck)
+                return false;
+            m_nextCheck = now + m_interval;
+
+            Stamp stamp;
+            if (!ReadStamp(m_path, stamp) || stamp == m_modified)
+                return false;
+
+            m_reported = stamp;
+            return true;
+        }
+
+        void SceneFileWatcher::Acknowledge(void)
+        {
+            m_modified = m_reported;
+        }
+
+        void SceneFileWatcher::SetInterval(uint32_t milliseconds)
+        {
+            m_interval = std::chrono::milliseconds(milliseconds);
+        }
+
+        const std::string& SceneFileWatcher::GetPath(void) const
+        {
+            return m_path;
+        }
+
+        bool SceneFileWatcher::ReadStamp(const std::string& path, Stamp& out)
+        {
+            struct stat info;
+            if (stat(path.c_str(), &info) != 0)
+                return false;
+
+            //Several saves within a second only differ below the second
+#if defined(HT_SYS_LINUX)
+            out.modified = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+            out.modified = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+            out.modified = static_cast<int64_t>(info.st_mtime) * 1000000000;
+#endif
+            out.size = static_cast<int64_t>(info.st_size);
+            return true;
+        }
+    }
+}
@@ -0,0 +1,267 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_scene_hasher.h>
+#include <ht_scene.h>
+#include <ht_gameobject.h>
+#include <ht_component_registry.h>
+#include <ht_state_hash.h>
+#include <ht_debug.h>
+
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+
+            const uint32_t HashesMagic = 0x48535448; // "HTSH"
+
+            const uint8_t FlagEnabled       = 1 << 0;
+            const uint8_t FlagInitialized   = 1 << 1;
+
+            // Largest ObjectId Read() accepts, so corrupt hashes cannot make it allocate without bound.
+            const ObjectId MaxObjectId = 1 << 24;
+
+            template <typename T>
+            void Put(std::vector<uint8_t>& out, const T& value)
+            {
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                out.insert(out.end(), bytes, bytes + sizeof(T));
+            }
+
+            template <typename T>
+            bool GetColumn(const uint8_t*& cursor, const uint8_t* end, std::size_t count, std::vector<T>& column)
+            {
+                if (count > static_cast<std::size_t>(end - cursor) / sizeof(T))
+                    return false;
+                column.resize(count);
+                if (count != 0)
+                    std::memcpy(column.data(), cursor, count * sizeof(T));
+                cursor += count * sizeof(T);
+                return true;
+            }
+        }
+
+        SceneHasher::SceneHasher(void)
+            : m_sceneHash(0)
+        {
+        }
+
+        uint64_t SceneHasher::Update(const Scene& scene)
+        {
+            scene.CollectLiveGameObjects(m_objects, m_parents, m_visited);
+
+            std::size_t count = m_objects.size();
+            m_ids.resize(count);
+            m_objectHashes.resize(count);
+            m_subtreeHashes.resize(count);
+
+            for (std::size_t i = 0; i < count; i++)
+            {
+                const GameObject* gameObject = m_objects[i];
+                m_ids[i] = gameObject->m_id;
+
+                StateHash hash(gameObject->m_id);
+                hash.Add((m_parents[i] != UINT32_MAX) ? m_objects[m_parents[i]]->m_id : InvalidObjectId);
+                hash.Add(static_cast<uint8_t>((gameObject->m_enabled ? FlagEnabled : 0) | (gameObject->m_initialized ? FlagInitialized : 0)));
+
+                const Transform& transform = gameObject->m_transform;
+                const float values[9] = {
+                    transform.X(), transform.Y(), transform.Z(),
+                    transform.RotX(), transform.RotY(), transform.RotZ(),
+                    transform.ScaleX(), transform.ScaleY(), transform.ScaleZ()
+                };
+                hash.Add(values);
+
+                for (Component* component : gameObject->m_components)
+                {
+                    if (component == nullptr)
+                        continue;
+
+                    // ComponentTypeIds are assigned at runtime; the hash of the type name is the same everywhere.
+                    const ComponentRegistry::Entry* entry = ComponentRegistry::Find(component->VGetComponentTypeId());
+                    if (entry == nullptr || (entry->flags & ComponentRegistry::NO_ROLLBACK))
+                        continue;
+
+                    hash.Add(entry->hash);
+                    hash.Add(static_cast<uint8_t>(component->GetEnabled() ? 1 : 0));
+
+                    const TypeDescriptor* descriptor = component->VGetTypeDescriptor();
+                    if (descriptor != nullptr)
+                        descriptor->HashState(component, hash);
+                }
+
+                m_objectHashes[i] = hash.Get();
+                m_subtreeHashes[i] = m_objectHashes[i];
+            }
+
+            // Descendants follow their ancestors, so walking backwards folds every subtree
+            // into its parent after it is complete. Siblings are folded last to first.
+            m_sceneHash = StateHash::Combine(0, count);
+            for (std::size_t i = count; i-- > 0; )
+            {
+                if (m_parents[i] != UINT32_MAX)
+                    m_subtreeHashes[m_parents[i]] = StateHash::Combine(m_subtreeHashes[m_parents[i]], m_subtreeHashes[i]);
+                else
+                    m_sceneHash = StateHash::Combine(m_sceneHash, m_subtreeHashes[i]);
+            }
+
+            BuildIndex();
+
+            return m_sceneHash;
+        }
+
+        uint64_t SceneHasher::GetSceneHash(void) const
+        {
+            return m_sceneHash;
+        }
+
+        std::size_t SceneHasher::GetObjectCount(void) const
+        {
+            return m_ids.size();
+        }
+
+        uint64_t SceneHasher::GetObjectHash(ObjectId id) const
+        {
+            uint32_t index = IndexOf(id);
+            return (index != UINT32_MAX) ? m_objectHashes[index] : 0;
+        }
+
+        uint64_t SceneHasher::GetSubtreeHash(ObjectId id) const
+        {
+            uint32_t index = IndexOf(id);
+            return (index != UINT32_MAX) ? m_subtreeHashes[index] : 0;
+        }
+
+        std::size_t SceneHasher::FindMismatches(const SceneHasher& other, std::vector<ObjectId>& out) const
+        {
+            out.clear();
+            if (m_sceneHash == other.m_sceneHash && m_ids.size() == other.m_ids.size())
+                return 0;
+
+            // A settled GameObject needs no further look, and neither do its descendants.
+            std::vector<bool> settled(m_ids.size(), false);
+            for (std::size_t i = 0; i < m_ids.size(); i++)
+            {
+                if (m_parents[i] != UINT32_MAX && settled[m_parents[i]])
+                {
+                    settled[i] = true;
+                    continue;
+                }
+
+                uint32_t match = other.IndexOf(m_ids[i]);
+                if (match == UINT32_MAX)
+                {
+                    out.push_back(m_ids[i]);
+                    settled[i] = true;
+                }
+                else if (m_subtreeHashes[i] == other.m_subtreeHashes[match])
+                    settled[i] = true;
+                else if (m_objectHashes[i] != other.m_objectHashes[match])
+                    out.push_back(m_ids[i]);
+            }
+
+            // GameObjects only the other run has, reported at the top of each missing subtree.
+            for (std::size_t i = 0; i < other.m_ids.size(); i++)
+            {
+                uint32_t parent = other.m_parents[i];
+                if (IndexOf(other.m_ids[i]) == UINT32_MAX && (parent == UINT32_MAX || IndexOf(other.m_ids[parent]) != UINT32_MAX))
+                    out.push_back(other.m_ids[i]);
+            }
+
+            return out.size();
+        }
+
+        void SceneHasher::Write(std::vector<uint8_t>& out) const
+        {
+            out.clear();
+            Put(out, HashesMagic);
+            Put(out, static_cast<uint32_t>(m_ids.size()));
+            Put(out, m_sceneHash);
+
+            const uint8_t* ids = reinterpret_cast<const uint8_t*>(m_ids.data());
+            out.insert(out.end(), ids, ids + m_ids.size() * sizeof(ObjectId));
+            const uint8_t* parents = reinterpret_cast<const uint8_t*>(m_parents.data());
+            out.insert(out.end(), parents, parents + m_parents.size() * sizeof(uint32_t));
+            const uint8_t* objects = reinterpret_cast<const uint8_t*>(m_objectHashes.data());
+            out.insert(out.end(), objects, objects + m_objectHashes.size() * sizeof(uint64_t));
+            const uint8_t* subtrees = reinterpret_cast<const uint8_t*>(m_subtreeHashes.data());
+            out.insert(out.end(), subtrees, subtrees + m_subtreeHashes.size() * sizeof(uint64_t));
+        }
+
+        bool SceneHasher::Read(const uint8_t* data, std::size_t size)
+        {
+            const uint8_t* cursor = data;
+            const uint8_t* end = data + size;
+
+            m_objects.clear();
+            m_ids.clear();
+            m_parents.clear();
+            m_objectHashes.clear();
+            m_subtreeHashes.clear();
+            m_index.clear();
+            m_sceneHash = 0;
+
+            uint32_t magic, count;
+            uint64_t scene_hash;
+            if (size < sizeof(magic) + sizeof(count) + sizeof(scene_hash))
+                return false;
+
+            std::memcpy(&magic, cursor, sizeof(magic));
+            std::memcpy(&count, cursor + sizeof(magic), sizeof(count));
+            std::memcpy(&scene_hash, cursor + sizeof(magic) + sizeof(count), sizeof(scene_hash));
+            cursor += sizeof(magic) + sizeof(count) + sizeof(scene_hash);
+
+            bool valid = magic == HashesMagic &&
+                GetColumn(cursor, end, count, m_ids) && GetColumn(cursor, end, count, m_parents) &&
+                GetColumn(cursor, end, count, m_objectHashes) && GetColumn(cursor, end, count, m_subtreeHashes) &&
+                cursor == end;
+
+            for (uint32_t i = 0; i < count && valid; i++)
+                valid = (m_parents[i] == UINT32_MAX || m_parents[i] < i) && m_ids[i] < MaxObjectId;
+
+            if (!valid)
+            {
+                HT_DEBUG_PRINTF("SceneHasher::Read: Malformed scene hashes!\n");
+                m_ids.clear();
+                m_parents.clear();
+                m_objectHashes.clear();
+                m_subtreeHashes.clear();
+                return false;
+            }
+
+            m_sceneHash = scene_hash;
+            BuildIndex();
+            return true;
+        }
+
+        uint32_t SceneHasher::IndexOf(ObjectId id) const
+        {
+            return (id < m_index.size()) ? m_index[id] : UINT32_MAX;
+        }
+
+        void SceneHasher::BuildIndex(void)
+        {
+            m_index.clear();
+            for (std::size_t i = 0; i < m_ids.size(); i++)
+            {
+                if (m_ids[i] >= m_index.size())
+                    m_index.resize(m_ids[i] + 1, UINT32_MAX);
+                m_index[m_ids[i]] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+}
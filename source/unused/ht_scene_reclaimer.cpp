@@ -0,0 +1,98 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_scene_reclaimer.h>
+#include <ht_scene.h>
+#include <ht_debug.h>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        SceneReclaimer::SceneReclaimer(void)
+            : m_busy(false), m_stopping(false)
+        {
+        }
+
+        SceneReclaimer::~SceneReclaimer(void)
+        {
+            Stop();
+        }
+
+        void SceneReclaimer::Reclaim(Scene* scene)
+        {
+            if (scene == nullptr)
+                return;
+
+            // Anything touching the renderer, audio device or resource caches goes now, on this thread.
+            scene->DestroyMainThreadComponents();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_thread.joinable())
+            {
+                m_stopping = false;
+                m_thread = std::thread(&SceneReclaimer::Run, this);
+            }
+
+            m_queue.push_back(scene);
+            m_wake.notify_one();
+        }
+
+        void SceneReclaimer::Flush(void)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this]() { return m_queue.empty() && !m_busy; });
+        }
+
+        void SceneReclaimer::Stop(void)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_thread.joinable())
+                    return;
+
+                m_stopping = true;
+                m_wake.notify_one();
+            }
+
+            m_thread.join();
+        }
+
+        void SceneReclaimer::Run(void)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_wake.wait(lock, [this]() { return !m_queue.empty() || m_stopping; });
+                if (m_queue.empty())
+                    break;
+
+                Scene* scene = m_queue.front();
+                m_queue.pop_front();
+                m_busy = true;
+
+                lock.unlock();
+                scene->Unload();
+                delete scene;
+                lock.lock();
+
+                m_busy = false;
+                if (m_queue.empty())
+                    m_idle.notify_all();
+            }
+
+            HT_DEBUG_PRINTF("SceneReclaimer stopped.\n");
+        }
+    }
+}
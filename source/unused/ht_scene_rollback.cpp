@@ -0,0 +1,408 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_scene_rollback.h>
+#include <ht_scene_snapshot.h>
+#include <ht_scene.h>
+#include <ht_gameobject.h>
+#include <ht_component_registry.h>
+#include <ht_time_singleton.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+
+            uint64_t Mix(uint64_t hash, uint32_t value)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    hash ^= (value >> (i * 8)) & 0xFF;
+                    hash *= 1099511628211ULL;
+                }
+                return hash;
+            }
+
+            uint64_t Mix(uint64_t hash, const Core::Guid& guid)
+            {
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&guid);
+                for (std::size_t i = 0; i < sizeof(Core::Guid); i++)
+                {
+                    hash ^= bytes[i];
+                    hash *= 1099511628211ULL;
+                }
+                return hash;
+            }
+
+            /**
+            * \brief Initializes everything queued at once while re-simulating, then puts the budget back.
+            *
+            * The budget is wall-clock time, so spending it would make re-simulated frames differ from the originals.
+            */
+            class UnlimitedInitScope
+            {
+            public:
+                explicit UnlimitedInitScope(Scene& scene)
+                    : m_scene(scene),
+                    m_budget(scene.GetInitBudget())
+                {
+                    m_scene.SetInitBudget(0);
+                }
+
+                ~UnlimitedInitScope(void)
+                {
+                    m_scene.SetInitBudget(m_budget);
+                }
+
+            private:
+                Scene&      m_scene;
+                uint32_t    m_budget;
+            };
+
+            /**
+            * \brief Puts the clock back the way it was before a restore or re-simulation overrode it.
+            */
+            class SimulationTimeScope
+            {
+            public:
+                SimulationTimeScope(void)
+                    : m_hadSimulationTime(Time::HasSimulationTime()),
+                    m_totalTime(Time::TotalTime()),
+                    m_deltaTime(Time::DeltaTime())
+                {
+                }
+
+                ~SimulationTimeScope(void)
+                {
+                    if (m_hadSimulationTime)
+                        Time::SetSimulationTime(m_totalTime, m_deltaTime);
+                    else
+                        Time::ClearSimulationTime();
+                }
+
+            private:
+                bool    m_hadSimulationTime;
+                float   m_totalTime;
+                float   m_deltaTime;
+            };
+        }
+
+        SceneRollback::SceneRollback(std::size_t capacity)
+            : m_oldest(0),
+            m_count(0)
+        {
+            SetCapacity(capacity);
+        }
+
+        void SceneRollback::SetCapacity(std::size_t capacity)
+        {
+            m_frames.clear();
+            m_frames.resize(std::max<std::size_t>(capacity, 1));
+            m_oldest = 0;
+            m_count = 0;
+        }
+
+        std::size_t SceneRollback::GetCapacity(void) const
+        {
+            return m_frames.size();
+        }
+
+        std::size_t SceneRollback::Size(void) const
+        {
+            return m_count;
+        }
+
+        bool SceneRollback::Contains(uint32_t frame) const
+        {
+            return IndexOf(frame) != m_count;
+        }
+
+        uint32_t SceneRollback::GetOldestFrame(void) const
+        {
+            return m_frames[m_oldest].frame;
+        }
+
+        uint32_t SceneRollback::GetNewestFrame(void) const
+        {
+            return m_frames[SlotOf(m_count - 1)].frame;
+        }
+
+        void SceneRollback::Clear(void)
+        {
+            m_oldest = 0;
+            m_count = 0;
+        }
+
+        std::size_t SceneRollback::SlotOf(std::size_t i) const
+        {
+            return (m_oldest + i) % m_frames.size();
+        }
+
+        std::size_t SceneRollback::IndexOf(uint32_t frame) const
+        {
+            for (std::size_t i = 0; i < m_count; i++)
+            {
+                if (m_frames[SlotOf(i)].frame == frame)
+                    return i;
+            }
+            return m_count;
+        }
+
+        uint64_t SceneRollback::CollectScene(const Scene& scene)
+        {
+            scene.CollectLiveGameObjects(m_objects, m_parents, m_visited);
+            m_components.clear();
+
+            uint64_t hash = 14695981039346656037ULL;
+            for (std::size_t i = 0; i < m_objects.size(); i++)
+            {
+                // Keyed on Guids, which survive being recreated by a snapshot where ObjectIds do not.
+                GameObject* gameObject = m_objects[i];
+                hash = Mix(hash, gameObject->m_guid);
+                hash = Mix(hash, m_parents[i]);
+
+                std::size_t first = m_components.size();
+                for (Component* component : gameObject->m_components)
+                {
+                    if (component == nullptr)
+                        continue;
+
+                    const ComponentRegistry::Entry* entry = ComponentRegistry::Find(component->VGetComponentTypeId());
+                    if (entry != nullptr && (entry->flags & ComponentRegistry::NO_ROLLBACK))
+                        continue;
+
+                    m_components.push_back(component);
+                }
+
+                // Recreated Components may sit in other slots, so they are listed by type.
+                std::sort(m_components.begin() + first, m_components.end(), [](const Component* lhs, const Component* rhs)
+                {
+                    return lhs->VGetComponentTypeId() < rhs->VGetComponentTypeId();
+                });
+                for (std::size_t c = first; c < m_components.size(); c++)
+                    hash = Mix(hash, m_components[c]->VGetComponentTypeId());
+            }
+
+            return hash;
+        }
+
+        void SceneRollback::Save(const Scene& scene, uint32_t frame)
+        {
+            // Frames at or after this one no longer happened.
+            while (m_count > 0 && m_frames[SlotOf(m_count - 1)].frame >= frame)
+                m_count--;
+
+            if (m_count == m_frames.size())
+            {
+                // Drop the oldest frame, handing its snapshot on if the next frame shares its structure.
+                Frame& oldest = m_frames[m_oldest];
+                if (m_count > 1)
+                {
+                    Frame& next = m_frames[SlotOf(1)];
+                    if (next.snapshot.empty() && next.structure == oldest.structure)
+                        next.snapshot.swap(oldest.snapshot);
+                }
+
+                m_oldest = SlotOf(1);
+                m_count--;
+            }
+
+            uint64_t structure = CollectScene(scene);
+            const Frame* previous = (m_count > 0) ? &m_frames[SlotOf(m_count - 1)] : nullptr;
+
+            Frame& saved = m_frames[SlotOf(m_count)];
+            saved.frame = frame;
+            saved.totalTime = Time::TotalTime();
+            saved.deltaTime = Time::DeltaTime();
+
+            std::size_t object_count = m_objects.size();
+            saved.objects.assign(m_objects.begin(), m_objects.end());
+            saved.enabled.resize(object_count);
+            saved.transforms.resize(object_count * 9);
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                const GameObject* gameObject = m_objects[i];
+                const Transform& transform = gameObject->m_transform;
+                float* values = &saved.transforms[i * 9];
+
+                saved.enabled[i] = gameObject->m_enabled ? 1 : 0;
+                values[0] = transform.X();
+                values[1] = transform.Y();
+                values[2] = transform.Z();
+                values[3] = transform.RotX();
+                values[4] = transform.RotY();
+                values[5] = transform.RotZ();
+                values[6] = transform.ScaleX();
+                values[7] = transform.ScaleY();
+                values[8] = transform.ScaleZ();
+            }
+
+            std::size_t component_count = m_components.size();
+            saved.components.assign(m_components.begin(), m_components.end());
+            saved.componentEnabled.resize(component_count);
+            saved.componentOffsets.resize(component_count + 1);
+            saved.state.clear();
+            for (std::size_t i = 0; i < component_count; i++)
+            {
+                saved.componentOffsets[i] = static_cast<uint32_t>(saved.state.size());
+                saved.componentEnabled[i] = m_components[i]->GetEnabled() ? 1 : 0;
+                m_components[i]->VWriteBinary(saved.state);
+            }
+            saved.componentOffsets[component_count] = static_cast<uint32_t>(saved.state.size());
+
+            // A full snapshot is only needed where the structure of the scene changes.
+            if (previous == nullptr || previous->structure != structure)
+                SceneSnapshot::Capture(scene, saved.snapshot);
+            else
+                saved.snapshot.clear();
+            saved.structure = structure;
+
+            m_count++;
+        }
+
+        bool SceneRollback::Restore(Scene& scene, uint32_t frame)
+        {
+            std::size_t index = IndexOf(frame);
+            if (index == m_count)
+                return false;
+
+            Frame& saved = m_frames[SlotOf(index)];
+
+            // Components that keep absolute times read them back against the clock of the frame.
+            SimulationTimeScope scope;
+            Time::SetSimulationTime(saved.totalTime, saved.deltaTime);
+
+            uint64_t structure = CollectScene(scene);
+            if (structure != saved.structure || m_objects != saved.objects || m_components != saved.components)
+            {
+                // GameObjects or Components came or went since; rebuild the structure from the
+                // newest snapshot of it at or before this frame.
+                const std::vector<uint8_t>* snapshot = nullptr;
+                for (std::size_t i = index + 1; i-- > 0 && snapshot == nullptr; )
+                {
+                    const Frame& candidate = m_frames[SlotOf(i)];
+                    if (candidate.structure != saved.structure)
+                        break;
+                    if (!candidate.snapshot.empty())
+                        snapshot = &candidate.snapshot;
+                }
+
+                if (snapshot == nullptr)
+                {
+                    HT_DEBUG_PRINTF("SceneRollback::Restore: No snapshot to rebuild the structure of frame %u from!\n", frame);
+                    return false;
+                }
+
+                // A snapshot that cannot be restored leaves the scene untouched. Should the result still
+                // differ from the frame, the scene is put back the way it was found.
+                SceneSnapshot::Capture(scene, m_undo);
+                if (!SceneSnapshot::Restore(scene, *snapshot))
+                {
+                    HT_DEBUG_PRINTF("SceneRollback::Restore: Failed to restore the snapshot of frame %u!\n", frame);
+                    return false;
+                }
+
+                if (CollectScene(scene) != saved.structure)
+                {
+                    HT_DEBUG_PRINTF("SceneRollback::Restore: Failed to rebuild the structure of frame %u!\n", frame);
+                    if (!SceneSnapshot::Restore(scene, m_undo))
+                        HT_DEBUG_PRINTF("SceneRollback::Restore: Failed to put the scene back!\n");
+                    return false;
+                }
+
+                // The snapshot may have recreated GameObjects and Components.
+                saved.objects.assign(m_objects.begin(), m_objects.end());
+                saved.components.assign(m_components.begin(), m_components.end());
+            }
+
+            ApplyFrame(saved);
+            return true;
+        }
+
+        void SceneRollback::ApplyFrame(const Frame& frame)
+        {
+            for (std::size_t i = 0; i < m_objects.size(); i++)
+            {
+                GameObject* gameObject = m_objects[i];
+                const float* values = &frame.transforms[i * 9];
+
+                gameObject->m_enabled = frame.enabled[i] != 0;
+                gameObject->m_transform.SetPosition(Math::Vector3(values[0], values[1], values[2]));
+                gameObject->m_transform.SetRotation(Math::Vector3(values[3], values[4], values[5]));
+                gameObject->m_transform.SetScale(Math::Vector3(values[6], values[7], values[8]));
+            }
+
+            const uint8_t* state = frame.state.data();
+            for (std::size_t i = 0; i < m_components.size(); i++)
+            {
+                Component* component = m_components[i];
+
+                const uint8_t* cursor = state + frame.componentOffsets[i];
+                const uint8_t* end = state + frame.componentOffsets[i + 1];
+                if (cursor != end && !component->VReadBinary(cursor, end))
+                    HT_DEBUG_PRINTF("SceneRollback: Failed to restore a Component!\n");
+
+                bool enabled = frame.componentEnabled[i] != 0;
+                if (component->GetEnabled() != enabled)
+                    component->SetEnabled(enabled);
+            }
+        }
+
+        bool SceneRollback::Resimulate(Scene& scene, uint32_t fromFrame, uint32_t toFrame, const std::function<void(uint32_t)>& beforeUpdate)
+        {
+            if (toFrame < fromFrame)
+                return false;
+
+            // Saving the re-simulated frames discards the originals, so take their times first.
+            m_times.clear();
+            for (uint32_t frame = fromFrame; frame < toFrame; frame++)
+            {
+                std::size_t index = IndexOf(frame);
+                if (index == m_count)
+                {
+                    HT_DEBUG_PRINTF("SceneRollback::Resimulate: Frame %u is not saved!\n", frame);
+                    return false;
+                }
+
+                const Frame& saved = m_frames[SlotOf(index)];
+                m_times.push_back(std::make_pair(saved.totalTime, saved.deltaTime));
+            }
+
+            if (!Restore(scene, fromFrame))
+                return false;
+
+            SimulationTimeScope scope;
+            UnlimitedInitScope budget(scene);
+            for (std::size_t i = 0; i < m_times.size(); i++)
+            {
+                uint32_t frame = fromFrame + static_cast<uint32_t>(i);
+                Time::SetSimulationTime(m_times[i].first, m_times[i].second);
+
+                if (frame != fromFrame)
+                    Save(scene, frame);
+
+                if (beforeUpdate)
+                    beforeUpdate(frame);
+
+                scene.Update();
+            }
+
+            return true;
+        }
+    }
+}
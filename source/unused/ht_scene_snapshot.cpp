@@ -0,0 +1,607 @@
+/**
+**    Hatchit Engine
+**    Copyright(c) 2015-2016 Third-Degree
+**
+**    GNU Lesser General Public License
+**    This file may be used under the terms of the GNU Lesser
+**    General Public License version 3 as published by the Free
+**    Software Foundation and appearing in the file LICENSE.LGPLv3 included
+**    in the packaging of this file. Please review the following information
+**    to ensure the GNU Lesser General Public License requirements
+**    will be met: https://www.gnu.org/licenses/lgpl.html
+**
+**/
+
+#include <ht_scene_snapshot.h>
+#include <ht_scene.h>
+#include <ht_gameobject.h>
+#include <ht_component_registry.h>
+#include <ht_debug.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace Hatchit {
+
+    namespace Game {
+
+        namespace {
+
+            const uint32_t SnapshotMagic = 0x4E535448; // "HTSN"
+            const uint32_t SnapshotVersion = 4;
+
+            // Guids are stored as their 16 raw bytes.
+            static_assert(sizeof(Core::Guid) == 16, "Core::Guid is expected to hold exactly its 16 bytes");
+
+            template <typename T>
+            void Put(std::vector<uint8_t>& out, const T& value)
+            {
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                out.insert(out.end(), bytes, bytes + sizeof(T));
+            }
+
+            void PutString(std::vector<uint8_t>& out, const std::string& value)
+            {
+                Put(out, static_cast<uint32_t>(value.size()));
+                out.insert(out.end(), value.begin(), value.end());
+            }
+
+            template <typename T>
+            bool Get(const uint8_t*& cursor, const uint8_t* end, T& value)
+            {
+                if (static_cast<std::size_t>(end - cursor) < sizeof(T))
+                    return false;
+                std::memcpy(&value, cursor, sizeof(T));
+                cursor += sizeof(T);
+                return true;
+            }
+
+            bool GetBytes(const uint8_t*& cursor, const uint8_t* end, uint32_t length, const uint8_t*& bytes)
+            {
+                if (static_cast<std::size_t>(end - cursor) < length)
+                    return false;
+                bytes = cursor;
+                cursor += length;
+                return true;
+            }
+
+            bool GetString(const uint8_t*& cursor, const uint8_t* end, std::string& value)
+            {
+                uint32_t length;
+                const uint8_t* bytes;
+                if (!Get(cursor, end, length) || !GetBytes(cursor, end, length, bytes))
+                    return false;
+                value.assign(reinterpret_cast<const char*>(bytes), length);
+                return true;
+            }
+
+            template <typename T>
+            bool GetColumn(const uint8_t*& cursor, const uint8_t* end, std::size_t count, std::vector<T>& column)
+            {
+                const uint8_t* bytes;
+                if (count > (static_cast<std::size_t>(end - cursor) / sizeof(T)) ||
+                    !GetBytes(cursor, end, static_cast<uint32_t>(count * sizeof(T)), bytes))
+                    return false;
+                column.resize(count);
+                if (count != 0)
+                    std::memcpy(column.data(), bytes, count * sizeof(T));
+                return true;
+            }
+        }
+
+        void SceneState::Clear(void)
+        {
+            typeNames.clear();
+            layoutHashes.clear();
+            ids.clear();
+            guids.clear();
+            prefabs.clear();
+            names.clear();
+            parents.clear();
+            flags.clear();
+            transforms.clear();
+            componentCounts.clear();
+            componentTypes.clear();
+            componentEnabled.clear();
+            componentOffsets.clear();
+            componentData.clear();
+        }
+
+        std::size_t SceneState::ObjectCount(void) const
+        {
+            return ids.size();
+        }
+
+        std::size_t SceneState::ComponentCount(void) const
+        {
+            return componentTypes.size();
+        }
+
+        bool SceneState::IsValid(void) const
+        {
+            std::size_t object_count = ids.size();
+            if (layoutHashes.size() != typeNames.size() || guids.size() != object_count || prefabs.size() != object_count || names.size() != object_count ||
+                parents.size() != object_count || flags.size() != object_count || transforms.size() != object_count * 9 ||
+                componentCounts.size() != object_count)
+                return false;
+
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                // Parents always precede their children.
+                if (parents[i] != UINT32_MAX && parents[i] >= i)
+                    return false;
+            }
+
+            std::size_t component_count = 0;
+            for (uint32_t count : componentCounts)
+                component_count += count;
+
+            if (componentTypes.size() != component_count || componentEnabled.size() != component_count)
+                return false;
+
+            // A state that never held a Component may have no end offset either.
+            if (componentOffsets.empty())
+                return component_count == 0 && componentData.empty();
+
+            if (componentOffsets.size() != component_count + 1 || componentOffsets.front() != 0 ||
+                componentOffsets.back() != componentData.size())
+                return false;
+
+            for (std::size_t i = 0; i < component_count; i++)
+            {
+                if (componentTypes[i] >= typeNames.size() || componentOffsets[i] > componentOffsets[i + 1])
+                    return false;
+            }
+
+            return true;
+        }
+
+        void SceneSnapshot::Capture(const Scene& scene, std::vector<uint8_t>& out)
+        {
+            SceneState state;
+            Capture(scene, state);
+            Write(state, out);
+        }
+
+        void SceneSnapshot::Capture(const Scene& scene, SceneState& state)
+        {
+            state.Clear();
+
+            // Gather live GameObjects so that every parent precedes its children.
+            std::vector<GameObject*> objects;
+            std::vector<bool> visited;
+            scene.CollectLiveGameObjects(objects, state.parents, visited);
+
+            std::size_t object_count = objects.size();
+            state.ids.reserve(object_count);
+            state.guids.reserve(object_count);
+            state.prefabs.reserve(object_count);
+            state.names.reserve(object_count);
+            state.flags.reserve(object_count);
+            state.transforms.reserve(object_count * 9);
+            state.componentCounts.reserve(object_count);
+
+            std::vector<uint32_t> type_index;
+            for (const GameObject* gameObject : objects)
+            {
+                state.ids.push_back(gameObject->m_id);
+                state.guids.push_back(gameObject->m_guid);
+                const GameObject* prefab = scene.FindGameObject(gameObject->m_prefab);
+                state.prefabs.push_back((prefab != nullptr) ? prefab->m_guid : gameObject->m_guid);
+                state.names.push_back(gameObject->GetName());
+                state.flags.push_back(static_cast<uint8_t>((gameObject->m_enabled ? SceneState::ENABLED : 0) |
+                                                           (gameObject->m_initialized ? SceneState::INITIALIZED : 0)));
+
+                const Transform& transform = gameObject->m_transform;
+                const float values[9] = {
+                    transform.X(), transform.Y(), transform.Z(),
+                    transform.RotX(), transform.RotY(), transform.RotZ(),
+                    transform.ScaleX(), transform.ScaleY(), transform.ScaleZ()
+                };
+                state.transforms.insert(state.transforms.end(), values, values + 9);
+
+                uint32_t count = 0;
+                for (Component* component : gameObject->m_components)
+                {
+                    if (component == nullptr)
+                        continue;
+
+                    ComponentTypeId type_id = component->VGetComponentTypeId();
+                    if (type_id >= type_index.size())
+                        type_index.resize(type_id + 1, UINT32_MAX);
+
+                    if (type_index[type_id] == UINT32_MAX)
+                    {
+                        const ComponentRegistry::Entry* entry = ComponentRegistry::Find(type_id);
+                        if (entry == nullptr)
+                            continue;
+
+                        type_index[type_id] = static_cast<uint32_t>(state.typeNames.size());
+                        state.typeNames.emplace_back(entry->name, entry->nameLength);
+                        state.layoutHashes.push_back((entry->reflection != nullptr) ? entry->reflection->GetLayoutHash() : 0);
+                    }
+
+                    state.componentTypes.push_back(type_index[type_id]);
+                    state.componentEnabled.push_back(component->GetEnabled() ? 1 : 0);
+                    state.componentOffsets.push_back(static_cast<uint32_t>(state.componentData.size()));
+                    component->VWriteBinary(state.componentData);
+                    count++;
+                }
+                state.componentCounts.push_back(count);
+            }
+            state.componentOffsets.push_back(static_cast<uint32_t>(state.componentData.size()));
+        }
+
+        void SceneSnapshot::Write(const SceneState& state, std::vector<uint8_t>& out)
+        {
+            out.clear();
+
+            // Header and type table.
+            Put(out, SnapshotMagic);
+            Put(out, SnapshotVersion);
+            Put(out, static_cast<uint32_t>(state.ObjectCount()));
+            Put(out, static_cast<uint32_t>(state.ComponentCount()));
+            Put(out, static_cast<uint32_t>(state.typeNames.size()));
+            for (std::size_t i = 0; i < state.typeNames.size(); i++)
+            {
+                PutString(out, state.typeNames[i]);
+                Put(out, state.layoutHashes[i]);
+            }
+
+            // One column per property.
+            for (ObjectId id : state.ids)
+                Put(out, id);
+
+            for (const Core::Guid& guid : state.guids)
+                Put(out, guid);
+
+            for (const Core::Guid& prefab : state.prefabs)
+                Put(out, prefab);
+
+            for (const std::string& name : state.names)
+                PutString(out, name);
+
+            for (uint32_t parent : state.parents)
+                Put(out, parent);
+
+            out.insert(out.end(), state.flags.begin(), state.flags.end());
+
+            for (float value : state.transforms)
+                Put(out, value);
+
+            for (uint32_t count : state.componentCounts)
+                Put(out, count);
+
+            for (std::size_t i = 0; i < state.ComponentCount(); i++)
+            {
+                uint32_t begin = state.componentOffsets[i];
+                uint32_t end = state.componentOffsets[i + 1];
+
+                Put(out, state.componentTypes[i]);
+                Put(out, state.componentEnabled[i]);
+                Put(out, end - begin);
+                out.insert(out.end(), state.componentData.begin() + begin, state.componentData.begin() + end);
+            }
+        }
+
+        bool SceneSnapshot::Read(const uint8_t* data, std::size_t size, SceneState& state)
+        {
+            const uint8_t* cursor = data;
+            const uint8_t* end = data + size;
+
+            state.Clear();
+
+            uint32_t magic, version, object_count, component_count, type_count;
+            if (!Get(cursor, end, magic) || magic != SnapshotMagic || !Get(cursor, end, version) || version != SnapshotVersion)
+            {
+                HT_DEBUG_PRINTF("SceneSnapshot::Read: Not a scene snapshot, or one from another version!\n");
+                return false;
+            }
+
+            if (!Get(cursor, end, object_count) || !Get(cursor, end, component_count) || !Get(cursor, end, type_count))
+                return false;
+
+            // Every record takes at least a byte, so larger counts cannot be genuine.
+            if (object_count > size || component_count > size || type_count > size)
+                return false;
+
+            state.typeNames.resize(type_count);
+            state.layoutHashes.resize(type_count);
+            for (uint32_t i = 0; i < type_count; i++)
+            {
+                if (!GetString(cursor, end, state.typeNames[i]) || !Get(cursor, end, state.layoutHashes[i]))
+                    return false;
+            }
+
+            if (!GetColumn(cursor, end, object_count, state.ids))
+                return false;
+
+            if (!GetColumn(cursor, end, object_count, state.guids) ||
+                !GetColumn(cursor, end, object_count, state.prefabs))
+                return false;
+
+            state.names.resize(object_count);
+            for (std::string& name : state.names)
+            {
+                if (!GetString(cursor, end, name))
+                    return false;
+            }
+
+            if (!GetColumn(cursor, end, object_count, state.parents) ||
+                !GetColumn(cursor, end, object_count, state.flags) ||
+                !GetColumn(cursor, end, std::size_t(object_count) * 9, state.transforms) ||
+                !GetColumn(cursor, end, object_count, state.componentCounts))
+                return false;
+
+            state.componentTypes.resize(component_count);
+            state.componentEnabled.resize(component_count);
+            state.componentOffsets.resize(component_count + 1);
+            for (uint32_t i = 0; i < component_count; i++)
+            {
+                uint32_t length;
+                const uint8_t* bytes;
+                if (!Get(cursor, end, state.componentTypes[i]) || !Get(cursor, end, state.componentEnabled[i]) ||
+                    !Get(cursor, end, length) || !GetBytes(cursor, end, length, bytes))
+                    return false;
+
+                state.componentOffsets[i] = static_cast<uint32_t>(state.componentData.size());
+                state.componentData.insert(state.componentData.end(), bytes, bytes + length);
+            }
+            state.componentOffsets[component_count] = static_cast<uint32_t>(state.componentData.size());
+
+            return state.IsValid();
+        }
+
+        bool SceneSnapshot::Restore(Scene& scene, const std::vector<uint8_t>& data)
+        {
+            return Restore(scene, data.data(), data.size());
+        }
+
+        bool SceneSnapshot::Restore(Scene& scene, const uint8_t* data, std::size_t size)
+        {
+            SceneState state;
+            if (!Read(data, size, state))
+            {
+                HT_DEBUG_PRINTF("SceneSnapshot::Restore: Malformed snapshot!\n");
+                return false;
+            }
+
+            return Restore(scene, state);
+        }
+
+        bool SceneSnapshot::Restore(Scene& scene, const SceneState& state)
+        {
+            // Validate the whole state before touching the scene.
+            if (!state.IsValid())
+            {
+                HT_DEBUG_PRINTF("SceneSnapshot::Restore: Malformed scene state!\n");
+                return false;
+            }
+
+            std::vector<const ComponentRegistry::Entry*> types(state.typeNames.size());
+            for (std::size_t i = 0; i < types.size(); i++)
+            {
+                types[i] = ComponentRegistry::Find(state.typeNames[i]);
+                if (types[i] == nullptr)
+                {
+                    HT_DEBUG_PRINTF("SceneSnapshot::Restore: Unknown Component type %s!\n", state.typeNames[i].c_str());
+                    return false;
+                }
+
+                uint64_t current_hash = (types[i]->reflection != nullptr) ? types[i]->reflection->GetLayoutHash() : 0;
+                if (current_hash != state.layoutHashes[i])
+                {
+                    HT_DEBUG_PRINTF("SceneSnapshot::Restore: The layout of Component type %s has changed!\n", types[i]->name);
+                    return false;
+                }
+            }
+
+            std::size_t object_count = state.ObjectCount();
+            std::vector<uint32_t> first_component(object_count);
+            uint32_t component_total = 0;
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                first_component[i] = component_total;
+                component_total += state.componentCounts[i];
+            }
+
+            // Components without binary state are rebuilt from the prefab or description of their GameObject.
+            // Make sure every one missing from the scene can be, before anything is changed.
+            std::vector<const GameObject*> prefabs(object_count, nullptr);
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                const GameObject* prefab = (state.prefabs[i] == state.guids[i]) ? nullptr : scene.FindGameObject(state.prefabs[i]);
+                if (prefab != nullptr && std::find(scene.m_prefabs.begin(), scene.m_prefabs.end(), prefab) != scene.m_prefabs.end())
+                    prefabs[i] = prefab;
+
+                const GameObject* live = scene.FindGameObject(state.guids[i]);
+                if (live != nullptr && live->m_destroyed)
+                    live = nullptr;
+
+                for (uint32_t c = first_component[i]; c < first_component[i] + state.componentCounts[i]; c++)
+                {
+                    const ComponentRegistry::Entry* entry = types[state.componentTypes[c]];
+                    if (entry->reflection != nullptr || (live != nullptr && live->m_componentMap.count(entry->typeId) != 0))
+                        continue;
+
+                    if (!scene.CanRebuildComponent(prefabs[i], state.guids[i], state.typeNames[state.componentTypes[c]]))
+                    {
+                        HT_DEBUG_PRINTF("SceneSnapshot::Restore: Cannot recreate Component %s of %s!\n", entry->name, state.guids[i].ToString().c_str());
+                        return false;
+                    }
+                }
+            }
+
+            // Find or create every captured GameObject.
+            std::vector<GameObject*> objects(object_count, nullptr);
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                const std::string& name_string = state.names[i];
+                NameId name = name_string.empty() ? InvalidNameId : scene.m_names.Intern(name_string);
+
+                GameObject* gameObject = scene.FindGameObject(state.guids[i]);
+                if (gameObject == nullptr || gameObject->m_destroyed)
+                {
+                    gameObject = scene.m_arena.New<GameObject>(&scene, state.guids[i], name, Transform{}, true);
+                    gameObject->m_prefab = (prefabs[i] != nullptr) ? prefabs[i]->m_id : InvalidObjectId;
+                    scene.RegisterGameObject(gameObject);
+                }
+                else if (gameObject->m_name != name)
+                {
+                    scene.RemoveFromNameIndex(gameObject);
+                    gameObject->m_name = name;
+                    if (name != InvalidNameId)
+                        scene.m_nameIndex.insert(std::make_pair(name, gameObject));
+                }
+
+                objects[i] = gameObject;
+            }
+
+            std::vector<bool> kept(scene.m_objectsById.size(), false);
+            for (GameObject* gameObject : objects)
+                kept[gameObject->m_id] = true;
+            for (GameObject* prefab : scene.m_prefabs)
+                kept[prefab->m_id] = true;
+
+            // Detach every captured GameObject from the hierarchy, so destroying what is left
+            // cannot take a captured one with it.
+            for (GameObject* gameObject : objects)
+            {
+                if (gameObject->m_parent != nullptr)
+                    gameObject->m_parent->RemoveChild(gameObject);
+            }
+
+            std::vector<GameObject*> roots;
+            roots.reserve(scene.m_gameObjects.size());
+            for (GameObject* gameObject : scene.m_gameObjects)
+            {
+                if (!kept[gameObject->m_id])
+                    roots.push_back(gameObject);
+            }
+            while (!scene.m_initQueue.empty())
+            {
+                GameObject* gameObject = scene.m_initQueue.top().gameObject;
+                scene.m_initQueue.pop();
+                if (!kept[gameObject->m_id])
+                    roots.push_back(gameObject);
+            }
+            scene.m_gameObjects.swap(roots);
+
+            // Destroy live GameObjects absent from the snapshot; the next Update() deletes them.
+            for (ObjectId id = 0; id < scene.m_objectsById.size(); id++)
+            {
+                GameObject* gameObject = scene.m_objectsById[id];
+                if (gameObject != nullptr && !kept[id] && !gameObject->m_destroyed)
+                    gameObject->MarkForDestroy();
+            }
+
+            // Rebuild the hierarchy in captured order.
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                GameObject* gameObject = objects[i];
+                uint32_t parent = state.parents[i];
+                uint8_t flags = state.flags[i];
+
+                if (parent != UINT32_MAX)
+                    objects[parent]->AddChild(gameObject);
+                else if ((flags & SceneState::INITIALIZED) || gameObject->m_initialized)
+                    scene.m_gameObjects.push_back(gameObject);
+                else
+                    scene.QueueInit(gameObject);
+
+                gameObject->m_enabled = (flags & SceneState::ENABLED) != 0;
+
+                const float* t = &state.transforms[i * 9];
+                gameObject->m_transform.SetPosition(Math::Vector3(t[0], t[1], t[2]));
+                gameObject->m_transform.SetRotation(Math::Vector3(t[3], t[4], t[5]));
+                gameObject->m_transform.SetScale(Math::Vector3(t[6], t[7], t[8]));
+            }
+
+            // Match the set of Components on each GameObject to the snapshot.
+            std::vector<ComponentTypeId> stale;
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                GameObject* gameObject = objects[i];
+                const uint32_t* first = state.componentTypes.data() + first_component[i];
+                const uint32_t* last = first + state.componentCounts[i];
+
+                stale.clear();
+                for (const Component* component : gameObject->m_components)
+                {
+                    if (component == nullptr)
+                        continue;
+
+                    ComponentTypeId type_id = component->VGetComponentTypeId();
+                    bool captured = false;
+                    for (const uint32_t* iter = first; iter != last && !captured; ++iter)
+                        captured = types[*iter]->typeId == type_id;
+
+                    if (!captured)
+                        stale.push_back(type_id);
+                }
+                for (ComponentTypeId type_id : stale)
+                    gameObject->RemoveComponent(type_id);
+
+                for (const uint32_t* iter = first; iter != last; ++iter)
+                {
+                    const ComponentRegistry::Entry* entry = types[*iter];
+                    if (gameObject->m_componentMap.find(entry->typeId) != gameObject->m_componentMap.cend())
+                        continue;
+
+                    Component* component = (entry->reflection != nullptr) ? scene.NewComponent(entry->name, entry->nameLength)
+                        : scene.RebuildComponent(prefabs[i], state.guids[i], state.typeNames[*iter]);
+                    if (component == nullptr)
+                    {
+                        HT_DEBUG_PRINTF("SceneSnapshot::Restore: Failed to recreate Component %s!\n", entry->name);
+                        continue;
+                    }
+
+                    gameObject->AddUninitializedComponent(component);
+                    if (gameObject->m_initialized)
+                        component->VOnInit();
+                }
+
+                // Initialize GameObjects that were initialized when captured. Children are initialized
+                // one by one as they are reached, so no live Component is initialized twice.
+                if ((state.flags[i] & SceneState::INITIALIZED) && !gameObject->m_initialized)
+                {
+                    gameObject->m_initialized = true;
+                    for (Component* component : gameObject->m_components)
+                    {
+                        if (component != nullptr)
+                            component->VOnInit();
+                    }
+                }
+            }
+
+            // Finally restore the state of every Component, after any initialization that would reset it.
+            for (std::size_t i = 0; i < object_count; i++)
+            {
+                GameObject* gameObject = objects[i];
+
+                for (uint32_t c = first_component[i]; c < first_component[i] + state.componentCounts[i]; c++)
+                {
+                    const ComponentRegistry::Entry* entry = types[state.componentTypes[c]];
+
+                    GameObject::ComponentMap::const_iterator iter = gameObject->m_componentMap.find(entry->typeId);
+                    if (iter == gameObject->m_componentMap.cend())
+                        continue;
+
+                    Component* component = gameObject->m_components[iter->second];
+                    if (entry->reflection != nullptr)
+                    {
+                        const uint8_t* blob = state.componentData.data() + state.componentOffsets[c];
+                        if (!component->VReadBinary(blob, state.componentData.data() + state.componentOffsets[c + 1]))
+                            HT_DEBUG_PRINTF("SceneSnapshot::Restore: Failed to restore Component %s!\n", entry->name);
+                    }
+
+                    bool enabled = state.componentEnabled[c] != 0;
+                    if (component->GetEnabled() != enabled)
+                        component->SetEnabled(enabled);
+                }
+            }
+
+            return true;
+        }
+    }
+}
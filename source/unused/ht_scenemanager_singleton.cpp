@@ -16,6 +16,8 @@
 #include <ht_path_singleton.h>
 #include <ht_debug.h>
 
+#include <fstream>
+
 namespace Hatchit {
 
     namespace Game {
@@ -33,9 +35,19 @@ namespace Hatchit {
 
             if (_instance.m_currentScene)
             {
-                _instance.m_currentScene->Unload();
-                delete _instance.m_currentScene;
+                Scene::instance = nullptr;
+                _instance.m_reclaimer.Reclaim(_instance.m_currentScene);
+                _instance.m_currentScene = nullptr;
             }
+
+            _instance.m_reclaimer.Stop();
+
+            for (auto& prefetch : _instance.m_prefetches)
+                prefetch.second.wait();
+            _instance.m_prefetches.clear();
+            _instance.m_sceneHandles.clear();
+            _instance.m_watcher.Clear();
+            _instance.m_liveDescription = JSON();
         }
 
         /**
@@ -53,24 +65,72 @@ namespace Hatchit {
                 return false;
             }
 
-            // Iterate through every JSON scene file listed.
+            // Register every JSON scene file listed. Each is only loaded once it is needed.
             const JSON& sceneDescription = sceneListHandle->GetSceneDescription();
             for (const std::string& sceneFile : sceneDescription)
             {
-                // Validate that we were able to acquire a handle to the JSON scene file.
-                SceneHandle sceneHandle = Resource::Scene::GetHandleFromFileName(sceneFile);
-                if (!sceneHandle.IsValid())
-                {
-                    HT_DEBUG_PRINTF("Failed to acquire handle to scene located in %s!\n", sceneFile);
-                    continue;
-                }
+                _instance.m_sceneHandles.insert(std::make_pair(sceneFile, SceneHandle()));
+            }
 
-                _instance.m_sceneHandles.insert(std::make_pair(sceneFile, sceneHandle));
+            return true;
+        }
+
+        bool SceneManager::PrefetchScene(const std::string& sceneName)
+        {
+            SceneManager& _instance = SceneManager::instance();
+
+            auto sceneIterator = _instance.m_sceneHandles.find(sceneName);
+            if (sceneIterator == _instance.m_sceneHandles.cend())
+            {
+                HT_DEBUG_PRINTF("Failed to locate requested Scene: %s!\n", sceneName);
+                return false;
             }
 
+            // Already loaded or on its way.
+            if (sceneIterator->second.IsValid() || _instance.m_prefetches.count(sceneName) != 0)
+                return true;
+
+            // Only the file is read in the background. The resource cache is not safe to use from
+            // another thread, so ResolveScene() creates the handle once the file is cached.
+            std::string path = Path::Value(Path::Directory::Scenes) + sceneName;
+            _instance.m_prefetches.insert(std::make_pair(sceneName, std::async(std::launch::async, [path]()
+            {
+                std::ifstream file(path, std::ios::binary);
+                char buffer[64 * 1024];
+                while (file.read(buffer, sizeof(buffer)))
+                    ;
+            })));
+
             return true;
         }
 
+        SceneHandle SceneManager::ResolveScene(const std::string& sceneName)
+        {
+            SceneManager& _instance = SceneManager::instance();
+
+            auto sceneIterator = _instance.m_sceneHandles.find(sceneName);
+            if (sceneIterator == _instance.m_sceneHandles.end())
+                return SceneHandle();
+
+            if (sceneIterator->second.IsValid())
+                return sceneIterator->second;
+
+            // Let a prefetch finish reading the file first, so the description loads from the file cache.
+            auto prefetchIterator = _instance.m_prefetches.find(sceneName);
+            if (prefetchIterator != _instance.m_prefetches.end())
+            {
+                prefetchIterator->second.wait();
+                _instance.m_prefetches.erase(prefetchIterator);
+            }
+
+            sceneIterator->second = Resource::Scene::GetHandleFromFileName(sceneName);
+
+            if (!sceneIterator->second.IsValid())
+                HT_DEBUG_PRINTF("Failed to acquire handle to scene located in %s!\n", sceneName);
+
+            return sceneIterator->second;
+        }
+
         /**
          * \brief Loads the given scene.
          *
@@ -81,23 +141,23 @@ namespace Hatchit {
         {
             SceneManager& _instance = SceneManager::instance();
 
-            // Unload the current scene
+            // Detach the current scene; it is destroyed in the background while the next one loads.
             if (_instance.m_currentScene)
             {
-                _instance.m_currentScene->Unload();
-                delete _instance.m_currentScene;
+                Scene::instance = nullptr;
+                _instance.m_reclaimer.Reclaim(_instance.m_currentScene);
+                _instance.m_currentScene = nullptr;
             }
 
             // Locate the handle to the next scene.
-            auto sceneIterator = _instance.m_sceneHandles.find(sceneName);
-            if (sceneIterator == _instance.m_sceneHandles.cend())
+            if (_instance.m_sceneHandles.find(sceneName) == _instance.m_sceneHandles.cend())
             {
                 HT_DEBUG_PRINTF("Failed to locate requested Scene: %s!\n", sceneName);
                 return false;
             }
 
-            // Validate the handle to the next Scene.
-            SceneHandle sceneHandle = sceneIterator->second;
+            // Resolve and validate the handle to the next Scene.
+            SceneHandle sceneHandle = ResolveScene(sceneName);
             if (!sceneHandle.IsValid())
             {
                 HT_DEBUG_PRINTF("Invalid Scene handle: %s!\n", sceneName);
@@ -106,6 +166,7 @@ namespace Hatchit {
 
             // Load the Scene from the provided SceneHandle.
             _instance.m_currentScene = new Scene();
+            Scene::instance = _instance.m_currentScene;
             if (!_instance.m_currentScene->LoadFromHandle(sceneHandle))
             {
                 HT_DEBUG_PRINTF("Failed to load Scene from handle: %s!\n", sceneName);
@@ -114,7 +175,11 @@ namespace Hatchit {
 
             // Initialize the Scene.
             _instance.m_currentScene->Init();
-            
+            _instance.m_currentSceneName = sceneName;
+
+            if (_instance.m_hotReload)
+                WatchCurrentScene();
+
             return true;
         }
         
@@ -127,10 +192,69 @@ namespace Hatchit {
 
             if (_instance.m_currentScene)
             {
+                if (_instance.m_hotReload && _instance.m_watcher.Poll())
+                    HotReload();
+
                 _instance.m_currentScene->Update();
                 _instance.m_currentScene->Render();
             }
         }
 
+        void SceneManager::EnableHotReload(bool enabled)
+        {
+            SceneManager& _instance = SceneManager::instance();
+
+            _instance.m_hotReload = enabled;
+            if (enabled && _instance.m_currentScene)
+            {
+                WatchCurrentScene();
+            }
+            else
+            {
+                _instance.m_watcher.Clear();
+                _instance.m_liveDescription = Core::JSON();
+            }
+        }
+
+        void SceneManager::WatchCurrentScene()
+        {
+            SceneManager& _instance = SceneManager::instance();
+
+            SceneHandle sceneHandle = ResolveScene(_instance.m_currentSceneName);
+            if (!sceneHandle.IsValid())
+                return;
+
+            _instance.m_liveDescription = sceneHandle->GetSceneDescription();
+            _instance.m_watcher.Watch(Path::Value(Path::Directory::Scenes) + _instance.m_currentSceneName);
+        }
+
+        void SceneManager::HotReload()
+        {
+            SceneManager& _instance = SceneManager::instance();
+
+            // Editors may still be writing the file; a description that does not parse is read again at the next poll.
+            JSON nextDescription;
+            try
+            {
+                std::ifstream file(_instance.m_watcher.GetPath());
+                file >> nextDescription;
+            }
+            catch (const std::exception& e)
+            {
+                HT_DEBUG_PRINTF("Failed to parse edited scene %s: %s\n", _instance.m_currentSceneName.c_str(), e.what());
+                return;
+            }
+
+            if (!_instance.m_currentScene->Patch(_instance.m_liveDescription, nextDescription))
+            {
+                HT_DEBUG_PRINTF("Failed to patch scene %s!\n", _instance.m_currentSceneName.c_str());
+                return;
+            }
+
+            _instance.m_liveDescription = std::move(nextDescription);
+            _instance.m_watcher.Acknowledge();
+            HT_DEBUG_PRINTF("Hot reloaded scene %s.\n", _instance.m_currentSceneName.c_str());
+        }
+
     }
 }
@@ -13,11 +13,14 @@
 **/
 
 #include <ht_test_component.h>
+#include <ht_component_registry.h>
 #include <ht_debug.h>
 #include <ht_scene.h>
 
 namespace Hatchit {
     namespace Game {
+        HT_REGISTER_COMPONENT_WITH_FLAGS(TestComponent, ComponentRegistry::TRIVIAL_TEARDOWN);
+
         Core::JSON TestComponent::VSerialize(void)
         {
             return nlohmann::json::object_t();
@@ -52,6 +55,15 @@ namespace Hatchit {
             return Component::GetComponentId<TestComponent>();
         }
 
+        /**
+        * \brief Retrieves the dense runtime id associated with this class of Component.
+        * \return The ComponentTypeId associated with this Component type.
+        */
+        ComponentTypeId TestComponent::VGetComponentTypeId(void) const
+        {
+            return Component::GetComponentTypeId<TestComponent>();
+        }
+
         void TestComponent::VOnEnabled()
         {
             HT_DEBUG_PRINTF("Enabled Test Component.\n");
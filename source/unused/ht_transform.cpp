@@ -285,7 +285,7 @@ namespace Hatchit {
                 else
                     m_world = *GetLocalMatrix();
 
-                m_worldPosition = m_world * Math::Vector4(0, 0, 0, 0);
+                m_worldPosition = m_world * Math::Vector4(0, 0, 0, 1);
 
                 //recalculate basis vectors (right, forward, up)
                 m_forward = m_world * Math::Vector4(0, 0, 1, 0);
@@ -13,13 +13,30 @@
  **/
 
 #include <ht_tween_component.h>
+#include <ht_component_registry.h>
 #include <ht_time_singleton.h>
 #include <ht_debug.h>
 
+#include <cstring>
+
 namespace Hatchit {
 
     namespace Game {
 
+        HT_REGISTER_COMPONENT_WITH_FLAGS(TweenComponent, ComponentRegistry::TRIVIAL_TEARDOWN);
+
+        // m_tweenFunction is derived from m_tweenMethod, so it is not reflected; see VOnFieldsLoaded.
+        HT_REFLECT_BEGIN(TweenComponent)
+            HT_REFLECT_FIELD("Target", m_targetValue)
+            HT_REFLECT_FIELD("Start", m_startValue)
+            HT_REFLECT_FIELD("End", m_endValue)
+            HT_REFLECT_FIELD("Method", m_tweenMethod)
+            HT_REFLECT_FIELD("PlayMode", m_tweenPlayMode)
+            HT_REFLECT_FIELD("StartTime", m_startTime)
+            HT_REFLECT_FIELD("Duration", m_duration)
+            HT_REFLECT_FIELD("Playing", m_isPlaying)
+        HT_REFLECT_END()
+
         /**
          * \brief Creates a new tween component.
          */
@@ -50,14 +67,63 @@ namespace Hatchit {
         }
 
         Core::JSON TweenComponent::VSerialize(void)
-         {
-             return Core::JSON();
-         }
+        {
+            return Reflect().ToJson(this);
+        }
+
+        bool TweenComponent::VDeserialize(const Core::JSON& jsonObject)
+        {
+            if (!Reflect().FromJson(jsonObject, this))
+                return false;
 
-         bool TweenComponent::VDeserialize(const Core::JSON& jsonObject)
-         {
-             return false;
-         }
+            VOnFieldsLoaded();
+            return true;
+        }
+
+        const TypeDescriptor* TweenComponent::VGetTypeDescriptor(void) const
+        {
+            return &Reflect();
+        }
+
+        void TweenComponent::VWriteBinary(std::vector<uint8_t>& out) const
+        {
+            Component::VWriteBinary(out);
+
+            // m_startTime is absolute, so also record the time it is relative to.
+            float capturedAt = Time::TotalTime();
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&capturedAt);
+            out.insert(out.end(), bytes, bytes + sizeof(capturedAt));
+        }
+
+        bool TweenComponent::VReadBinary(const uint8_t*& cursor, const uint8_t* end)
+        {
+            if (!Component::VReadBinary(cursor, end))
+                return false;
+
+            float capturedAt;
+            if (static_cast<std::size_t>(end - cursor) < sizeof(capturedAt))
+                return false;
+            std::memcpy(&capturedAt, cursor, sizeof(capturedAt));
+            cursor += sizeof(capturedAt);
+
+            // Read back at the same time it was written (as when rolling back), m_startTime is
+            // kept bit for bit; otherwise the tween is shifted to resume as far into it as it was.
+            float now = Time::TotalTime();
+            if (now != capturedAt)
+                m_startTime = now - (capturedAt - m_startTime);
+            return true;
+        }
+
+        /**
+         * \brief Looks the tween function back up after the tween method was loaded.
+         */
+        void TweenComponent::VOnFieldsLoaded()
+        {
+            if (m_tweenMethod >= TweenMethod::TweenMethodCount)
+                m_tweenMethod = TweenMethod::Linear;
+
+            SetMethod(m_tweenMethod);
+        }
 
         /**
          * \brief Checks to see if the start and end values are compatible.
@@ -385,6 +451,15 @@ namespace Hatchit {
         {
             return Component::GetComponentId<TweenComponent>();
         }
+
+        /**
+        * \brief Retrieves the dense runtime id associated with this class of Component.
+        * \return The ComponentTypeId associated with this Component type.
+        */
+        ComponentTypeId TweenComponent::VGetComponentTypeId(void) const
+        {
+            return Component::GetComponentTypeId<TweenComponent>();
+        }
     }
 
 }
@@ -13,12 +13,15 @@
  **/
 
 #include <ht_tween_position.h>
+#include <ht_component_registry.h>
 #include <ht_gameobject.h>
 
 namespace Hatchit {
 
     namespace Game {
 
+        HT_REGISTER_COMPONENT_WITH_FLAGS(TweenPosition, ComponentRegistry::TRIVIAL_TEARDOWN);
+
         /**
          * \brief Creates a new tween position component.
          */
@@ -39,12 +42,12 @@ namespace Hatchit {
 
         Core::JSON TweenPosition::VSerialize(void)
         {
-            return Core::JSON();
+            return TweenComponent::VSerialize();
         }
 
         bool TweenPosition::VDeserialize(const Core::JSON& jsonObject)
         {
-            return false;
+            return TweenComponent::VDeserialize(jsonObject);
         }
 
         /**
@@ -114,6 +117,15 @@ namespace Hatchit {
         {
             return Component::GetComponentId<TweenPosition>();
         }
+
+        /**
+        * \brief Retrieves the dense runtime id associated with this class of Component.
+        * \return The ComponentTypeId associated with this Component type.
+        */
+        ComponentTypeId TweenPosition::VGetComponentTypeId(void) const
+        {
+            return Component::GetComponentTypeId<TweenPosition>();
+        }
     }
 
 }
@@ -18,6 +18,11 @@ namespace Hatchit {
 
     namespace Game {
 
+        HT_REFLECT_BEGIN(TweenValue)
+            HT_REFLECT_FIELD("Values", m_values)
+            HT_REFLECT_FIELD("Type", m_valueType)
+        HT_REFLECT_END()
+
         /**
          * \brief Creates a new tween value.
          *